@@ -62,6 +62,7 @@
 #include "profiling/Profiling.h"
 #include "ride/TrackData.h"
 #include "ride/TrackDesignRepository.h"
+#include "ride/TrackDesignResultSink.h"
 #include "scenario/Scenario.h"
 #include "scenario/ScenarioRepository.h"
 #include "scripting/HookEngine.h"
@@ -183,6 +184,7 @@ namespace OpenRCT2
 #ifndef DISABLE_NETWORK
             _network.Close();
 #endif
+            TrackDesignResultSink::Shutdown();
             window_close_all();
 
             // Unload objects after closing all windows, this is to overcome windows like
@@ -1,11 +1,11 @@
 #define ZMQ_BUILD_DRAFT_API
 #include <zmq.hpp>
 
+#include "ride/TrackDesignEvaluationProtocol.h"
+#include "ride/TrackDesignEvaluator.h"
 #include "ride/TrackDesignRepository.h"
-#include "actions/ClearAction.h"
-#include "actions/TrackDesignAction.h"
+#include "ride/TrackDesignResultSink.h"
 #include "actions/RideSetStatusAction.h"
-#include "actions/RideDemolishAction.h"
 
 #include "json/json.h"
 
@@ -24,6 +24,7 @@
 #include "Editor.h"
 #include "Game.h"
 #include "GameState.h"
+#include "GameStateCheckpoint.h"
 #include "GameStateSnapshots.h"
 #include "Input.h"
 #include "OpenRCT2.h"
@@ -40,6 +41,7 @@
 #include "network/network.h"
 #include "platform/Platform.h"
 #include "profiling/Profiling.h"
+#include "ride/RideRatings.h"
 #include "ride/Vehicle.h"
 #include "scenario/Scenario.h"
 #include "scripting/ScriptEngine.h"
@@ -86,6 +88,7 @@ void GameState::InitAll(const TileCoordsXY& mapSize)
     finance_init();
     banner_init();
     ride_init_all();
+    ride_ratings_reset_update_states();
     ResetAllEntities();
     UpdateConsolidatedPatrolAreas();
     date_reset();
@@ -111,11 +114,14 @@ void GameState::InitAll(const TileCoordsXY& mapSize)
     auto& scriptEngine = GetContext()->GetScriptEngine();
     scriptEngine.ClearParkStorage();
 #endif
-	if (firstRun) //socket_gs.handle() == nullptr)
+	if (firstRun && gOpenRCT2ControlSocket) //socket_gs.handle() == nullptr)
 	{
 		firstRun = false;
-		std::cout<<"GS BIND\n";
-	    socket_gs.bind("tcp://*:5555");		
+		log_verbose("Control socket bound");
+	    socket_gs.bind("tcp://*:5555");
+
+	    // Clients of the control socket expect tested designs in export.td6 unless they ask for something else
+	    TrackDesignResultSink::Set(TrackDesignResultSink::CreateFileSink("export.td6", "tcp://localhost:5556"));
 	}
 }
 
@@ -276,170 +282,103 @@ void GameState::Tick()
 }
 
 
-std::array<CoordsXY, 6> possibleCoords = {
-	CoordsXY(6320, 6832),
-	CoordsXY(4220, 1350),
-	CoordsXY(0, 0),
-	CoordsXY(150, 150),
-	CoordsXY(200, 200),
-	CoordsXY(350, 350)
-};
-
 RideId createdRideID = RideId::GetNull();
-void GameState::UpdateLogic(LogicTimings* timings)
+static bool _controlSocketEvaluating = false;
+
+/**
+ * Polls the control socket for track designs to place and test. Returns false if the
+ * current tick should be skipped.
+ */
+static bool UpdateControlSocket()
 {
+    if (_controlSocketEvaluating)
+        return true;
+
     zmq::message_t request;
-	
-    //const CoordsXY mapCoords = ViewportInteractionGetTileStartAtCursor(screenCoords);
-	//std::cout<<mapCoords.x<<","<<mapCoords.y<<"\n";
-	
+
     gBankLoan = 0.00_GBP;
 	gResearchFundingLevel = 0;
 
     // receive a request from client
     auto num = socket_gs.recv(request, zmq::recv_flags::dontwait);
-	if (num > 0)
+	if (num > 0 && TrackDesignEvaluationProtocol::IsRequest(request.data(), request.size()))
+	{
+		// Binary requests are evaluated right away, the game logic is advanced from in here so the socket must not be
+		// polled again until the reply has been sent
+		_controlSocketEvaluating = true;
+		auto result = TrackDesignEvaluationProtocol::HandleRequest(
+		    *GetContext()->GetGameState(), request.data(), request.size());
+		_controlSocketEvaluating = false;
+
+		zmq::message_t reply(&result, sizeof(result));
+		reply.set_routing_id(request.routing_id());
+		socket_gs.send(reply, zmq::send_flags::none);
+	}
+	else if (num > 0)
 	{
 		Json::Value res;
 		Json::Reader reader = {};
-		std::cout<<"received "<<request.to_string()<<"\n";
+		log_verbose("Control socket request: %s", request.to_string().c_str());
 		auto status = reader.parse(request.to_string(), res);
         if (!status) {
-            std::cout <<"ConHash:: Error while parsing: " << reader.getFormattedErrorMessages().c_str() << std::endl;
+            log_error("Unable to parse control socket request: %s", reader.getFormattedErrorMessages().c_str());
         } else {
-            std::cout<<"Successfully parsed !!" <<std::endl;
 			
 			window_close_all();
-			if (res["action"] == "load_track")
+			if (res["action"] == "set_simulation_mode")
+			{
+				auto mode = res["mode"] == "test_run_only" ? SimulationMode::TestRunOnly : SimulationMode::Normal;
+				GetContext()->GetGameState()->SetSimulationMode(mode);
+			}
+			else if (res["action"] == "set_result_sink")
+			{
+				// {"sink": "file", "path": ..., "notify": ...}, {"sink": "socket", "endpoint": ...} or {"sink": "none"}
+				if (res["sink"] == "file")
+				{
+					TrackDesignResultSink::Set(TrackDesignResultSink::CreateFileSink(
+					    res.get("path", "export.td6").asString(), res.get("notify", "").asString()));
+				}
+				else if (res["sink"] == "socket")
+				{
+					TrackDesignResultSink::Set(TrackDesignResultSink::CreateSocketSink(res["endpoint"].asString()));
+				}
+				else
+				{
+					TrackDesignResultSink::Set(nullptr);
+				}
+			}
+			else if (res["action"] == "load_track")
 			{
 				std::string path = res["path"].asString();
 				const char* path_c = path.c_str();
 				
 				if (!(createdRideID.IsNull()))
-		        {
-					auto ride = get_ride(createdRideID);
-					std::cout<<"R1\n";
+				{
+					TrackDesignEvaluator::Remove(createdRideID, true);
 					createdRideID = RideId::GetNull();
-			
-				    // close first...
-					auto gameAction1 = RideSetStatusAction(ride->id, RideStatus::Closed);
-				    //gameAction.SetCallback([&](const GameAction*, const GameActions::Result* result) {
-				    //});
-				    gameAction1.SetFlags(GAME_COMMAND_FLAG_APPLY);
-			
-				    GameActions::ExecuteNested(&gameAction1);
-					std::cout<<"R2\n";
-				    if (!(ride->lifecycle_flags & RIDE_LIFECYCLE_ON_TRACK))
-					{
-						ride->lifecycle_flags &= RIDE_LIFECYCLE_ON_TRACK;
-					}
-				    ride_clear_for_construction(ride);
-			
-					auto gameAction2 = RideDemolishAction(ride->id, RIDE_MODIFY_DEMOLISH);
-				    gameAction2.SetFlags(GAME_COMMAND_FLAG_APPLY);
-				    //gameAction.SetCallback([&](const GameAction*, const GameActions::Result* result) {
-					std::cout<<"R3\n";
-					//});				
-				    GameActions::ExecuteNested(&gameAction2);
-			
-
-
-				    ClearableItems itemsToClear = 0;
-			        itemsToClear |= CLEARABLE_ITEMS::SCENERY_SMALL;
-			        itemsToClear |= CLEARABLE_ITEMS::SCENERY_LARGE;
-			        itemsToClear |= CLEARABLE_ITEMS::SCENERY_FOOTPATH;
-			
-					auto mapSizeMaxXY = GetMapSizeMaxXY();
-				    auto range = MapRange(0, 0, mapSizeMaxXY.x, mapSizeMaxXY.y);
+				}
 
-				    auto cAction = ClearAction(range, itemsToClear);
-					auto res = GameActions::Execute(&cAction);
-			
-					//ride_action_modify(&ride, RIDE_MODIFY_DEMOLISH, GAME_COMMAND_FLAG_APPLY);
-		        }
-		
 			    std::unique_ptr<TrackDesign> _trackDesign = TrackDesignImport(path_c);
 				if (_trackDesign != nullptr)
 				{
 					_trackDesign->name = "Test";
-	
-					RideId _rideIndex{ RideId::GetNull() };
-		
-					auto _currentTrackPieceDirection = static_cast<Direction>(0);
-
-	
-					CoordsXYZ trackLoc;
-					GameActions::Result res;
-					bool found2 = false;
-					for (auto &mapCoords : possibleCoords)
+
+					auto trackLoc = TrackDesignEvaluator::FindPlacement(*_trackDesign, TrackDesignEvaluator::GetDefaultOrigins());
+					if (!trackLoc.has_value())
 					{
-					    auto surfaceElement = map_get_surface_element_at(mapCoords);
-					    auto mapZ = surfaceElement->GetBaseZ() + TrackDesignGetZPlacement(_trackDesign.get(), GetOrAllocateRide(_rideIndex), { mapCoords, surfaceElement->GetBaseZ() });
-						//std::cout<<"mapz:"<<mapZ<<"\n";
-		
-					    trackLoc = { mapCoords, mapZ };
-						bool found = false;
-					    for (int32_t i2 = 0; i2 < 7; i2++, trackLoc.z += 8)
-					    {
-					        auto tdAction = TrackDesignAction(CoordsXYZD{ trackLoc.x, trackLoc.y, trackLoc.z, _currentTrackPieceDirection }, *_trackDesign);
-					        tdAction.SetFlags(0);
-					        res = GameActions::Query(&tdAction);
-
-					        // If successful don't keep trying.
-					        // If failure due to no money then increasing height only makes problem worse
-					        if (res.Error != GameActions::Status::Ok) // || res.Error == GameActions::Status::InsufficientFunds)
-					        {
-								std::cout<<"ERR1\n" << res.GetErrorMessage()<<"\n";
-					        }
-							else
-							{
-								found = true;
-								break;
-							}
-					    }
-						if (found)
-						{
-							found2 = true;
-							break;
-						}
+						log_warning("No space to place track design %s", path_c);
+						return false;
 					}
-	
-					if (!found2)
+					createdRideID = TrackDesignEvaluator::Place(*_trackDesign, *trackLoc);
+					if (createdRideID.IsNull())
 					{
-						std::cout<<"stopping\n";
-						return;
+						log_error("Unable to place track design %s", path_c);
+					}
+					else
+					{
+						auto gameAction = RideSetStatusAction(createdRideID, RideStatus::Open);
+						GameActions::ExecuteNested(&gameAction);
 					}
-					std::cout<<"Placing\n";
-				    auto tdAction = TrackDesignAction({ trackLoc, _currentTrackPieceDirection }, *_trackDesign);
-				    tdAction.SetCallback([&](const GameAction*, const GameActions::Result* result) {
-				        if (result->Error == GameActions::Status::Ok)
-				        {
-				            auto rideId = result->GetData<RideId>();
-				            auto getRide = get_ride(rideId);
-							createdRideID = rideId;
-				            if (getRide != nullptr)
-				            {
-				                //auto intent = Intent(WC_RIDE);
-				                //intent.putExtra(INTENT_EXTRA_RIDE_ID, rideId.ToUnderlying());
-				                //context_open_intent(&intent);
-				
-							    RideSetStatusAction gameAction = RideSetStatusAction(rideId, RideStatus::Open);
-								gameAction.SetCallback([&](const GameAction*, const GameActions::Result* result) {
-									std::cout<<"CALLBACK\n";
-								});
-							    GameActions::ExecuteNested(&gameAction);
-				            }
-				        }
-				        else
-				        {
-							std::cout<<"ERR2\n";
-						}
-				    });
-				    res = GameActions::Execute(&tdAction);
-		
-				    // send the reply to the client
-					//std::cout << "Sending back.\n";
-				    //socket.send(zmq::buffer(data), zmq::send_flags::none);
 				}
 			}
         }
@@ -458,8 +397,14 @@ void GameState::UpdateLogic(LogicTimings* timings)
 			}
 		}
 	}
-	
-	
+    return true;
+}
+
+void GameState::UpdateLogic(LogicTimings* timings)
+{
+    if (gOpenRCT2ControlSocket && !UpdateControlSocket())
+        return;
+
     PROFILED_FUNCTION();
 
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -524,50 +469,77 @@ void GameState::UpdateLogic(LogicTimings* timings)
     _date = Date(static_cast<uint32_t>(gDateMonthsElapsed), gDateMonthTicks);
     report_time(LogicTimePart::Date);
 
-    scenario_update();
+    // The skipped parts still report their time so LogicTimings shows them as taking no time at all.
+    const bool fullSimulation = IsFullSimulation();
+
+    if (fullSimulation)
+        scenario_update();
     report_time(LogicTimePart::Scenario);
-    climate_update();
+    if (fullSimulation)
+        climate_update();
     report_time(LogicTimePart::Climate);
-    map_update_tiles();
+    if (fullSimulation)
+        map_update_tiles();
     report_time(LogicTimePart::MapTiles);
-    // Temporarily remove provisional paths to prevent peep from interacting with them
-    map_remove_provisional_elements();
-    report_time(LogicTimePart::MapStashProvisionalElements);
-    map_update_path_wide_flags();
-    report_time(LogicTimePart::MapPathWideFlags);
-    peep_update_all();
-    report_time(LogicTimePart::Peep);
-    map_restore_provisional_elements();
-    report_time(LogicTimePart::MapRestoreProvisionalElements);
+    if (fullSimulation)
+    {
+        // Temporarily remove provisional paths to prevent peep from interacting with them
+        map_remove_provisional_elements();
+        report_time(LogicTimePart::MapStashProvisionalElements);
+        map_update_path_wide_flags();
+        report_time(LogicTimePart::MapPathWideFlags);
+        peep_update_all();
+        report_time(LogicTimePart::Peep);
+        map_restore_provisional_elements();
+        report_time(LogicTimePart::MapRestoreProvisionalElements);
+    }
+    else
+    {
+        report_time(LogicTimePart::MapStashProvisionalElements);
+        report_time(LogicTimePart::MapPathWideFlags);
+        report_time(LogicTimePart::Peep);
+        report_time(LogicTimePart::MapRestoreProvisionalElements);
+    }
     vehicle_update_all();
     report_time(LogicTimePart::Vehicle);
-    UpdateAllMiscEntities();
+    if (fullSimulation)
+        UpdateAllMiscEntities();
     report_time(LogicTimePart::Misc);
     Ride::UpdateAll();
     report_time(LogicTimePart::Ride);
 
-    if (!(gScreenFlags & SCREEN_FLAGS_EDITOR))
+    if (fullSimulation && !(gScreenFlags & SCREEN_FLAGS_EDITOR))
     {
         _park->Update(_date);
     }
     report_time(LogicTimePart::Park);
 
-    research_update();
+    if (fullSimulation)
+        research_update();
     report_time(LogicTimePart::Research);
     ride_ratings_update_all();
     report_time(LogicTimePart::RideRatings);
     ride_measurements_update();
     report_time(LogicTimePart::RideMeasurments);
-    News::UpdateCurrentItem();
+    if (fullSimulation)
+        News::UpdateCurrentItem();
     report_time(LogicTimePart::News);
 
-    map_animation_invalidate_all();
-    report_time(LogicTimePart::MapAnimation);
-    vehicle_sounds_update();
-    peep_update_crowd_noise();
-    climate_update_sound();
-    report_time(LogicTimePart::Sounds);
-    editor_open_windows_for_current_step();
+    if (fullSimulation)
+    {
+        map_animation_invalidate_all();
+        report_time(LogicTimePart::MapAnimation);
+        vehicle_sounds_update();
+        peep_update_crowd_noise();
+        climate_update_sound();
+        report_time(LogicTimePart::Sounds);
+        editor_open_windows_for_current_step();
+    }
+    else
+    {
+        report_time(LogicTimePart::MapAnimation);
+        report_time(LogicTimePart::Sounds);
+    }
 
     // Update windows
     // window_dispatch_update_all();
@@ -605,6 +577,12 @@ void GameState::UpdateLogic(LogicTimings* timings)
     }
 }
 
+bool GameState::IsFullSimulation() const
+{
+    // Every peer has to run the same simulation
+    return _simulationMode == SimulationMode::Normal || network_get_mode() != NETWORK_MODE_NONE;
+}
+
 void GameState::CreateStateSnapshot()
 {
     PROFILED_FUNCTION();
@@ -615,3 +593,131 @@ void GameState::CreateStateSnapshot()
     snapshots->Capture(snapshot);
     snapshots->LinkSnapshot(snapshot, gCurrentTicks, scenario_rand_state().s0);
 }
+
+std::unique_ptr<GameStateCheckpoint> GameState::Checkpoint() const
+{
+    PROFILED_FUNCTION();
+
+    auto checkpoint = std::make_unique<GameStateCheckpoint>();
+    checkpoint->Map = CreateMapCheckpoint();
+    checkpoint->Entities = CreateEntitiesCheckpoint();
+    checkpoint->Rides = CreateRidesCheckpoint();
+    checkpoint->RideRatingStates = gRideRatingUpdateStates;
+    checkpoint->Banners = CreateBannersCheckpoint();
+    checkpoint->MapAnimations = GetMapAnimations();
+    checkpoint->NextGuestNumber = gNextGuestNumber;
+
+    checkpoint->Cash = gCash;
+    checkpoint->BankLoan = gBankLoan;
+    checkpoint->CurrentExpenditure = gCurrentExpenditure;
+    checkpoint->CurrentProfit = gCurrentProfit;
+    checkpoint->HistoricalProfit = gHistoricalProfit;
+    checkpoint->WeeklyProfitAverageDividend = gWeeklyProfitAverageDividend;
+    checkpoint->WeeklyProfitAverageDivisor = gWeeklyProfitAverageDivisor;
+    std::memcpy(checkpoint->CashHistory, gCashHistory, sizeof(gCashHistory));
+    std::memcpy(checkpoint->WeeklyProfitHistory, gWeeklyProfitHistory, sizeof(gWeeklyProfitHistory));
+    std::memcpy(checkpoint->ParkValueHistory, gParkValueHistory, sizeof(gParkValueHistory));
+    std::memcpy(checkpoint->ExpenditureTable, gExpenditureTable, sizeof(gExpenditureTable));
+
+    checkpoint->ParkRating = gParkRating;
+    checkpoint->ParkValue = gParkValue;
+    checkpoint->CompanyValue = gCompanyValue;
+    checkpoint->TotalRideValueForMoney = gTotalRideValueForMoney;
+    checkpoint->TotalAdmissions = gTotalAdmissions;
+    checkpoint->TotalIncomeFromAdmissions = gTotalIncomeFromAdmissions;
+    checkpoint->NumGuestsInPark = gNumGuestsInPark;
+    checkpoint->NumGuestsInParkLastWeek = gNumGuestsInParkLastWeek;
+    checkpoint->NumGuestsHeadingForPark = gNumGuestsHeadingForPark;
+
+    checkpoint->ResearchFundingLevel = gResearchFundingLevel;
+    checkpoint->ResearchPriorities = gResearchPriorities;
+    checkpoint->ResearchProgress = gResearchProgress;
+    checkpoint->ResearchProgressStage = gResearchProgressStage;
+    checkpoint->ResearchExpectedMonth = gResearchExpectedMonth;
+    checkpoint->ResearchExpectedDay = gResearchExpectedDay;
+    checkpoint->ResearchLastItem = gResearchLastItem;
+    checkpoint->ResearchNextItem = gResearchNextItem;
+    checkpoint->ResearchItemsUninvented = gResearchItemsUninvented;
+    checkpoint->ResearchItemsInvented = gResearchItemsInvented;
+    checkpoint->ResearchUncompletedCategories = gResearchUncompletedCategories;
+
+    checkpoint->NewsItems = gNewsItems;
+
+    checkpoint->Climate = gClimate;
+    checkpoint->ClimateCurrent = gClimateCurrent;
+    checkpoint->ClimateNext = gClimateNext;
+    checkpoint->ClimateUpdateTimer = gClimateUpdateTimer;
+
+    checkpoint->GameDate = _date;
+    checkpoint->DateMonthTicks = gDateMonthTicks;
+    checkpoint->DateMonthsElapsed = gDateMonthsElapsed;
+    checkpoint->CurrentTicks = gCurrentTicks;
+    checkpoint->GrassSceneryTileLoopPosition = gGrassSceneryTileLoopPosition;
+    checkpoint->WidePathTileLoopPosition = gWidePathTileLoopPosition;
+    checkpoint->ScenarioRand = gScenarioRand.state();
+    return checkpoint;
+}
+
+void GameState::Restore(const GameStateCheckpoint& checkpoint)
+{
+    PROFILED_FUNCTION();
+
+    RestoreRidesCheckpoint(checkpoint.Rides);
+    RestoreEntitiesCheckpoint(checkpoint.Entities);
+    RestoreMapCheckpoint(checkpoint.Map);
+    gRideRatingUpdateStates = checkpoint.RideRatingStates;
+    RestoreBannersCheckpoint(checkpoint.Banners);
+    RestoreMapAnimationsCheckpoint(checkpoint.MapAnimations);
+    gNextGuestNumber = checkpoint.NextGuestNumber;
+
+    gCash = checkpoint.Cash;
+    gBankLoan = checkpoint.BankLoan;
+    gCurrentExpenditure = checkpoint.CurrentExpenditure;
+    gCurrentProfit = checkpoint.CurrentProfit;
+    gHistoricalProfit = checkpoint.HistoricalProfit;
+    gWeeklyProfitAverageDividend = checkpoint.WeeklyProfitAverageDividend;
+    gWeeklyProfitAverageDivisor = checkpoint.WeeklyProfitAverageDivisor;
+    std::memcpy(gCashHistory, checkpoint.CashHistory, sizeof(gCashHistory));
+    std::memcpy(gWeeklyProfitHistory, checkpoint.WeeklyProfitHistory, sizeof(gWeeklyProfitHistory));
+    std::memcpy(gParkValueHistory, checkpoint.ParkValueHistory, sizeof(gParkValueHistory));
+    std::memcpy(gExpenditureTable, checkpoint.ExpenditureTable, sizeof(gExpenditureTable));
+
+    gParkRating = checkpoint.ParkRating;
+    gParkValue = checkpoint.ParkValue;
+    gCompanyValue = checkpoint.CompanyValue;
+    gTotalRideValueForMoney = checkpoint.TotalRideValueForMoney;
+    gTotalAdmissions = checkpoint.TotalAdmissions;
+    gTotalIncomeFromAdmissions = checkpoint.TotalIncomeFromAdmissions;
+    gNumGuestsInPark = checkpoint.NumGuestsInPark;
+    gNumGuestsInParkLastWeek = checkpoint.NumGuestsInParkLastWeek;
+    gNumGuestsHeadingForPark = checkpoint.NumGuestsHeadingForPark;
+
+    gResearchFundingLevel = checkpoint.ResearchFundingLevel;
+    gResearchPriorities = checkpoint.ResearchPriorities;
+    gResearchProgress = checkpoint.ResearchProgress;
+    gResearchProgressStage = checkpoint.ResearchProgressStage;
+    gResearchExpectedMonth = checkpoint.ResearchExpectedMonth;
+    gResearchExpectedDay = checkpoint.ResearchExpectedDay;
+    gResearchLastItem = checkpoint.ResearchLastItem;
+    gResearchNextItem = checkpoint.ResearchNextItem;
+    gResearchItemsUninvented = checkpoint.ResearchItemsUninvented;
+    gResearchItemsInvented = checkpoint.ResearchItemsInvented;
+    gResearchUncompletedCategories = checkpoint.ResearchUncompletedCategories;
+
+    gNewsItems = checkpoint.NewsItems;
+
+    gClimate = checkpoint.Climate;
+    gClimateCurrent = checkpoint.ClimateCurrent;
+    gClimateNext = checkpoint.ClimateNext;
+    gClimateUpdateTimer = checkpoint.ClimateUpdateTimer;
+
+    _date = checkpoint.GameDate;
+    gDateMonthTicks = checkpoint.DateMonthTicks;
+    gDateMonthsElapsed = checkpoint.DateMonthsElapsed;
+    gCurrentTicks = checkpoint.CurrentTicks;
+    gGrassSceneryTileLoopPosition = checkpoint.GrassSceneryTileLoopPosition;
+    gWidePathTileLoopPosition = checkpoint.WidePathTileLoopPosition;
+    scenario_rand_seed(checkpoint.ScenarioRand.s0, checkpoint.ScenarioRand.s1);
+
+    gfx_invalidate_screen();
+}
@@ -20,6 +20,7 @@
 namespace OpenRCT2
 {
     class Park;
+    struct GameStateCheckpoint;
 
     // Information regarding various pieces of logic update
     enum class LogicTimePart
@@ -61,6 +62,15 @@ namespace OpenRCT2
         size_t CurrentIdx{};
     };
 
+    // Selects which subsystems are updated every tick
+    enum class SimulationMode : uint8_t
+    {
+        Normal,
+        // Only updates what is needed to test rides: the date, vehicles, rides, ratings and measurements. Guests,
+        // staff, the park, climate, research, news and all presentation updates are skipped. Rides do not break down.
+        TestRunOnly,
+    };
+
     /**
      * Class to update the state of the map and park.
      */
@@ -69,6 +79,7 @@ namespace OpenRCT2
     private:
         std::unique_ptr<Park> _park;
         Date _date;
+        SimulationMode _simulationMode = SimulationMode::Normal;
 
     public:
         GameState();
@@ -82,11 +93,28 @@ namespace OpenRCT2
         {
             return *_park;
         }
+        SimulationMode GetSimulationMode() const
+        {
+            return _simulationMode;
+        }
+        void SetSimulationMode(SimulationMode mode)
+        {
+            _simulationMode = mode;
+        }
+        // Whether every subsystem is updated, test run only mode is ignored in multiplayer.
+        bool IsFullSimulation() const;
 
         void InitAll(const TileCoordsXY& mapSize);
         void Tick();
         void UpdateLogic(LogicTimings* timings = nullptr);
 
+        /**
+         * Copies the state of the park into memory, so it can be reset with Restore after the park has been changed,
+         * e.g. by building and testing a ride. See GameStateCheckpoint for what is included.
+         */
+        std::unique_ptr<GameStateCheckpoint> Checkpoint() const;
+        void Restore(const GameStateCheckpoint& checkpoint);
+
     private:
         void CreateStateSnapshot();
     };
@@ -0,0 +1,98 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Date.h"
+#include "common.h"
+#include "entity/EntityRegistry.h"
+#include "entity/Guest.h"
+#include "management/Finance.h"
+#include "management/NewsItem.h"
+#include "management/Research.h"
+#include "ride/Ride.h"
+#include "ride/RideRatings.h"
+#include "scenario/Scenario.h"
+#include "world/Banner.h"
+#include "world/Climate.h"
+#include "world/Map.h"
+#include "world/MapAnimation.h"
+#include "world/Park.h"
+
+#include <optional>
+#include <vector>
+
+namespace OpenRCT2
+{
+    /**
+     * In-memory copy of everything a track design evaluation can change: the map, entities, rides, banners, map
+     * animations, finances, the park statistics, research, news, the climate, the date, the tile loop positions and the
+     * random number generator. Objects, the scenario itself and the user interface are not part of it, so it can only
+     * be restored into the park it was created from.
+     */
+    struct GameStateCheckpoint
+    {
+        MapCheckpoint Map;
+        EntitiesCheckpoint Entities;
+        std::vector<Ride> Rides;
+        RideRatingUpdateStates RideRatingStates;
+        std::vector<Banner> Banners;
+        std::vector<MapAnimation> MapAnimations;
+        uint32_t NextGuestNumber;
+
+        money64 Cash;
+        money64 BankLoan;
+        money64 CurrentExpenditure;
+        money64 CurrentProfit;
+        money64 HistoricalProfit;
+        money64 WeeklyProfitAverageDividend;
+        uint16_t WeeklyProfitAverageDivisor;
+        decltype(gCashHistory) CashHistory;
+        decltype(gWeeklyProfitHistory) WeeklyProfitHistory;
+        decltype(gParkValueHistory) ParkValueHistory;
+        decltype(gExpenditureTable) ExpenditureTable;
+
+        uint16_t ParkRating;
+        money64 ParkValue;
+        money64 CompanyValue;
+        money16 TotalRideValueForMoney;
+        uint64_t TotalAdmissions;
+        money64 TotalIncomeFromAdmissions;
+        uint32_t NumGuestsInPark;
+        uint32_t NumGuestsInParkLastWeek;
+        uint32_t NumGuestsHeadingForPark;
+
+        uint8_t ResearchFundingLevel;
+        uint8_t ResearchPriorities;
+        uint16_t ResearchProgress;
+        uint8_t ResearchProgressStage;
+        uint8_t ResearchExpectedMonth;
+        uint8_t ResearchExpectedDay;
+        std::optional<ResearchItem> ResearchLastItem;
+        std::optional<ResearchItem> ResearchNextItem;
+        std::vector<ResearchItem> ResearchItemsUninvented;
+        std::vector<ResearchItem> ResearchItemsInvented;
+        uint8_t ResearchUncompletedCategories;
+
+        News::ItemQueues NewsItems;
+
+        ClimateType Climate;
+        ClimateState ClimateCurrent;
+        ClimateState ClimateNext;
+        uint16_t ClimateUpdateTimer;
+
+        Date GameDate;
+        uint16_t DateMonthTicks;
+        int32_t DateMonthsElapsed;
+        uint32_t CurrentTicks;
+        uint16_t GrassSceneryTileLoopPosition;
+        TileCoordsXY WidePathTileLoopPosition;
+        random_engine_t::state_type ScenarioRand;
+    };
+} // namespace OpenRCT2
@@ -48,6 +48,7 @@ extern bool gOpenRCT2Headless;
 extern bool gOpenRCT2NoGraphics;
 extern bool gOpenRCT2ShowChangelog;
 extern bool gOpenRCT2SilentBreakpad;
+extern bool gOpenRCT2ControlSocket;
 extern u8string gSilentRecordingName;
 
 #ifndef DISABLE_NETWORK
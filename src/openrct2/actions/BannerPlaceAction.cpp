@@ -10,6 +10,7 @@
 #include "BannerPlaceAction.h"
 
 #include "../management/Finance.h"
+#include "../peep/FootpathGraph.h"
 #include "../world/Banner.h"
 #include "../world/MapAnimation.h"
 #include "../world/Scenery.h"
@@ -151,6 +152,7 @@ GameActions::Result BannerPlaceAction::Execute() const
     bannerElement->SetIndex(banner->id);
     bannerElement->SetGhost(GetFlags() & GAME_COMMAND_FLAG_GHOST);
 
+    FootpathGraph::Get().InvalidateTile(_loc);
     map_invalidate_tile_full(_loc);
     map_animation_create(MAP_ANIMATION_TYPE_BANNER, CoordsXYZ{ _loc, bannerElement->GetBaseZ() });
 
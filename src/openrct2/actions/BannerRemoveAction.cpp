@@ -10,6 +10,7 @@
 #include "BannerRemoveAction.h"
 
 #include "../management/Finance.h"
+#include "../peep/FootpathGraph.h"
 #include "../world/Banner.h"
 #include "../world/MapAnimation.h"
 #include "../world/Scenery.h"
@@ -121,6 +122,7 @@ GameActions::Result BannerRemoveAction::Execute() const
     }
 
     reinterpret_cast<TileElement*>(bannerElement)->RemoveBannerEntry();
+    FootpathGraph::Get().InvalidateTile(_loc);
     map_invalidate_tile_zoom1({ _loc, _loc.z, _loc.z + 32 });
     bannerElement->Remove();
 
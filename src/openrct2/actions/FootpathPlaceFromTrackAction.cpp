@@ -15,6 +15,7 @@
 #include "../interface/Window.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/FootpathGraph.h"
 #include "../ride/RideConstruction.h"
 #include "../world/ConstructionClearance.h"
 #include "../world/Footpath.h"
@@ -275,6 +276,7 @@ GameActions::Result FootpathPlaceFromTrackAction::ElementInsertExecute(GameActio
         pathElement->SetCorners(0);
         pathElement->SetGhost(GetFlags() & GAME_COMMAND_FLAG_GHOST);
 
+        FootpathGraph::Get().InvalidateTile(_loc);
         map_invalidate_tile_full(_loc);
     }
 
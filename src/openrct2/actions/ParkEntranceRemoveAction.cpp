@@ -11,6 +11,7 @@
 
 #include "../OpenRCT2.h"
 #include "../management/Finance.h"
+#include "../peep/FootpathGraph.h"
 #include "../world/Entrance.h"
 #include "../world/Park.h"
 
@@ -92,6 +93,7 @@ void ParkEntranceRemoveAction::ParkEntranceRemoveSegment(const CoordsXYZ& loc) c
     }
 
     map_invalidate_tile({ loc, entranceElement->GetBaseZ(), entranceElement->GetClearanceZ() });
+    FootpathGraph::Get().InvalidateTile(loc);
     entranceElement->Remove();
     update_park_fences({ loc.x, loc.y });
 }
@@ -13,6 +13,7 @@
 #include "../entity/Peep.h"
 #include "../interface/Window.h"
 #include "../management/Finance.h"
+#include "../ride/RideRatings.h"
 #include "../scenario/Scenario.h"
 #include "../util/Util.h"
 #include "../world/Park.h"
@@ -240,6 +241,9 @@ GameActions::Result ScenarioSetSettingAction::Execute() const
         case ScenarioSetSetting::AllowEarlyCompletion:
             gAllowEarlyCompletionInNetworkPlay = _value;
             break;
+        case ScenarioSetSetting::RideRatingUpdateBudget:
+            gRideRatingUpdateBudget = std::clamp<uint32_t>(_value, 1, UINT8_MAX);
+            break;
         default:
             log_error("Invalid setting: %u", _setting);
             return GameActions::Result(GameActions::Status::InvalidParameters, STR_NONE, STR_NONE);
@@ -17,6 +17,7 @@
 #include "../drawing/Drawing.h"
 #include "../entity/Duck.h"
 #include "../entity/EntityRegistry.h"
+#include "../entity/GuestNeeds.h"
 #include "../entity/Staff.h"
 #include "../localisation/Localisation.h"
 #include "../localisation/StringIds.h"
@@ -594,6 +595,7 @@ void SetCheatAction::SetGuestParameter(int32_t parameter, int32_t value) const
                 break;
         }
         peep->UpdateSpriteType();
+        GuestNeeds::Get().Update(*peep);
     }
 }
 
@@ -605,6 +607,7 @@ void SetCheatAction::GiveObjectToGuests(int32_t object) const
         {
             case OBJECT_MONEY:
                 peep->CashInPocket = 1000.00_GBP;
+                GuestNeeds::Get().Update(*peep);
                 break;
             case OBJECT_PARK_MAP:
                 peep->GiveItem(ShopItem::Map);
@@ -9,6 +9,7 @@
 
 #include "TileModifyAction.h"
 
+#include "../peep/FootpathGraph.h"
 #include "../world/TileInspector.h"
 
 using namespace OpenRCT2;
@@ -42,6 +43,8 @@ GameActions::Result TileModifyAction::Query() const
 
 GameActions::Result TileModifyAction::Execute() const
 {
+    // The tile inspector can change path edges, banners and entrances directly
+    FootpathGraph::Get().InvalidateTile(_loc);
     return QueryExecute(true);
 }
 
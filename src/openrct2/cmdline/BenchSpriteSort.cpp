@@ -43,14 +43,15 @@ static void fixup_pointers(std::vector<RecordedPaintSession>& s)
         auto& quadrants = s[i].Session.Quadrants;
         for (size_t j = 0; j < entries.size(); j++)
         {
-            if (entries[j].AsBasic()->next_quadrant_ps == reinterpret_cast<paint_struct*>(-1))
+            if (entries[j].GetBasic()->next_quadrant_ps == reinterpret_cast<paint_struct*>(-1))
             {
-                entries[j].AsBasic()->next_quadrant_ps = nullptr;
+                entries[j].GetBasic()->next_quadrant_ps = nullptr;
             }
             else
             {
-                auto nextQuadrantPs = reinterpret_cast<size_t>(entries[j].AsBasic()->next_quadrant_ps) / sizeof(paint_entry);
-                entries[j].AsBasic()->next_quadrant_ps = s[i].Entries[nextQuadrantPs].AsBasic();
+                auto nextQuadrantPs = reinterpret_cast<size_t>(entries[j].GetBasic()->next_quadrant_ps)
+                    / sizeof(paint_entry);
+                entries[j].GetBasic()->next_quadrant_ps = s[i].Entries[nextQuadrantPs].GetBasic();
             }
         }
         for (size_t j = 0; j < std::size(quadrants); j++)
@@ -62,7 +63,7 @@ static void fixup_pointers(std::vector<RecordedPaintSession>& s)
             else
             {
                 auto ps = reinterpret_cast<size_t>(quadrants[j]) / sizeof(paint_entry);
-                quadrants[j] = entries[ps].AsBasic();
+                quadrants[j] = entries[ps].GetBasic();
             }
         }
     }
@@ -14,7 +14,9 @@
 #    include "../Context.h"
 #    include "../GameState.h"
 #    include "../OpenRCT2.h"
+#    include "../config/Config.h"
 #    include "../core/File.h"
+#    include "../peep/GuestPathfinding.h"
 #    include "../platform/Platform.h"
 
 #    include <benchmark/benchmark.h>
@@ -25,8 +27,11 @@
 
 using namespace OpenRCT2;
 
-static void BM_update(benchmark::State& state, const std::string& filename)
+static void BM_update(
+    benchmark::State& state, const std::string& filename, SimulationMode mode, PeepPathfindingMode pathfindingMode)
 {
+    // Each variant changes the configuration, put it back so the next benchmark starts from the same settings
+    const auto configBackup = gConfigGeneral;
     std::unique_ptr<IContext> context(CreateContext());
     if (context->Initialise())
     {
@@ -34,6 +39,8 @@ static void BM_update(benchmark::State& state, const std::string& filename)
         {
             state.SkipWithError("Failed to load file!");
         }
+        context->GetGameState()->SetSimulationMode(mode);
+        gConfigGeneral.peep_pathfinding_mode = pathfindingMode;
 
         std::vector<LogicTimings> timings(1);
         timings.reserve(100);
@@ -85,12 +92,14 @@ static void BM_update(benchmark::State& state, const std::string& filename)
     {
         state.SkipWithError("Context initialization failed.");
     }
+    gConfigGeneral = configBackup;
 }
 
 static int CmdlineForBenchSpriteSort(int argc, const char* const* argv)
 {
     // Add a baseline test on an empty park
-    benchmark::RegisterBenchmark("baseline", BM_update, std::string{});
+    benchmark::RegisterBenchmark(
+        "baseline", BM_update, std::string{}, SimulationMode::Normal, PeepPathfindingMode::BoundedSearch);
 
     // Google benchmark does stuff to argv. It doesn't modify the pointees,
     // but it wants to reorder the pointers, so present a copy of them.
@@ -104,8 +113,19 @@ static int CmdlineForBenchSpriteSort(int argc, const char* const* argv)
     {
         if (File::Exists(argv[i]))
         {
-            // Register benchmark for sv6 if valid
-            benchmark::RegisterBenchmark(argv[i], BM_update, argv[i]);
+            // Register benchmark for sv6 if valid, also in test run only mode to compare the time it saves and with
+            // guests routed over the footpath graph, with and without flow fields
+            benchmark::RegisterBenchmark(
+                argv[i], BM_update, argv[i], SimulationMode::Normal, PeepPathfindingMode::BoundedSearch);
+            benchmark::RegisterBenchmark(
+                (std::string(argv[i]) + " (test run only)").c_str(), BM_update, argv[i], SimulationMode::TestRunOnly,
+                PeepPathfindingMode::BoundedSearch);
+            benchmark::RegisterBenchmark(
+                (std::string(argv[i]) + " (footpath graph)").c_str(), BM_update, argv[i], SimulationMode::Normal,
+                PeepPathfindingMode::FootpathGraph);
+            benchmark::RegisterBenchmark(
+                (std::string(argv[i]) + " (flow fields)").c_str(), BM_update, argv[i], SimulationMode::Normal,
+                PeepPathfindingMode::FlowField);
         }
         else
         {
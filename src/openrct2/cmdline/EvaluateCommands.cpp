@@ -0,0 +1,304 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../Context.h"
+#include "../GameState.h"
+#include "../GameStateCheckpoint.h"
+#include "../OpenRCT2.h"
+#include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/FileScanner.h"
+#include "../core/Json.hpp"
+#include "../core/Path.hpp"
+#include "../core/String.hpp"
+#include "../platform/Platform.h"
+#include "../ride/TrackDesign.h"
+#include "../ride/TrackDesignEvaluator.h"
+#include "../world/Map.h"
+#include "../world/Park.h"
+#include "CommandLine.hpp"
+#include "WorkerFarm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+using namespace OpenRCT2;
+
+static int32_t _maxTicks = 0;
+static bool _openRide = false;
+static bool _keepScenery = false;
+static int32_t _workers = 0;
+static bool _testRunOnly = false;
+static bool _fastTestRun = false;
+static int32_t _concurrentTests = 0;
+static bool _demolish = false;
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition EvaluateOptionsDef[]
+{
+    { CMDLINE_TYPE_INTEGER, &_maxTicks,        NAC, "max-ticks",     "maximum number of ticks to wait for each test run to complete" },
+    { CMDLINE_TYPE_SWITCH,  &_openRide,        NAC, "open",          "open each ride instead of testing it" },
+    { CMDLINE_TYPE_SWITCH,  &_keepScenery,     NAC, "keep-scenery",  "do not clear scenery from the map after each design" },
+    { CMDLINE_TYPE_INTEGER, &_workers,         NAC, "workers",       "number of worker processes to evaluate designs in parallel" },
+    { CMDLINE_TYPE_SWITCH,  &_testRunOnly,     NAC, "test-run-only", "only update what the test runs need, skipping guests, staff, climate etc." },
+    { CMDLINE_TYPE_SWITCH,  &_fastTestRun,     NAC, "fast-test",     "only update the tested ride and its trains during each test run" },
+    { CMDLINE_TYPE_INTEGER, &_concurrentTests, NAC, "concurrent",    "number of rides to test at the same time on separate sites of the park" },
+    { CMDLINE_TYPE_SWITCH,  &_demolish,        NAC, "demolish",      "demolish each ride instead of restoring the park from a checkpoint" },
+    OptionTableEnd
+};
+
+static exitcode_t HandleEvaluate(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::EvaluateCommands[]
+{
+    // Main commands
+    DefineCommand("", "<park> <design|directory|manifest.txt> [<output.jsonl>]", EvaluateOptionsDef, HandleEvaluate),
+    CommandTableEnd
+};
+// clang-format on
+
+static std::vector<std::string> GetDesignPaths(const std::string& input)
+{
+    std::vector<std::string> paths;
+    if (Path::DirectoryExists(input))
+    {
+        auto scanner = Path::ScanDirectory(Path::Combine(input, "*.td4;*.td6;*.td9"), true);
+        while (scanner->Next())
+        {
+            paths.emplace_back(scanner->GetPath());
+        }
+        std::sort(paths.begin(), paths.end());
+    }
+    else if (String::Equals(Path::GetExtension(input), ".txt", true))
+    {
+        // A manifest lists one design per line
+        for (const auto& line : File::ReadAllLines(input))
+        {
+            auto path = String::Trim(line);
+            if (!path.empty())
+            {
+                paths.push_back(path);
+            }
+        }
+    }
+    else
+    {
+        paths.push_back(input);
+    }
+    return paths;
+}
+
+static json_t EvaluationToJson(const std::string& path, const TrackDesignEvaluation& evaluation)
+{
+    auto toMs = [](std::chrono::duration<double> duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    json_t result = {
+        { "path", path },
+        { "placed", evaluation.Placed },
+        { "tested", evaluation.Tested },
+        { "ticks", evaluation.TestTicks },
+        { "timings",
+          {
+              { "place_ms", toMs(evaluation.PlaceTime) },
+              { "test_ms", toMs(evaluation.TestTime) },
+              { "rate_ms", toMs(evaluation.RateTime) },
+              { "remove_ms", toMs(evaluation.RemoveTime) },
+          } },
+    };
+    if (!evaluation.Error.empty())
+    {
+        result["error"] = evaluation.Error;
+    }
+    if (evaluation.Placed)
+    {
+        result["location"] = { evaluation.Location.x, evaluation.Location.y, evaluation.Location.z,
+                               evaluation.Location.direction };
+    }
+    if (evaluation.Tested)
+    {
+        result["ratings"] = {
+            { "excitement", evaluation.Ratings.Excitement },
+            { "intensity", evaluation.Ratings.Intensity },
+            { "nausea", evaluation.Ratings.Nausea },
+        };
+        result["stats"] = {
+            { "max_speed", evaluation.MaxSpeed },
+            { "average_speed", evaluation.AverageSpeed },
+            { "ride_time", evaluation.RideTime },
+            { "ride_length", evaluation.RideLength },
+            { "max_positive_vertical_g", evaluation.MaxPositiveVerticalG },
+            { "max_negative_vertical_g", evaluation.MaxNegativeVerticalG },
+            { "max_lateral_g", evaluation.MaxLateralG },
+            { "total_air_time", evaluation.TotalAirTime },
+            { "drops", evaluation.Drops },
+            { "highest_drop_height", evaluation.HighestDropHeight },
+            { "inversions", evaluation.Inversions },
+            { "holes", evaluation.Holes },
+        };
+    }
+    return result;
+}
+
+static std::string EvaluateDesign(GameState& gameState, const std::string& path, const TrackDesignEvaluationOptions& options)
+{
+    TrackDesignEvaluation evaluation;
+    auto td = TrackDesignImport(path.c_str());
+    if (td == nullptr)
+    {
+        evaluation.Error = "Unable to load track design.";
+    }
+    else
+    {
+        evaluation = TrackDesignEvaluator::Evaluate(gameState, *td, options);
+    }
+    return EvaluationToJson(path, evaluation).dump();
+}
+
+static void WriteResult(FILE* output, const std::string& line)
+{
+    fprintf(output, "%s\n", line.c_str());
+    fflush(output);
+}
+
+#ifdef OPENRCT2_WORKER_FARM
+static exitcode_t RunWorkerFarm(
+    GameState& gameState, const std::vector<std::string>& designPaths, int32_t numWorkers, FILE* output,
+    const TrackDesignEvaluationOptions& options)
+{
+    // The workers inherit the fully loaded park and evaluate each design they receive on their own copy
+    auto started = WorkerFarm::Run(
+        designPaths, numWorkers,
+        [&gameState, &options](const std::string& path) { return EvaluateDesign(gameState, path, options); },
+        [output](size_t, const std::string& result) { WriteResult(output, result); },
+        [&designPaths, output](size_t index, const std::string& reason) {
+            TrackDesignEvaluation evaluation;
+            evaluation.Error = reason;
+            WriteResult(output, EvaluationToJson(designPaths[index], evaluation).dump());
+        });
+    return started ? EXITCODE_OK : EXITCODE_FAIL;
+}
+#endif
+
+static exitcode_t HandleEvaluate(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 2)
+    {
+        Console::Error::WriteLine("Missing arguments <park> <design|directory|manifest.txt>.");
+        return EXITCODE_FAIL;
+    }
+
+    const char* parkPath = argv[0];
+    auto designPaths = GetDesignPaths(argv[1]);
+    if (designPaths.empty())
+    {
+        Console::Error::WriteLine("No track designs found at '%s'.", argv[1]);
+        return EXITCODE_FAIL;
+    }
+
+    Platform::CoreInit();
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    gOpenRCT2ControlSocket = false;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+    if (!context->LoadParkFromFile(parkPath))
+    {
+        return EXITCODE_FAIL;
+    }
+
+    // Construction costs do not matter for the test results
+    gParkFlags |= PARK_FLAGS_NO_MONEY;
+
+    FILE* output = stdout;
+    if (argc >= 3)
+    {
+        output = fopen(argv[2], "wb");
+        if (output == nullptr)
+        {
+            Console::Error::WriteLine("Unable to open '%s' for writing.", argv[2]);
+            return EXITCODE_FAIL;
+        }
+    }
+
+    TrackDesignEvaluationOptions options;
+    options.TestStatus = _openRide ? RideStatus::Open : RideStatus::Testing;
+    options.ClearScenery = !_keepScenery;
+    options.FastTestRun = _fastTestRun;
+    if (_concurrentTests > 1)
+    {
+        options.ConcurrentTests = static_cast<uint32_t>(_concurrentTests);
+    }
+    if (_maxTicks > 0)
+    {
+        options.MaxTestTicks = static_cast<uint32_t>(_maxTicks);
+    }
+
+    auto& gameState = *context->GetGameState();
+    if (_testRunOnly)
+    {
+        gameState.SetSimulationMode(SimulationMode::TestRunOnly);
+    }
+
+    // Rides tested concurrently are removed one at a time, so they can not use a checkpoint of the whole park
+    std::unique_ptr<GameStateCheckpoint> baseline;
+    if (!_demolish && options.ConcurrentTests <= 1)
+    {
+        // Lets restoring the checkpoint only rewrite the tiles the evaluated ride has changed
+        MapStartDirtyTileJournal();
+        baseline = gameState.Checkpoint();
+        options.Baseline = baseline.get();
+    }
+
+    exitcode_t result = EXITCODE_OK;
+    if (_workers > 1)
+    {
+#ifdef OPENRCT2_WORKER_FARM
+        auto numWorkers = std::min<int32_t>(_workers, static_cast<int32_t>(designPaths.size()));
+        result = RunWorkerFarm(gameState, designPaths, numWorkers, output, options);
+#else
+        Console::Error::WriteLine("Evaluating with multiple workers is not supported on this platform.");
+        result = EXITCODE_FAIL;
+#endif
+    }
+    else if (options.ConcurrentTests > 1)
+    {
+        TrackDesignEvaluator::EvaluateConcurrently(
+            gameState, designPaths.size(),
+            [&designPaths](size_t index) { return TrackDesignImport(designPaths[index].c_str()); }, options,
+            [&designPaths, output](size_t index, TrackDesignEvaluation&& evaluation) {
+                WriteResult(output, EvaluationToJson(designPaths[index], evaluation).dump());
+            });
+    }
+    else
+    {
+        for (const auto& designPath : designPaths)
+        {
+            WriteResult(output, EvaluateDesign(gameState, designPath, options));
+        }
+    }
+
+    if (output != stdout)
+    {
+        fclose(output);
+    }
+    return result;
+}
@@ -0,0 +1,195 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "WorkerFarm.h"
+
+#ifdef OPENRCT2_WORKER_FARM
+
+#    include "../Diagnostic.h"
+
+#    include <algorithm>
+#    include <cstdio>
+#    include <deque>
+#    include <map>
+#    include <set>
+#    include <sys/types.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#    include <zmq.hpp>
+
+namespace WorkerFarm
+{
+    /**
+     * Body of a forked worker process. The worker repeatedly sends the result of its previous item (empty at first) and
+     * receives the next one, until it receives an empty item. Never returns.
+     */
+    [[noreturn]] static void RunWorker(const std::string& endpoint, const WorkFunc& work)
+    {
+        {
+            zmq::context_t zmqContext{ 1 };
+            zmq::socket_t socket{ zmqContext, zmq::socket_type::req };
+            socket.set(zmq::sockopt::routing_id, std::to_string(getpid()));
+            socket.connect(endpoint);
+
+            std::string result;
+            while (socket.send(zmq::buffer(result)))
+            {
+                zmq::message_t request;
+                if (!socket.recv(request) || request.size() == 0)
+                    break;
+
+                result = work(request.to_string());
+            }
+        }
+
+        // Skip the static destructors, whatever is in there belongs to the supervisor
+        _exit(0);
+    }
+
+    bool Run(
+        const std::vector<std::string>& items, int32_t numWorkers, const WorkFunc& work, const ResultFunc& onResult,
+        const FailureFunc& onFailure)
+    {
+        auto endpoint = "ipc:///tmp/openrct2-workers-" + std::to_string(getpid());
+
+        // Nothing must be buffered when forking or it would be written by every worker
+        fflush(nullptr);
+
+        std::set<pid_t> running;
+        for (int32_t i = 0; i < numWorkers; i++)
+        {
+            auto pid = fork();
+            if (pid == 0)
+            {
+                RunWorker(endpoint, work);
+            }
+            if (pid == -1)
+            {
+                log_error("Unable to start worker process.");
+                break;
+            }
+            running.insert(pid);
+        }
+        if (running.empty())
+        {
+            return false;
+        }
+
+        // Created after forking as a ZeroMQ context can not be shared with child processes
+        zmq::context_t zmqContext{ 1 };
+        zmq::socket_t socket{ zmqContext, zmq::socket_type::router };
+        socket.set(zmq::sockopt::rcvtimeo, 100);
+        socket.bind(endpoint);
+
+        auto reply = [&socket](const std::string& worker, const std::string& payload) {
+            socket.send(zmq::buffer(worker), zmq::send_flags::sndmore);
+            socket.send(zmq::const_buffer{}, zmq::send_flags::sndmore);
+            socket.send(zmq::buffer(payload));
+        };
+
+        std::deque<size_t> pending;
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            pending.push_back(i);
+        }
+        std::vector<int32_t> attempts(items.size(), 0);
+        std::map<std::string, size_t> assignments;
+        // Workers waiting for an item, they are only stopped once nothing can be requeued anymore
+        std::vector<std::string> idle;
+
+        auto reapWorkers = [&]() {
+            for (auto it = running.begin(); it != running.end();)
+            {
+                auto pid = *it;
+                if (waitpid(pid, nullptr, WNOHANG) != pid)
+                {
+                    it++;
+                    continue;
+                }
+                it = running.erase(it);
+
+                auto worker = std::to_string(pid);
+                idle.erase(std::remove(idle.begin(), idle.end(), worker), idle.end());
+
+                auto assignment = assignments.find(worker);
+                if (assignment == assignments.end())
+                    continue;
+
+                auto index = assignment->second;
+                assignments.erase(assignment);
+                if (++attempts[index] < MaxAttempts)
+                {
+                    log_warning("Worker process %d exited, handing its item to another worker.", pid);
+                    pending.push_front(index);
+                }
+                else
+                {
+                    onFailure(index, "Worker process exited while working on the item.");
+                }
+            }
+        };
+
+        while (!running.empty())
+        {
+            reapWorkers();
+
+            while (!idle.empty() && !pending.empty())
+            {
+                auto index = pending.front();
+                pending.pop_front();
+                assignments[idle.back()] = index;
+                reply(idle.back(), items[index]);
+                idle.pop_back();
+            }
+            if (pending.empty() && assignments.empty())
+            {
+                // No work left, the workers exit after receiving an empty item and are reaped above
+                for (const auto& worker : idle)
+                {
+                    reply(worker, {});
+                }
+                idle.clear();
+            }
+            if (running.empty())
+                break;
+
+            zmq::message_t identity;
+            if (!socket.recv(identity))
+                continue;
+
+            zmq::message_t delimiter;
+            zmq::message_t result;
+            socket.recv(delimiter);
+            socket.recv(result);
+
+            auto worker = identity.to_string();
+            auto assignment = assignments.find(worker);
+            if (assignment != assignments.end())
+            {
+                onResult(assignment->second, result.to_string());
+                assignments.erase(assignment);
+            }
+            if (running.count(static_cast<pid_t>(std::stoi(worker))) != 0)
+            {
+                idle.push_back(worker);
+            }
+        }
+
+        // Only left over when every worker has died
+        for (auto index : pending)
+        {
+            onFailure(index, "No worker process left to work on the item.");
+        }
+
+        socket.unbind(endpoint);
+        return true;
+    }
+} // namespace WorkerFarm
+
+#endif
@@ -0,0 +1,43 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#    define OPENRCT2_WORKER_FARM
+
+namespace WorkerFarm
+{
+    // A design is handed out again when its worker dies, until it has killed this many workers.
+    constexpr int32_t MaxAttempts = 2;
+
+    // Runs in the worker process, returns the result of the given item.
+    using WorkFunc = std::function<std::string(const std::string& item)>;
+    // Runs in the supervisor process for every item, in the order they complete.
+    using ResultFunc = std::function<void(size_t index, const std::string& result)>;
+    // Runs in the supervisor process for every item that could not be completed.
+    using FailureFunc = std::function<void(size_t index, const std::string& reason)>;
+
+    /**
+     * Forks the given number of workers from the current process and hands out the items one at a time to whichever
+     * worker asks for more work, so slow items do not hold up the others. Workers that die are reaped while the others
+     * keep working and their item is handed to another worker. Returns false if no worker could be started.
+     */
+    bool Run(
+        const std::vector<std::string>& items, int32_t numWorkers, const WorkFunc& work, const ResultFunc& onResult,
+        const FailureFunc& onFailure);
+} // namespace WorkerFarm
+
+#endif
@@ -26,6 +26,7 @@
 #include "../localisation/StringIds.h"
 #include "../network/network.h"
 #include "../paint/VirtualFloor.h"
+#include "../peep/GuestPathfinding.h"
 #include "../platform/Platform.h"
 #include "../rct1/Limits.h"
 #include "../scenario/Scenario.h"
@@ -105,6 +106,12 @@ namespace Config
         ConfigEnumEntry<VirtualFloorStyles>("GLASSY", VirtualFloorStyles::Glassy),
     });
 
+    static const auto Enum_PeepPathfindingMode = ConfigEnum<PeepPathfindingMode>({
+        ConfigEnumEntry<PeepPathfindingMode>("BOUNDED_SEARCH", PeepPathfindingMode::BoundedSearch),
+        ConfigEnumEntry<PeepPathfindingMode>("FOOTPATH_GRAPH", PeepPathfindingMode::FootpathGraph),
+        ConfigEnumEntry<PeepPathfindingMode>("FLOW_FIELD", PeepPathfindingMode::FlowField),
+    });
+
     /**
      * Config enum wrapping LanguagesDescriptors.
      */
@@ -214,6 +221,8 @@ namespace Config
             model->show_guest_purchases = reader->GetBoolean("show_guest_purchases", false);
             model->show_real_names_of_guests = reader->GetBoolean("show_real_names_of_guests", true);
             model->allow_early_completion = reader->GetBoolean("allow_early_completion", false);
+            model->peep_pathfinding_mode = reader->GetEnum<PeepPathfindingMode>(
+                "peep_pathfinding_mode", PeepPathfindingMode::BoundedSearch, Enum_PeepPathfindingMode);
             model->transparent_screenshot = reader->GetBoolean("transparent_screenshot", true);
             model->transparent_water = reader->GetBoolean("transparent_water", true);
 
@@ -298,6 +307,8 @@ namespace Config
         writer->WriteBoolean("show_guest_purchases", model->show_guest_purchases);
         writer->WriteBoolean("show_real_names_of_guests", model->show_real_names_of_guests);
         writer->WriteBoolean("allow_early_completion", model->allow_early_completion);
+        writer->WriteEnum<PeepPathfindingMode>(
+            "peep_pathfinding_mode", model->peep_pathfinding_mode, Enum_PeepPathfindingMode);
         writer->WriteEnum<VirtualFloorStyles>("virtual_floor_style", model->virtual_floor_style, Enum_VirtualFloorStyle);
         writer->WriteBoolean("transparent_screenshot", model->transparent_screenshot);
         writer->WriteBoolean("transparent_water", model->transparent_water);
@@ -22,6 +22,7 @@ enum class ScaleQuality : int32_t;
 enum class Sort : int32_t;
 enum class VirtualFloorStyles : int32_t;
 enum class DrawingEngine : int32_t;
+enum class PeepPathfindingMode : uint8_t;
 
 struct GeneralConfiguration
 {
@@ -104,6 +105,7 @@ struct GeneralConfiguration
     bool steam_overlay_pause;
     bool show_real_names_of_guests;
     bool allow_early_completion;
+    PeepPathfindingMode peep_pathfinding_mode;
 
     // Loading and saving
     bool confirmation_prompt;
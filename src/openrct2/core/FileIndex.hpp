@@ -201,7 +201,8 @@ private:
         const size_t totalCount = scanResult.Files.size();
         if (totalCount > 0)
         {
-            JobPool jobPool;
+            auto& jobPool = JobPool::Get();
+            JobPool::TaskGroup taskGroup;
             std::mutex printLock; // For verbose prints.
 
             std::list<std::vector<TItem>> containers;
@@ -224,14 +225,15 @@ private:
 
                 auto& items = containers.emplace_back();
 
-                jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                const auto rangeEnd = rangeStart + stepSize;
+                jobPool.AddTask(taskGroup, [&, language, rangeStart, rangeEnd]() {
+                    BuildRange(language, scanResult, rangeStart, rangeEnd, items, processed, printLock);
+                });
 
                 reportProgress();
             }
 
-            jobPool.Join(reportProgress);
+            jobPool.Wait(taskGroup, reportProgress);
 
             for (const auto& itr : containers)
             {
@@ -41,6 +41,10 @@ namespace Imaging
     {
         auto ostream = static_cast<std::ostream*>(png_get_io_ptr(png_ptr));
         ostream->write(reinterpret_cast<const char*>(data), length);
+        if (ostream->fail())
+        {
+            png_error(png_ptr, "Unable to write to the stream.");
+        }
     }
 
     static void PngFlush(png_structp png_ptr)
@@ -163,93 +167,137 @@ namespace Imaging
         }
     }
 
-    static void WritePng(std::ostream& ostream, const Image& image)
+    struct PngWriter::State
     {
-        png_structp png_ptr = nullptr;
-        png_colorp png_palette = nullptr;
-        try
-        {
-            png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
-            if (png_ptr == nullptr)
-            {
-                throw std::runtime_error("png_create_write_struct failed.");
-            }
+        png_structp Png{};
+        png_infop Info{};
+        png_colorp Palette{};
+        uint32_t Height{};
+        uint32_t RowsWritten{};
 
-            png_text text_ptr[1];
-            text_ptr[0].key = const_cast<char*>("Software");
-            text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
-            text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
-
-            auto info_ptr = png_create_info_struct(png_ptr);
-            if (info_ptr == nullptr)
+        ~State()
+        {
+            if (Png != nullptr)
             {
-                throw std::runtime_error("png_create_info_struct failed.");
+                png_free(Png, Palette);
+                png_destroy_write_struct(&Png, &Info);
             }
+        }
+    };
 
-            if (image.Depth == 8)
-            {
-                if (image.Palette == nullptr)
-                {
-                    throw std::runtime_error("Expected a palette for 8-bit image.");
-                }
+    PngWriter::PngWriter(std::ostream& ostream, uint32_t width, uint32_t height, uint32_t depth, const GamePalette* palette)
+        : _state(std::make_unique<State>())
+    {
+        auto& state = *_state;
+        state.Height = height;
+        state.Png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
+        if (state.Png == nullptr)
+        {
+            throw std::runtime_error("png_create_write_struct failed.");
+        }
 
-                // Set the palette
-                png_palette = static_cast<png_colorp>(png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
-                if (png_palette == nullptr)
-                {
-                    throw std::runtime_error("png_malloc failed.");
-                }
-                for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
-                {
-                    const auto& entry = (*image.Palette)[static_cast<uint16_t>(i)];
-                    png_palette[i].blue = entry.Blue;
-                    png_palette[i].green = entry.Green;
-                    png_palette[i].red = entry.Red;
-                }
-                png_set_PLTE(png_ptr, info_ptr, png_palette, PNG_MAX_PALETTE_LENGTH);
-            }
+        png_text text_ptr[1];
+        text_ptr[0].key = const_cast<char*>("Software");
+        text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
+        text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
 
-            png_set_write_fn(png_ptr, &ostream, PngWriteData, PngFlush);
+        state.Info = png_create_info_struct(state.Png);
+        if (state.Info == nullptr)
+        {
+            throw std::runtime_error("png_create_info_struct failed.");
+        }
 
-            // Set error handler
-            if (setjmp(png_jmpbuf(png_ptr)))
+        if (depth == 8)
+        {
+            if (palette == nullptr)
             {
-                throw std::runtime_error("PNG ERROR");
+                throw std::runtime_error("Expected a palette for 8-bit image.");
             }
 
-            // Write header
-            auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
-            if (image.Depth == 8)
+            // Set the palette
+            state.Palette = static_cast<png_colorp>(png_malloc(state.Png, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
+            if (state.Palette == nullptr)
             {
-                png_byte transparentIndex = 0;
-                png_set_tRNS(png_ptr, info_ptr, &transparentIndex, 1, nullptr);
-                colourType = PNG_COLOR_TYPE_PALETTE;
+                throw std::runtime_error("png_malloc failed.");
             }
-            png_set_text(png_ptr, info_ptr, text_ptr, 1);
-            png_set_IHDR(
-                png_ptr, info_ptr, image.Width, image.Height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-                PNG_FILTER_TYPE_DEFAULT);
-            png_write_info(png_ptr, info_ptr);
-
-            // Write pixels
-            auto pixels = image.Pixels.data();
-            for (uint32_t y = 0; y < image.Height; y++)
+            for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
             {
-                png_write_row(png_ptr, const_cast<png_byte*>(pixels));
-                pixels += image.Stride;
+                const auto& entry = (*palette)[static_cast<uint16_t>(i)];
+                state.Palette[i].blue = entry.Blue;
+                state.Palette[i].green = entry.Green;
+                state.Palette[i].red = entry.Red;
             }
+            png_set_PLTE(state.Png, state.Info, state.Palette, PNG_MAX_PALETTE_LENGTH);
+        }
+
+        png_set_write_fn(state.Png, &ostream, PngWriteData, PngFlush);
 
-            png_write_end(png_ptr, nullptr);
-            png_destroy_info_struct(png_ptr, &info_ptr);
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
+        // Set error handler
+        if (setjmp(png_jmpbuf(state.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
         }
-        catch (const std::exception&)
+
+        // Write header
+        auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
+        if (depth == 8)
         {
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
-            throw;
+            png_byte transparentIndex = 0;
+            png_set_tRNS(state.Png, state.Info, &transparentIndex, 1, nullptr);
+            colourType = PNG_COLOR_TYPE_PALETTE;
         }
+        png_set_text(state.Png, state.Info, text_ptr, 1);
+        png_set_IHDR(
+            state.Png, state.Info, width, height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+            PNG_FILTER_TYPE_DEFAULT);
+        png_write_info(state.Png, state.Info);
+    }
+
+    PngWriter::~PngWriter() = default;
+
+    void PngWriter::WriteRows(const uint8_t* pixels, uint32_t count, uint32_t stride)
+    {
+        auto& state = *_state;
+        if (count > state.Height - state.RowsWritten)
+        {
+            throw std::invalid_argument("More rows written than the image has.");
+        }
+
+        // libpng jumps back to the function that called it on errors, so each one needs its own handler
+        if (setjmp(png_jmpbuf(state.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
+
+        for (uint32_t y = 0; y < count; y++)
+        {
+            png_write_row(state.Png, const_cast<png_byte*>(pixels));
+            pixels += stride;
+        }
+        state.RowsWritten += count;
+    }
+
+    void PngWriter::Finish()
+    {
+        auto& state = *_state;
+        if (state.RowsWritten != state.Height)
+        {
+            throw std::logic_error("Not every row of the image has been written.");
+        }
+
+        if (setjmp(png_jmpbuf(state.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
+
+        png_write_end(state.Png, nullptr);
+    }
+
+    static void WritePng(std::ostream& ostream, const Image& image)
+    {
+        PngWriter writer(ostream, image.Width, image.Height, image.Depth, image.Palette.get());
+        writer.WriteRows(image.Pixels.data(), image.Height, image.Stride);
+        writer.Finish();
     }
 
     IMAGE_FORMAT GetImageFormatFromPath(std::string_view path)
@@ -15,6 +15,7 @@
 #include <functional>
 #include <istream>
 #include <memory>
+#include <ostream>
 #include <string_view>
 #include <vector>
 
@@ -52,4 +53,23 @@ namespace Imaging
     void WriteToFile(std::string_view path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
 
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
+
+    /**
+     * Writes a PNG image to a stream a block of rows at a time, so only the rows being written have to be held in
+     * memory. The rows have to be written from top to bottom, and Finish called once all of them have been written.
+     */
+    class PngWriter
+    {
+        struct State;
+        std::unique_ptr<State> _state;
+
+    public:
+        PngWriter(std::ostream& ostream, uint32_t width, uint32_t height, uint32_t depth, const GamePalette* palette);
+        PngWriter(const PngWriter&) = delete;
+        PngWriter& operator=(const PngWriter&) = delete;
+        ~PngWriter();
+
+        void WriteRows(const uint8_t* pixels, uint32_t count, uint32_t stride);
+        void Finish();
+    };
 } // namespace Imaging
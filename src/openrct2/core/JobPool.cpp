@@ -9,13 +9,81 @@
 
 #include "JobPool.h"
 
-#include <algorithm>
 #include <cassert>
+#include <chrono>
 
-JobPool::TaskData::TaskData(std::function<void()> workFn, std::function<void()> completionFn)
-    : WorkFn(workFn)
-    , CompletionFn(completionFn)
+#ifndef _WIN32
+#    include <pthread.h>
+#endif
+
+// Attempts to find a task before a thread goes to sleep
+static constexpr int32_t SpinCount = 64;
+
+JobPool::TaskQueue::TaskQueue()
+    : _cells(std::make_unique<Cell[]>(Capacity))
+{
+    for (size_t i = 0; i < Capacity; i++)
+    {
+        _cells[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool JobPool::TaskQueue::TryPush(Task& task)
 {
+    auto pos = _enqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& cell = _cells[pos & (Capacity - 1)];
+        const auto sequence = cell.Sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.Data = std::move(task);
+                cell.Sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Full
+            return false;
+        }
+        else
+        {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool JobPool::TaskQueue::TryPop(Task& task)
+{
+    auto pos = _dequeuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& cell = _cells[pos & (Capacity - 1)];
+        const auto sequence = cell.Sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                task = std::move(cell.Data);
+                cell.Sequence.store(pos + Capacity, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Empty, or the task at the front is still being pushed
+            return false;
+        }
+        else
+        {
+            pos = _dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
 }
 
 JobPool::JobPool(size_t maxThreads)
@@ -42,84 +110,159 @@ JobPool::~JobPool()
     }
 }
 
-void JobPool::AddTask(std::function<void()> workFn, std::function<void()> completionFn)
+// The pool returned by Get, created on first use
+static std::unique_ptr<JobPool> _sharedPool;
+static std::mutex _sharedPoolMutex;
+
+#ifndef _WIN32
+static void LockSharedPool()
 {
-    unique_lock lock(_mutex);
-    _pending.emplace_back(workFn, completionFn);
-    _condPending.notify_one();
+    _sharedPoolMutex.lock();
 }
 
-void JobPool::Join(std::function<void()> reportFn)
+static void UnlockSharedPool()
 {
-    unique_lock lock(_mutex);
-    while (true)
-    {
-        // Wait for the queue to become empty or having completed tasks.
-        _condComplete.wait(lock, [this]() { return (_pending.empty() && _processing == 0) || !_completed.empty(); });
+    _sharedPoolMutex.unlock();
+}
+
+/**
+ * The worker threads of the pool do not exist in a forked child, while their state says otherwise, so the child gets
+ * a new pool on first use. The old one can not be destroyed without its threads and is left behind.
+ */
+static void ForgetSharedPoolInChild()
+{
+    static_cast<void>(_sharedPool.release());
+    _sharedPoolMutex.unlock();
+}
+#endif
 
-        // Dispatch all completion callbacks if there are any.
-        while (!_completed.empty())
+JobPool& JobPool::Get()
+{
+    std::lock_guard<std::mutex> lock(_sharedPoolMutex);
+    if (_sharedPool == nullptr)
+    {
+#ifndef _WIN32
+        static bool forkHandlersRegistered = false;
+        if (!forkHandlersRegistered)
         {
-            auto taskData = _completed.front();
-            _completed.pop_front();
+            pthread_atfork(LockSharedPool, UnlockSharedPool, ForgetSharedPoolInChild);
+            forkHandlersRegistered = true;
+        }
+#endif
+        _sharedPool = std::make_unique<JobPool>(std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1);
+    }
+    return *_sharedPool;
+}
 
-            if (taskData.CompletionFn)
-            {
-                lock.unlock();
+size_t JobPool::GetThreadCount() const
+{
+    return _threads.size() + 1;
+}
 
-                taskData.CompletionFn();
+void JobPool::Push(Task&& task)
+{
+    _queued.fetch_add(1);
+    if (!_queue.TryPush(task))
+    {
+        // The queue is full, the task is run straight away instead
+        _queued.fetch_sub(1);
+        auto& group = *task.Group;
+        task.Invoke();
+        task.Reset();
+        FinishTask(group);
+        return;
+    }
 
-                lock.lock();
-            }
-        }
+    if (_sleepingWorkers.load() > 0)
+    {
+        unique_lock lock(_mutex);
+        _condPending.notify_one();
+    }
+}
 
-        if (reportFn)
-        {
-            lock.unlock();
+bool JobPool::RunPendingTask()
+{
+    Task task;
+    if (!_queue.TryPop(task))
+        return false;
 
-            reportFn();
+    _queued.fetch_sub(1);
+    auto& group = *task.Group;
+    task.Invoke();
+    task.Reset();
+    FinishTask(group);
+    return true;
+}
 
-            lock.lock();
+void JobPool::FinishTask(TaskGroup& group)
+{
+    if (group._pending.fetch_sub(1) == 1 && _waitingThreads.load() > 0)
+    {
+        unique_lock lock(_mutex);
+        _condComplete.notify_all();
+    }
+}
+
+void JobPool::Wait(TaskGroup& group, const std::function<void()>& reportFn)
+{
+    while (!group.IsDone())
+    {
+        if (RunPendingTask())
+        {
+            if (reportFn)
+            {
+                reportFn();
+            }
+            continue;
         }
 
-        // If everything is empty and no more work has to be done we can stop waiting.
-        if (_completed.empty() && _pending.empty() && _processing == 0)
+        // The remaining tasks of the group are running on other threads
+        unique_lock lock(_mutex);
+        _waitingThreads++;
+        _condComplete.wait_for(lock, std::chrono::milliseconds(reportFn ? 100 : 1), [this, &group]() {
+            return group.IsDone() || _queued.load() > 0;
+        });
+        _waitingThreads--;
+        lock.unlock();
+
+        if (reportFn)
         {
-            break;
+            reportFn();
         }
     }
 }
 
-size_t JobPool::CountPending()
+void JobPool::Join(const std::function<void()>& reportFn)
 {
-    return _pending.size();
+    Wait(_defaultGroup, reportFn);
+}
+
+size_t JobPool::CountPending() const
+{
+    return _queued.load();
 }
 
 void JobPool::ProcessQueue()
 {
-    unique_lock lock(_mutex);
-    do
+    int32_t spins = 0;
+    while (!_shouldStop)
     {
-        // Wait for work or cancellation.
-        _condPending.wait(lock, [this]() { return _shouldStop || !_pending.empty(); });
-
-        if (!_pending.empty())
+        if (RunPendingTask())
         {
-            _processing++;
-
-            auto taskData = _pending.front();
-            _pending.pop_front();
-
-            lock.unlock();
-
-            taskData.WorkFn();
-
-            lock.lock();
-
-            _completed.push_back(std::move(taskData));
-
-            _processing--;
-            _condComplete.notify_one();
+            spins = 0;
+            continue;
         }
-    } while (!_shouldStop);
+        if (++spins < SpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Push checks for sleeping workers after adding to _queued, so either it sees this one or this one sees the task
+        unique_lock lock(_mutex);
+        _sleepingWorkers++;
+        _condPending.wait(lock, [this]() { return _shouldStop || _queued.load() > 0; });
+        _sleepingWorkers--;
+        spins = 0;
+    }
 }
@@ -9,33 +9,196 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+/**
+ * A fixed set of worker threads taking tasks from a lock-free queue. Tasks are added to a task group, which can be
+ * waited for. The waiting thread runs queued tasks itself until the group is done, so tasks can add and wait for
+ * tasks of their own, and a pool without worker threads still gets everything done.
+ *
+ * Callables up to InlineTaskSize bytes are stored in the queue itself, larger ones are moved to the heap.
+ */
 class JobPool
 {
+public:
+    static constexpr size_t InlineTaskSize = 48;
+
+    class TaskGroup
+    {
+        friend class JobPool;
+
+        std::atomic<size_t> _pending{};
+
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        bool IsDone() const
+        {
+            return _pending.load(std::memory_order_acquire) == 0;
+        }
+    };
+
 private:
-    struct TaskData
+    class Task
+    {
+        enum class Operation
+        {
+            Invoke,
+            MoveTo,
+            Destroy,
+        };
+
+        using Manager = void (*)(Operation, Task&, Task*);
+
+        alignas(std::max_align_t) unsigned char _storage[InlineTaskSize];
+        Manager _manager{};
+
+        template<typename TFunc> static void ManageInline(Operation operation, Task& task, Task* target)
+        {
+            auto* func = std::launder(reinterpret_cast<TFunc*>(task._storage));
+            switch (operation)
+            {
+                case Operation::Invoke:
+                    (*func)();
+                    break;
+                case Operation::MoveTo:
+                    new (target->_storage) TFunc(std::move(*func));
+                    func->~TFunc();
+                    break;
+                case Operation::Destroy:
+                    func->~TFunc();
+                    break;
+            }
+        }
+
+        template<typename TFunc> static void ManageHeap(Operation operation, Task& task, Task* target)
+        {
+            auto** func = std::launder(reinterpret_cast<TFunc**>(task._storage));
+            switch (operation)
+            {
+                case Operation::Invoke:
+                    (**func)();
+                    break;
+                case Operation::MoveTo:
+                    new (target->_storage) TFunc*(*func);
+                    break;
+                case Operation::Destroy:
+                    delete *func;
+                    break;
+            }
+        }
+
+    public:
+        TaskGroup* Group{};
+
+        Task() = default;
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        template<typename TFunc> Task(TaskGroup& group, TFunc&& func)
+            : Group(&group)
+        {
+            using TDecayed = std::decay_t<TFunc>;
+            if constexpr (
+                sizeof(TDecayed) <= InlineTaskSize && alignof(TDecayed) <= alignof(std::max_align_t)
+                && std::is_nothrow_move_constructible_v<TDecayed>)
+            {
+                new (_storage) TDecayed(std::forward<TFunc>(func));
+                _manager = &ManageInline<TDecayed>;
+            }
+            else
+            {
+                new (_storage) TDecayed*(new TDecayed(std::forward<TFunc>(func)));
+                _manager = &ManageHeap<TDecayed>;
+            }
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                if (other._manager != nullptr)
+                {
+                    other._manager(Operation::MoveTo, other, this);
+                    _manager = other._manager;
+                    other._manager = nullptr;
+                }
+                Group = other.Group;
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            Reset();
+        }
+
+        void Invoke()
+        {
+            _manager(Operation::Invoke, *this, nullptr);
+        }
+
+        void Reset()
+        {
+            if (_manager != nullptr)
+            {
+                _manager(Operation::Destroy, *this, nullptr);
+                _manager = nullptr;
+            }
+        }
+    };
+
+    /**
+     * Bounded multi-producer multi-consumer queue, each cell carries a sequence number telling producers and consumers
+     * whose turn it is.
+     */
+    class TaskQueue
     {
-        const std::function<void()> WorkFn;
-        const std::function<void()> CompletionFn;
+        struct Cell
+        {
+            std::atomic<size_t> Sequence;
+            Task Data;
+        };
+
+        static constexpr size_t Capacity = 1024;
 
-        TaskData(std::function<void()> workFn, std::function<void()> completionFn);
+        std::unique_ptr<Cell[]> _cells;
+        alignas(64) std::atomic<size_t> _enqueuePos{};
+        alignas(64) std::atomic<size_t> _dequeuePos{};
+
+    public:
+        TaskQueue();
+
+        bool TryPush(Task& task);
+        bool TryPop(Task& task);
     };
 
     std::atomic_bool _shouldStop = { false };
-    std::atomic<size_t> _processing = { 0 };
     std::vector<std::thread> _threads;
-    std::deque<TaskData> _pending;
-    std::deque<TaskData> _completed;
+    TaskQueue _queue;
+    // Tasks pushed, or about to be, and not popped yet
+    std::atomic<size_t> _queued{};
+    std::atomic<size_t> _sleepingWorkers{};
+    std::atomic<size_t> _waitingThreads{};
     std::condition_variable _condPending;
     std::condition_variable _condComplete;
     std::mutex _mutex;
+    // Group of the tasks added without one, see AddTask and Join
+    TaskGroup _defaultGroup;
 
     using unique_lock = std::unique_lock<std::mutex>;
 
@@ -43,10 +206,71 @@ public:
     JobPool(size_t maxThreads = 255);
     ~JobPool();
 
-    void AddTask(std::function<void()> workFn, std::function<void()> completionFn = nullptr);
-    void Join(std::function<void()> reportFn = nullptr);
-    size_t CountPending();
+    /**
+     * The pool shared by the whole game, with a worker thread for each core but the one of the thread waiting for
+     * the tasks. A process forked while the pool exists gets a pool of its own.
+     */
+    static JobPool& Get();
+
+    /**
+     * Number of threads running tasks while a group is being waited for, including the waiting one.
+     */
+    size_t GetThreadCount() const;
+
+    template<typename TFunc> void AddTask(TaskGroup& group, TFunc&& func)
+    {
+        group._pending.fetch_add(1, std::memory_order_relaxed);
+        Push(Task(group, std::forward<TFunc>(func)));
+    }
+
+    template<typename TFunc> void AddTask(TFunc&& func)
+    {
+        AddTask(_defaultGroup, std::forward<TFunc>(func));
+    }
+
+    /**
+     * Runs queued tasks until every task of the group has finished. reportFn, if set, is called in between.
+     */
+    void Wait(TaskGroup& group, const std::function<void()>& reportFn = nullptr);
+
+    /**
+     * Waits for the tasks added without a group.
+     */
+    void Join(const std::function<void()>& reportFn = nullptr);
+
+    size_t CountPending() const;
+
+    /**
+     * Calls func for each index below count, in chunks of chunkSize indices per task. A chunk size of 0 picks one that
+     * gives each thread a few chunks.
+     */
+    template<typename TFunc> void ParallelFor(size_t count, TFunc&& func, size_t chunkSize = 0)
+    {
+        if (count == 0)
+            return;
+
+        if (chunkSize == 0)
+        {
+            chunkSize = std::max<size_t>(1, count / (GetThreadCount() * 4));
+        }
+
+        TaskGroup group;
+        for (size_t begin = 0; begin < count; begin += chunkSize)
+        {
+            const auto end = std::min(count, begin + chunkSize);
+            AddTask(group, [&func, begin, end]() {
+                for (size_t i = begin; i < end; i++)
+                {
+                    func(i);
+                }
+            });
+        }
+        Wait(group);
+    }
 
 private:
+    void Push(Task&& task);
+    bool RunPendingTask();
+    void FinishTask(TaskGroup& group);
     void ProcessQueue();
 };
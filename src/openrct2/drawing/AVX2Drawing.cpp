@@ -42,6 +42,85 @@ void mask_avx2(
     }
 }
 
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, const uint8_t* indices, uint8_t* dst, const uint8_t* RESTRICT paletteMap, int32_t count)
+{
+    const __m256i zero = {};
+    // Gathers read four bytes, so lookups of the last entries read from entry 252 and shift the value down
+    const __m256i lastGatherIndex = _mm256_set1_epi32(252);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    // Undoes the interleaving of the two 128 bit lanes by the packs
+    const __m256i packOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    int32_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i remapped[4];
+        for (int32_t part = 0; part < 4; part++)
+        {
+            const __m256i index = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + i + part * 8)));
+            const __m256i gatherIndex = _mm256_min_epu32(index, lastGatherIndex);
+            const __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(paletteMap), gatherIndex, 1);
+            const __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(index, gatherIndex), 3);
+            remapped[part] = _mm256_and_si256(_mm256_srlv_epi32(words, shift), byteMask);
+        }
+        const __m256i words01 = _mm256_packus_epi32(remapped[0], remapped[1]);
+        const __m256i words23 = _mm256_packus_epi32(remapped[2], remapped[3]);
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words01, words23), packOrder);
+
+        const __m256i source = _mm256_lddqu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i dest = _mm256_lddqu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i keep = _mm256_or_si256(_mm256_cmpeq_epi8(source, zero), _mm256_cmpeq_epi8(packed, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(packed, dest, keep));
+    }
+    rle_remap_scalar(src + i, indices + i, dst + i, paletteMap, count - i);
+}
+
+void rle_blend_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT blendMaps, int32_t numMaps, int32_t count)
+{
+    const __m256i zero = {};
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i mapCount = _mm256_set1_epi32(numMaps);
+    // Gathers read four bytes, so lookups of the last entries read from four bytes before the end and shift the value
+    // down
+    const __m256i lastGatherIndex = _mm256_set1_epi32(numMaps * 256 - 4);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    // Undoes the interleaving of the two 128 bit lanes by the packs
+    const __m256i packOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    int32_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i blended[4];
+        for (int32_t part = 0; part < 4; part++)
+        {
+            const __m256i source = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i + part * 8)));
+            const __m256i dest = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(dst + i + part * 8)));
+            // Transparent pixels and pixels without a map are not looked up and come out as 0, which is left alone
+            const __m256i hasMap = _mm256_andnot_si256(
+                _mm256_cmpgt_epi32(source, mapCount), _mm256_cmpgt_epi32(source, zero));
+            const __m256i index = _mm256_add_epi32(_mm256_slli_epi32(_mm256_sub_epi32(source, one), 8), dest);
+            const __m256i gatherIndex = _mm256_and_si256(_mm256_min_epi32(index, lastGatherIndex), hasMap);
+            const __m256i words = _mm256_mask_i32gather_epi32(
+                zero, reinterpret_cast<const int*>(blendMaps), gatherIndex, hasMap, 1);
+            const __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(index, gatherIndex), 3);
+            blended[part] = _mm256_and_si256(_mm256_srlv_epi32(words, shift), byteMask);
+        }
+        const __m256i words01 = _mm256_packus_epi32(blended[0], blended[1]);
+        const __m256i words23 = _mm256_packus_epi32(blended[2], blended[3]);
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words01, words23), packOrder);
+
+        const __m256i dest = _mm256_lddqu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i keep = _mm256_cmpeq_epi8(packed, zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(packed, dest, keep));
+    }
+    rle_blend_scalar(src + i, dst + i, blendMaps, numMaps, count - i);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +134,16 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, const uint8_t* indices, uint8_t* dst, const uint8_t* RESTRICT paletteMap, int32_t count)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void rle_blend_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT blendMaps, int32_t numMaps, int32_t count)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
 #endif // __AVX2__
@@ -12,6 +12,42 @@
 #include <algorithm>
 #include <cstring>
 
+// Shorter runs are remapped one pixel at a time, as setting up the vectorised remap costs more than it saves
+static constexpr int32_t MinVectorisedRunLength = 16;
+
+void rle_remap_scalar(
+    const uint8_t* RESTRICT src, const uint8_t* indices, uint8_t* dst, const uint8_t* RESTRICT paletteMap, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (src[i] == 0)
+            continue;
+
+        auto pixel = paletteMap[indices[i]];
+        if (pixel != 0)
+        {
+            dst[i] = pixel;
+        }
+    }
+}
+
+void rle_blend_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT blendMaps, int32_t numMaps, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        const int32_t map = src[i] - 1;
+        if (map < 0 || map >= numMaps)
+            continue;
+
+        auto pixel = blendMaps[map * 256 + dst[i]];
+        if (pixel != 0)
+        {
+            dst[i] = pixel;
+        }
+    }
+}
+
 template<DrawBlendOp TBlendOp, size_t TZoom>
 static void FASTCALL DrawRLESpriteMagnify(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args)
 {
@@ -166,6 +202,31 @@ static void FASTCALL DrawRLESpriteMinify(rct_drawpixelinfo& dpi, const DrawSprit
             else
             {
                 auto& paletteMap = args.PalMap;
+                if constexpr (
+                    TZoom == 0 && (TBlendOp & BLEND_TRANSPARENT) != 0
+                    && ((TBlendOp & BLEND_SRC) != 0) != ((TBlendOp & BLEND_DST) != 0))
+                {
+                    // Runs are contiguous at this zoom level, so a remap of either the source or the destination, or a
+                    // blend of both, can be done for many pixels at once
+                    const auto* table = paletteMap.GetTable();
+                    if (numPixels >= MinVectorisedRunLength && table != nullptr)
+                    {
+                        const auto* indices = (TBlendOp & BLEND_SRC) != 0 ? src : dst;
+                        rle_remap_fn(src, indices, dst, table, numPixels);
+                        continue;
+                    }
+                }
+                else if constexpr (
+                    TZoom == 0 && (TBlendOp & BLEND_TRANSPARENT) != 0 && (TBlendOp & BLEND_SRC) != 0
+                    && (TBlendOp & BLEND_DST) != 0)
+                {
+                    const auto* blendMaps = paletteMap.GetBlendTable();
+                    if (numPixels >= MinVectorisedRunLength && blendMaps != nullptr)
+                    {
+                        rle_blend_fn(src, dst, blendMaps, paletteMap.GetNumMaps(), numPixels);
+                        continue;
+                    }
+                }
                 while (numPixels > 0)
                 {
                     BlitPixel<TBlendOp>(src, dst, paletteMap);
@@ -16,6 +16,7 @@
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
 #include "../object/Object.h"
+#include "../paint/PaintCache.h"
 #include "../platform/Platform.h"
 #include "../sprites.h"
 #include "../util/Util.h"
@@ -558,22 +559,37 @@ void (*mask_fn)(
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap)
     = nullptr;
 
+void (*rle_remap_fn)(
+    const uint8_t* RESTRICT src, const uint8_t* indices, uint8_t* dst, const uint8_t* RESTRICT paletteMap, int32_t count)
+    = rle_remap_scalar;
+
+void (*rle_blend_fn)(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT blendMaps, int32_t numMaps, int32_t count)
+    = rle_blend_scalar;
+
 void mask_init()
 {
     if (avx2_available())
     {
-        log_verbose("registering AVX2 mask function");
+        log_verbose("registering AVX2 mask and RLE remap functions");
         mask_fn = mask_avx2;
+        rle_remap_fn = rle_remap_avx2;
+        rle_blend_fn = rle_blend_avx2;
     }
     else if (sse41_available())
     {
-        log_verbose("registering SSE4.1 mask function");
+        // Without gathers, looking up the palette map is no faster than the scalar remap
+        log_verbose("registering SSE4.1 mask and scalar RLE remap functions");
         mask_fn = mask_sse4_1;
+        rle_remap_fn = rle_remap_scalar;
+        rle_blend_fn = rle_blend_scalar;
     }
     else
     {
-        log_verbose("registering scalar mask function");
+        log_verbose("registering scalar mask and RLE remap functions");
         mask_fn = mask_scalar;
+        rle_remap_fn = rle_remap_scalar;
+        rle_blend_fn = rle_blend_scalar;
     }
 }
 
@@ -657,6 +673,7 @@ void load_palette()
  */
 void gfx_invalidate_screen()
 {
+    PaintCache::Get().Invalidate();
     gfx_set_dirty_blocks({ { 0, 0 }, { context_get_width(), context_get_height() } });
 }
 
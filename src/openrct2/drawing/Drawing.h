@@ -329,10 +329,7 @@ struct PaletteMap
 private:
     uint8_t* _data{};
     uint32_t _dataLength{};
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wunused-private-field"
     uint16_t _numMaps;
-#pragma clang diagnostic pop
     uint16_t _mapLength;
 
 public:
@@ -360,6 +357,28 @@ public:
     uint8_t& operator[](size_t index);
     uint8_t operator[](size_t index) const;
     uint8_t Blend(uint8_t src, uint8_t dst) const;
+
+    /**
+     * Returns the entries of the map for direct lookups of any pixel value, or nullptr if it has fewer than 256.
+     */
+    const uint8_t* GetTable() const
+    {
+        return _dataLength >= 256 ? _data : nullptr;
+    }
+
+    /**
+     * Returns the maps for direct lookups of Blend, or nullptr unless every map has 256 entries.
+     */
+    const uint8_t* GetBlendTable() const
+    {
+        return _mapLength == 256 ? _data : nullptr;
+    }
+
+    uint16_t GetNumMaps() const
+    {
+        return _numMaps;
+    }
+
     void Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length);
 };
 
@@ -596,9 +615,31 @@ void mask_avx2(
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 void mask_init();
 
+/**
+ * Remaps a run of pixels: every pixel of dst whose src pixel is not transparent is set to paletteMap[indices[i]],
+ * unless that is 0. indices is either src or dst itself. paletteMap must hold 256 entries.
+ */
+void rle_remap_scalar(
+    const uint8_t* RESTRICT src, const uint8_t* indices, uint8_t* dst, const uint8_t* RESTRICT paletteMap, int32_t count);
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, const uint8_t* indices, uint8_t* dst, const uint8_t* RESTRICT paletteMap, int32_t count);
+
+/**
+ * Blends a run of pixels: every pixel of dst whose src pixel is not transparent is set to
+ * blendMaps[(src[i] - 1) * 256 + dst[i]], unless that is 0 or there is no map for src[i], like PaletteMap::Blend.
+ */
+void rle_blend_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT blendMaps, int32_t numMaps, int32_t count);
+void rle_blend_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT blendMaps, int32_t numMaps, int32_t count);
+
 extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
+extern void (*rle_remap_fn)(
+    const uint8_t* RESTRICT src, const uint8_t* indices, uint8_t* dst, const uint8_t* RESTRICT paletteMap, int32_t count);
+extern void (*rle_blend_fn)(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT blendMaps, int32_t numMaps, int32_t count);
 
 std::optional<uint32_t> GetPaletteG1Index(colour_t paletteId);
 std::optional<PaletteMap> GetPaletteMapForColour(colour_t paletteId);
@@ -25,6 +25,12 @@ uint16_t GetMiscEntityCount();
 uint16_t GetNumFreeEntities();
 const std::vector<EntityId>& GetEntityTileList(const CoordsXY& spritePos);
 
+/**
+ * Returns the litter in the blocks of tiles that overlap the given range around the location. The litter is not sorted
+ * and may lie further away than the range, callers still have to check the distance.
+ */
+std::vector<EntityId> GetLitterInRange(const CoordsXY& loc, int32_t range);
+
 template<typename T> class EntityTileIterator
 {
 private:
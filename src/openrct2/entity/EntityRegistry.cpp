@@ -25,13 +25,17 @@
 #include "../scenario/Scenario.h"
 #include "Balloon.h"
 #include "Duck.h"
+#include "GuestNeeds.h"
+#include "Litter.h"
 #include "EntityTweener.h"
 #include "Fountain.h"
 #include "MoneyEffect.h"
 #include "Particle.h"
+#include "PatrolArea.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iterator>
 #include <numeric>
 #include <vector>
@@ -57,6 +61,15 @@ constexpr const uint32_t SPATIAL_INDEX_LOCATION_NULL = SPATIAL_INDEX_SIZE - 1;
 
 static std::array<std::vector<EntityId>, SPATIAL_INDEX_SIZE> gEntitySpatialIndex;
 
+// Litter is also bucketed by blocks of tiles, so handymen only have to look at the litter around them
+constexpr const int32_t LITTER_INDEX_BLOCK_SIZE = 4;
+constexpr const int32_t LITTER_INDEX_BLOCKS_PER_LINE = (MAXIMUM_MAP_SIZE_TECHNICAL + LITTER_INDEX_BLOCK_SIZE - 1)
+    / LITTER_INDEX_BLOCK_SIZE;
+constexpr const uint32_t LITTER_INDEX_SIZE = (LITTER_INDEX_BLOCKS_PER_LINE * LITTER_INDEX_BLOCKS_PER_LINE) + 1;
+constexpr const uint32_t LITTER_INDEX_LOCATION_NULL = LITTER_INDEX_SIZE - 1;
+
+static std::array<std::vector<EntityId>, LITTER_INDEX_SIZE> gLitterBlockIndex;
+
 static void FreeEntity(EntityBase& entity);
 
 static constexpr size_t GetSpatialIndexOffset(const CoordsXY& loc)
@@ -74,6 +87,19 @@ static constexpr size_t GetSpatialIndexOffset(const CoordsXY& loc)
     return tileX * MAXIMUM_MAP_SIZE_TECHNICAL + tileY;
 }
 
+static constexpr size_t GetLitterIndexOffset(const CoordsXY& loc)
+{
+    if (loc.IsNull() || loc.x < 0 || loc.y < 0)
+        return LITTER_INDEX_LOCATION_NULL;
+
+    const auto blockX = loc.x / (COORDS_XY_STEP * LITTER_INDEX_BLOCK_SIZE);
+    const auto blockY = loc.y / (COORDS_XY_STEP * LITTER_INDEX_BLOCK_SIZE);
+    if (blockX >= LITTER_INDEX_BLOCKS_PER_LINE || blockY >= LITTER_INDEX_BLOCKS_PER_LINE)
+        return LITTER_INDEX_LOCATION_NULL;
+
+    return blockX * LITTER_INDEX_BLOCKS_PER_LINE + blockY;
+}
+
 constexpr bool EntityTypeIsMiscEntity(const EntityType type)
 {
     switch (type)
@@ -139,6 +165,25 @@ const std::vector<EntityId>& GetEntityTileList(const CoordsXY& spritePos)
     return gEntitySpatialIndex[GetSpatialIndexOffset(spritePos)];
 }
 
+std::vector<EntityId> GetLitterInRange(const CoordsXY& loc, int32_t range)
+{
+    std::vector<EntityId> result;
+    constexpr auto blockSize = COORDS_XY_STEP * LITTER_INDEX_BLOCK_SIZE;
+    const auto firstBlockX = std::max(loc.x - range, 0) / blockSize;
+    const auto firstBlockY = std::max(loc.y - range, 0) / blockSize;
+    const auto lastBlockX = std::min((loc.x + range) / blockSize, LITTER_INDEX_BLOCKS_PER_LINE - 1);
+    const auto lastBlockY = std::min((loc.y + range) / blockSize, LITTER_INDEX_BLOCKS_PER_LINE - 1);
+    for (auto blockX = firstBlockX; blockX <= lastBlockX; blockX++)
+    {
+        for (auto blockY = firstBlockY; blockY <= lastBlockY; blockY++)
+        {
+            const auto& block = gLitterBlockIndex[blockX * LITTER_INDEX_BLOCKS_PER_LINE + blockY];
+            result.insert(result.end(), block.begin(), block.end());
+        }
+    }
+    return result;
+}
+
 static void ResetEntityLists()
 {
     for (auto& list : gEntityLists)
@@ -172,6 +217,8 @@ const std::list<EntityId>& GetEntityList(const EntityType id)
 void ResetAllEntities()
 {
     gSavedAge = 0;
+    GuestNeeds::Get().Invalidate();
+    Litter::ResetAges();
 
     // Free all associated Entity pointers prior to zeroing memory
     for (int32_t i = 0; i < MAX_ENTITIES; ++i)
@@ -204,6 +251,101 @@ void ResetAllEntities()
     ResetEntitySpatialIndices();
 }
 
+EntitiesCheckpoint CreateEntitiesCheckpoint()
+{
+    EntitiesCheckpoint checkpoint;
+    for (EntityId::UnderlyingType i = 0; i < MAX_ENTITIES; i++)
+    {
+        const auto& entity = _entities[i];
+        if (entity.base.Type == EntityType::Null)
+            continue;
+
+        const auto id = EntityId::FromUnderlying(i);
+        checkpoint.Ids.push_back(id);
+        const auto* data = reinterpret_cast<const uint8_t*>(&entity);
+        checkpoint.Data.insert(checkpoint.Data.end(), data, data + sizeof(Entity));
+
+        auto* peep = entity.base.As<Peep>();
+        if (peep != nullptr && peep->Name != nullptr)
+        {
+            checkpoint.Names.emplace_back(id, peep->Name);
+        }
+        auto* staff = entity.base.As<Staff>();
+        if (staff != nullptr && staff->PatrolInfo != nullptr)
+        {
+            checkpoint.PatrolAreas.emplace_back(id, staff->PatrolInfo->ToVector());
+        }
+
+        if (_entityFlashingList[i])
+        {
+            checkpoint.Flashing.push_back(id);
+        }
+    }
+    checkpoint.Lists = gEntityLists;
+    checkpoint.FreeIds = _freeIdList;
+    checkpoint.RideHistory = OpenRCT2::RideUse::GetHistory();
+    checkpoint.RideTypeHistory = OpenRCT2::RideUse::GetTypeHistory();
+    return checkpoint;
+}
+
+void RestoreEntitiesCheckpoint(const EntitiesCheckpoint& checkpoint)
+{
+    GuestNeeds::Get().Invalidate();
+    Litter::ResetAges();
+
+    // Only the entities in use are touched, clearing the whole array would cost more than the copy itself
+    for (EntityId::UnderlyingType i = 0; i < MAX_ENTITIES; i++)
+    {
+        auto& entity = _entities[i];
+        if (entity.base.Type == EntityType::Null)
+            continue;
+
+        FreeEntity(entity.base);
+        entity = Entity();
+        entity.base.Type = EntityType::Null;
+        entity.base.sprite_index = EntityId::FromUnderlying(i);
+        _entityFlashingList[i] = false;
+    }
+
+    for (size_t i = 0; i < checkpoint.Ids.size(); i++)
+    {
+        auto& entity = _entities[checkpoint.Ids[i].ToUnderlying()];
+        std::memcpy(&entity, checkpoint.Data.data() + (i * sizeof(Entity)), sizeof(Entity));
+
+        auto* peep = entity.base.As<Peep>();
+        if (peep != nullptr)
+        {
+            peep->Name = nullptr;
+        }
+        auto* staff = entity.base.As<Staff>();
+        if (staff != nullptr)
+        {
+            staff->PatrolInfo = nullptr;
+        }
+    }
+    for (const auto& [id, name] : checkpoint.Names)
+    {
+        GetEntity<Peep>(id)->SetName(name);
+    }
+    for (const auto& [id, tiles] : checkpoint.PatrolAreas)
+    {
+        auto* staff = GetEntity<Staff>(id);
+        staff->PatrolInfo = new PatrolArea();
+        staff->PatrolInfo->Union(tiles);
+    }
+    for (auto id : checkpoint.Flashing)
+    {
+        _entityFlashingList[id.ToUnderlying()] = true;
+    }
+
+    gEntityLists = checkpoint.Lists;
+    _freeIdList = checkpoint.FreeIds;
+    OpenRCT2::RideUse::GetHistory() = checkpoint.RideHistory;
+    OpenRCT2::RideUse::GetTypeHistory() = checkpoint.RideTypeHistory;
+    ResetEntitySpatialIndices();
+    UpdateConsolidatedPatrolAreas();
+}
+
 static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc);
 
 /**
@@ -218,6 +360,10 @@ void ResetEntitySpatialIndices()
     {
         vec.clear();
     }
+    for (auto& vec : gLitterBlockIndex)
+    {
+        vec.clear();
+    }
     for (EntityId::UnderlyingType i = 0; i < MAX_ENTITIES; i++)
     {
         auto* spr = GetEntity(EntityId::FromUnderlying(i));
@@ -416,6 +562,13 @@ static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc)
     auto& spatialVector = gEntitySpatialIndex[newIndex];
     auto index = std::lower_bound(std::begin(spatialVector), std::end(spatialVector), entity->sprite_index);
     spatialVector.insert(index, entity->sprite_index);
+
+    if (entity->Type == EntityType::Litter)
+    {
+        auto& litterVector = gLitterBlockIndex[GetLitterIndexOffset(newLoc)];
+        auto litterIndex = std::lower_bound(std::begin(litterVector), std::end(litterVector), entity->sprite_index);
+        litterVector.insert(litterIndex, entity->sprite_index);
+    }
 }
 
 static void EntitySpatialRemove(EntityBase* entity)
@@ -431,6 +584,17 @@ static void EntitySpatialRemove(EntityBase* entity)
     {
         log_warning("Bad sprite spatial index. Rebuilding the spatial index...");
         ResetEntitySpatialIndices();
+        return;
+    }
+
+    if (entity->Type == EntityType::Litter)
+    {
+        auto& litterVector = gLitterBlockIndex[GetLitterIndexOffset({ entity->x, entity->y })];
+        auto litterIndex = binary_find(std::begin(litterVector), std::end(litterVector), entity->sprite_index);
+        if (litterIndex != std::end(litterVector))
+        {
+            litterVector.erase(litterIndex, litterIndex + 1);
+        }
     }
 }
 
@@ -491,6 +655,7 @@ static void FreeEntity(EntityBase& entity)
 {
     auto* guest = entity.As<Guest>();
     auto* staff = entity.As<Staff>();
+    auto* litter = entity.As<Litter>();
     if (staff != nullptr)
     {
         staff->SetName({});
@@ -499,9 +664,14 @@ static void FreeEntity(EntityBase& entity)
     else if (guest != nullptr)
     {
         guest->SetName({});
+        GuestNeeds::Get().Remove(guest->sprite_index);
         OpenRCT2::RideUse::GetHistory().RemoveHandle(guest->sprite_index);
         OpenRCT2::RideUse::GetTypeHistory().RemoveHandle(guest->sprite_index);
     }
+    else if (litter != nullptr)
+    {
+        Litter::ForgetAge(*litter);
+    }
 }
 
 /**
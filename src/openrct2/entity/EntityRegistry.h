@@ -10,9 +10,14 @@
 #pragma once
 
 #include "../common.h"
+#include "../peep/RideUseSystem.h"
 #include "EntityBase.h"
 
 #include <array>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
 
 constexpr uint16_t MAX_ENTITIES = 65535;
 
@@ -64,5 +69,32 @@ struct EntitiesChecksum
 #pragma pack(pop)
 EntitiesChecksum GetAllEntitiesChecksum();
 
+/**
+ * A copy of all entities that are in use, see CreateEntitiesCheckpoint.
+ */
+struct EntitiesCheckpoint
+{
+    // The raw memory of each entity in Ids, one after the other
+    std::vector<EntityId> Ids;
+    std::vector<uint8_t> Data;
+
+    // Memory owned by entities is copied separately, the pointers in Data are not used
+    std::vector<std::pair<EntityId, std::string>> Names;
+    std::vector<std::pair<EntityId, std::vector<TileCoordsXY>>> PatrolAreas;
+
+    std::array<std::list<EntityId>, EnumValue(EntityType::Count)> Lists;
+    std::vector<EntityId> FreeIds;
+    std::vector<EntityId> Flashing;
+    OpenRCT2::RideUse::RideHistory RideHistory;
+    OpenRCT2::RideUse::RideTypeHistory RideTypeHistory;
+};
+
+/**
+ * Copies all entities so they can be put back with RestoreEntitiesCheckpoint, which frees the entities created in the
+ * meantime and rebuilds the spatial index.
+ */
+EntitiesCheckpoint CreateEntitiesCheckpoint();
+void RestoreEntitiesCheckpoint(const EntitiesCheckpoint& checkpoint);
+
 void EntitySetFlashing(EntityBase* entity, bool flashing);
 bool EntityGetFlashing(EntityBase* entity);
@@ -16,9 +16,11 @@
 #include "../config/Config.h"
 #include "../core/DataSerialiser.h"
 #include "../core/Guard.hpp"
+#include "../core/JobPool.h"
 #include "../core/Numerics.hpp"
 #include "../entity/Balloon.h"
 #include "../entity/EntityRegistry.h"
+#include "../entity/GuestNeeds.h"
 #include "../entity/MoneyEffect.h"
 #include "../entity/Particle.h"
 #include "../interface/Window_internal.h"
@@ -57,6 +59,7 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <optional>
 
 using namespace OpenRCT2;
 
@@ -421,12 +424,62 @@ static constexpr const ride_rating NauseaMinimumThresholds[] = {
     400,
 };
 
+// Below this many scans, handing them to worker threads costs more than it saves
+static constexpr size_t MinimumParallelRideScans = 8;
+
+struct NearbyRideScan
+{
+    EntityId SpriteIndex;
+    CoordsXY Centre;
+    BitSet<OpenRCT2::Limits::MaxRidesInPark> Rides;
+};
+
+// Nearby ride scans of the guests that may pick a ride this tick sorted by sprite index, see
+// guest_prepare_nearby_ride_scans
+static std::vector<NearbyRideScan> _nearbyRideScans;
+
+using RideSet = BitSet<OpenRCT2::Limits::MaxRidesInPark>;
+
+// Rides are sorted into bands of one rating point of intensity and of nausea, the last band holds everything above
+static constexpr int32_t RideFilterBandWidth = RIDE_RATING(1, 00);
+static constexpr int32_t RideFilterBandCount = 16;
+// Upper bounds of the ride price tiers, from free up to $20.00
+static constexpr money16 RideFilterPriceTiers[] = { 0, 5, 10, 20, 30, 50, 80, 120, 200 };
+
+/**
+ * The attributes of the rides that decide whether a guest picking a ride would turn it down, gathered once per tick.
+ * All of them are sets of rides, so ruling rides out for a guest takes a handful of word wide ANDs instead of going
+ * through ShouldGoOnRide for every ride in sight.
+ */
+struct RideFilters
+{
+    // Open rides that can be picked, and unrated rides that guests still roll the dice on before turning them down
+    RideSet Candidates;
+    // Shops and free transport rides, which guests do not judge on the checks below
+    RideSet Exempt;
+    RideSet Unrated;
+    RideSet Crashed;
+    // Rated rides too exposed to go on in the rain, and those of them guests with an umbrella may go on anyway
+    RideSet RainedOn;
+    RideSet UmbrellaRides;
+    // Rated rides by band, cumulative so that a range of bands is a single AND
+    std::array<RideSet, RideFilterBandCount> IntensityAtLeast;
+    std::array<RideSet, RideFilterBandCount> IntensityAtMost;
+    std::array<RideSet, RideFilterBandCount> NauseaAtMost;
+    // Rides costing more than each of the price tiers
+    std::array<RideSet, std::size(RideFilterPriceTiers)> PricedAbove;
+};
+
+// Ride filters for the current tick, see guest_prepare_ride_filters
+static std::optional<RideFilters> _rideFilters;
+
 static bool peep_has_voucher_for_free_ride(Guest* peep, Ride* ride);
 static void peep_ride_is_too_intense(Guest* peep, Ride* ride, bool peepAtRide);
 static void peep_reset_ride_heading(Guest* peep);
 static void peep_tried_to_enter_full_queue(Guest* peep, Ride* ride);
 static int16_t peep_calculate_ride_satisfaction(Guest* peep, Ride* ride);
 static void peep_update_favourite_ride(Guest* peep, Ride* ride);
+static RideSet GetRidesWorthConsidering(const Guest& guest, const RideFilters& filters);
 static int16_t peep_calculate_ride_value_satisfaction(Guest* peep, Ride* ride);
 static int16_t peep_calculate_ride_intensity_nausea_satisfaction(Guest* peep, Ride* ride);
 static void peep_update_ride_nausea_growth(Guest* peep, Ride* ride);
@@ -948,6 +1001,13 @@ void Guest::Tick128UpdateGuest(int32_t index)
                 Nausea = 130;
         }
 
+        // The need checks below read the row of the guest, so it has to see the changes made by these debug flags
+        auto& guestNeeds = GuestNeeds::Get();
+        if (PeepFlags & (PEEP_FLAGS_HUNGER | PEEP_FLAGS_TOILET | PEEP_FLAGS_NAUSEA))
+        {
+            guestNeeds.Update(*this);
+        }
+
         if (Angriness != 0)
             Angriness--;
 
@@ -1037,6 +1097,7 @@ void Guest::Tick128UpdateGuest(int32_t index)
 
             if (!OutsideOfPark && (State == PeepState::Walking || State == PeepState::Sitting))
             {
+                const auto needs = guestNeeds.GetRow(*this);
                 uint8_t num_thoughts = 0;
                 PeepThoughtType possible_thoughts[5];
 
@@ -1046,27 +1107,28 @@ void Guest::Tick128UpdateGuest(int32_t index)
                 }
                 else
                 {
-                    if (Energy <= 70 && Happiness < 128)
+                    if (needs.Energy <= 70 && needs.Happiness < 128)
                     {
                         possible_thoughts[num_thoughts++] = PeepThoughtType::Tired;
                     }
 
-                    if (Hunger <= 10 && !HasFoodOrDrink())
+                    if (needs.Hunger <= 10 && !HasFoodOrDrink())
                     {
                         possible_thoughts[num_thoughts++] = PeepThoughtType::Hungry;
                     }
 
-                    if (Thirst <= 25 && !HasFoodOrDrink())
+                    if (needs.Thirst <= 25 && !HasFoodOrDrink())
                     {
                         possible_thoughts[num_thoughts++] = PeepThoughtType::Thirsty;
                     }
 
-                    if (Toilet >= 160)
+                    if (needs.Toilet >= 160)
                     {
                         possible_thoughts[num_thoughts++] = PeepThoughtType::Toilet;
                     }
 
-                    if (!(gParkFlags & PARK_FLAGS_NO_MONEY) && CashInPocket <= 9.00_GBP && Happiness >= 105 && Energy >= 70)
+                    if (!(gParkFlags & PARK_FLAGS_NO_MONEY) && needs.CashInPocket <= 9.00_GBP && needs.Happiness >= 105
+                        && needs.Energy >= 70)
                     {
                         /* The energy check was originally a second check on happiness.
                          * This was superfluous so should probably check something else.
@@ -1111,10 +1173,11 @@ void Guest::Tick128UpdateGuest(int32_t index)
              * remaining times the encompassing conditional is
              * executed (which is also every second time, but
              * the alternate time to the true branch). */
-            if (Nausea >= 140)
+            const auto nausea = guestNeeds.GetRow(*this).Nausea;
+            if (nausea >= 140)
             {
                 PeepThoughtType thought_type = PeepThoughtType::Sick;
-                if (Nausea >= 200)
+                if (nausea >= 200)
                 {
                     thought_type = PeepThoughtType::VerySick;
                     peep_head_for_nearest_ride_type(this, RIDE_TYPE_FIRST_AID);
@@ -1803,15 +1866,7 @@ void Guest::OnExitRide(Ride* ride)
  */
 void Guest::PickRideToGoOn()
 {
-    if (State != PeepState::Walking)
-        return;
-    if (!GuestHeadingToRideId.IsNull())
-        return;
-    if (PeepFlags & PEEP_FLAGS_LEAVING_PARK)
-        return;
-    if (HasFoodOrDrink())
-        return;
-    if (x == LOCATION_NULL)
+    if (!CanPickRideToGoOn())
         return;
 
     auto ride = FindBestRideToGoOn();
@@ -1835,6 +1890,10 @@ Ride* Guest::FindBestRideToGoOn()
 {
     // Pick the most exciting ride
     auto rideConsideration = FindRidesToGoOn();
+    if (_rideFilters.has_value() && GuestHeadingToRideId.IsNull())
+    {
+        rideConsideration &= GetRidesWorthConsidering(*this, *_rideFilters);
+    }
     Ride* mostExcitingRide = nullptr;
     for (auto& ride : GetRideManager())
     {
@@ -1856,6 +1915,230 @@ Ride* Guest::FindBestRideToGoOn()
     return mostExcitingRide;
 }
 
+/**
+ * Returns the rides that have track within ten tiles of the given tile. Only reads the map, so it is safe to call from
+ * worker threads while the simulation is not running.
+ */
+static BitSet<OpenRCT2::Limits::MaxRidesInPark> FindNearbyRides(const CoordsXY& centre)
+{
+    BitSet<OpenRCT2::Limits::MaxRidesInPark> rides;
+
+    constexpr auto radius = 10 * 32;
+    for (int32_t tileX = centre.x - radius; tileX <= centre.x + radius; tileX += COORDS_XY_STEP)
+    {
+        for (int32_t tileY = centre.y - radius; tileY <= centre.y + radius; tileY += COORDS_XY_STEP)
+        {
+            auto location = CoordsXY{ tileX, tileY };
+            if (!map_is_location_valid(location))
+                continue;
+
+            for (auto* trackElement : TileElementsView<TrackElement>(location))
+            {
+                auto rideIndex = trackElement->GetRideIndex();
+                if (!rideIndex.IsNull())
+                {
+                    rides[rideIndex.ToUnderlying()] = true;
+                }
+            }
+        }
+    }
+    return rides;
+}
+
+/**
+ * Returns whether the guest will look for a ride if PickRideToGoOn is called on it.
+ */
+bool Guest::CanPickRideToGoOn() const
+{
+    return State == PeepState::Walking && GuestHeadingToRideId.IsNull() && !(PeepFlags & PEEP_FLAGS_LEAVING_PARK)
+        && !HasFoodOrDrink() && x != LOCATION_NULL;
+}
+
+void guest_prepare_nearby_ride_scans()
+{
+    _nearbyRideScans.clear();
+    if (!gConfigGeneral.multithreading)
+        return;
+
+    // Guests take their 512 tick update in the order of peep_update_all, see Tick128UpdateGuest. Only those guests can
+    // pick a ride this tick, and of them only the ones without a map look at the rides around them.
+    uint32_t index = 0;
+    for (auto guest : EntityList<Guest>())
+    {
+        if ((index & 0x1FF) == (gCurrentTicks & 0x1FF) && guest->CanPickRideToGoOn() && !guest->HasItem(ShopItem::Map))
+        {
+            _nearbyRideScans.push_back({ guest->sprite_index, { floor2(guest->x, 32), floor2(guest->y, 32) }, {} });
+        }
+        index++;
+    }
+
+    if (_nearbyRideScans.size() < MinimumParallelRideScans)
+    {
+        _nearbyRideScans.clear();
+        return;
+    }
+
+    std::sort(_nearbyRideScans.begin(), _nearbyRideScans.end(), [](const NearbyRideScan& a, const NearbyRideScan& b) {
+        return a.SpriteIndex.ToUnderlying() < b.SpriteIndex.ToUnderlying();
+    });
+    JobPool::Get().ParallelFor(_nearbyRideScans.size(), [](size_t i) {
+        auto& scan = _nearbyRideScans[i];
+        scan.Rides = FindNearbyRides(scan.Centre);
+    });
+}
+
+/**
+ * Returns the precomputed scan of the guest, or nullptr if the guest has none or has moved to another tile since.
+ */
+static const NearbyRideScan* FindNearbyRideScan(EntityId spriteIndex, const CoordsXY& centre)
+{
+    auto scan = std::lower_bound(
+        _nearbyRideScans.begin(), _nearbyRideScans.end(), spriteIndex, [](const NearbyRideScan& s, EntityId id) {
+            return s.SpriteIndex.ToUnderlying() < id.ToUnderlying();
+        });
+    if (scan == _nearbyRideScans.end() || scan->SpriteIndex != spriteIndex || scan->Centre != centre)
+        return nullptr;
+    return &*scan;
+}
+
+void guest_discard_nearby_ride_scans()
+{
+    _nearbyRideScans.clear();
+}
+
+static int32_t GetRideFilterBand(int32_t rating)
+{
+    return std::clamp(rating / RideFilterBandWidth, 0, RideFilterBandCount - 1);
+}
+
+void guest_prepare_ride_filters()
+{
+    auto& filters = _rideFilters.emplace();
+    const bool raining = climate_is_raining();
+
+    std::array<RideSet, RideFilterBandCount> intensityBands;
+    std::array<RideSet, RideFilterBandCount> nauseaBands;
+    for (auto& ride : GetRideManager())
+    {
+        if (ride.status != RideStatus::Open || (ride.lifecycle_flags & RIDE_LIFECYCLE_BROKEN_DOWN))
+            continue;
+
+        const auto rideIndex = ride.id.ToUnderlying();
+        const auto& rtd = ride.GetRideTypeDescriptor();
+        const auto price = ride_get_price(&ride);
+        const bool isShop = rtd.HasFlag(RIDE_TYPE_FLAG_IS_SHOP);
+        const bool isFreeTransport = rtd.HasFlag(RIDE_TYPE_FLAG_TRANSPORT_RIDE) && ride.value != RIDE_VALUE_UNDEFINED
+            && price == 0;
+        if (ride_has_ratings(&ride))
+        {
+            filters.Candidates[rideIndex] = true;
+            intensityBands[GetRideFilterBand(ride.intensity)][rideIndex] = true;
+            nauseaBands[GetRideFilterBand(ride.nausea)][rideIndex] = true;
+            if (raining && ride.sheltered_eighths < 3)
+            {
+                filters.RainedOn[rideIndex] = true;
+                filters.UmbrellaRides[rideIndex] = rtd.HasFlag(RIDE_TYPE_FLAG_PEEP_CAN_USE_UMBRELLA);
+            }
+        }
+        else if (!isShop && !isFreeTransport && rtd.HasFlag(RIDE_TYPE_FLAG_PEEP_CHECK_GFORCES))
+        {
+            filters.Candidates[rideIndex] = true;
+            filters.Unrated[rideIndex] = true;
+        }
+        filters.Exempt[rideIndex] = isShop || isFreeTransport;
+        filters.Crashed[rideIndex] = ride.last_crash_type != RIDE_CRASH_TYPE_NONE;
+        for (size_t tier = 0; tier < std::size(RideFilterPriceTiers); tier++)
+        {
+            filters.PricedAbove[tier][rideIndex] = price > RideFilterPriceTiers[tier];
+        }
+    }
+
+    RideSet below;
+    RideSet atMost;
+    RideSet nauseaAtMost;
+    for (int32_t band = 0; band < RideFilterBandCount; band++)
+    {
+        atMost |= intensityBands[band];
+        nauseaAtMost |= nauseaBands[band];
+        filters.IntensityAtLeast[band] = ~below;
+        filters.IntensityAtMost[band] = atMost;
+        filters.NauseaAtMost[band] = nauseaAtMost;
+        below |= intensityBands[band];
+    }
+}
+
+void guest_discard_ride_filters()
+{
+    _rideFilters.reset();
+}
+
+/**
+ * Rules out the rides that ShouldGoOnRide would turn down for a guest picking a ride, without drawing from the scenario
+ * RNG or changing anything. Rides that would get that far are kept even if they are turned down afterwards, so the
+ * rides that remain still have to go through ShouldGoOnRide, and the guest ends up drawing the same random numbers and
+ * picking the same ride as when going through every ride.
+ */
+static RideSet GetRidesWorthConsidering(const Guest& guest, const RideFilters& filters)
+{
+    const bool hasUmbrella = guest.HasItem(ShopItem::Umbrella);
+
+    // Checks only made for rated rides. Guests with an umbrella roll the dice on exposed umbrella rides before
+    // looking at their intensity, so those have to be kept.
+    RideSet rated = ~filters.RainedOn;
+    if (hasUmbrella)
+    {
+        rated |= filters.UmbrellaRides;
+    }
+    if (!gCheatsIgnoreRideIntensity)
+    {
+        const auto& intensity = guest.Intensity;
+        const int32_t maxIntensity = std::min(intensity.GetMaximum() * 100, 1000) + guest.Happiness;
+        const int32_t minIntensity = (intensity.GetMinimum() * 100) - guest.Happiness;
+        int32_t nauseaBand = GetRideFilterBand(
+            NauseaMaximumThresholds[(EnumValue(guest.NauseaTolerance) & 3)] + guest.Happiness);
+        if (guest.Nausea > 160)
+        {
+            nauseaBand = std::min(nauseaBand, GetRideFilterBand(FIXED_2DP(1, 40) - 1));
+        }
+
+        auto bearable = filters.IntensityAtLeast[GetRideFilterBand(minIntensity)]
+            & filters.IntensityAtMost[GetRideFilterBand(maxIntensity)] & filters.NauseaAtMost[nauseaBand];
+        if (hasUmbrella)
+        {
+            bearable |= filters.RainedOn & filters.UmbrellaRides;
+        }
+        rated &= bearable;
+    }
+
+    auto checks = rated | filters.Unrated;
+    if (!guest.PreviousRide.IsNull())
+    {
+        checks[guest.PreviousRide.ToUnderlying()] = false;
+    }
+    if (!(gParkFlags & PARK_FLAGS_NO_MONEY))
+    {
+        auto tier = std::find_if(std::begin(RideFilterPriceTiers), std::end(RideFilterPriceTiers), [&guest](money16 bound) {
+            return bound >= guest.CashInPocket;
+        });
+        if (tier != std::end(RideFilterPriceTiers))
+        {
+            auto affordable = ~filters.PricedAbove[std::distance(std::begin(RideFilterPriceTiers), tier)];
+            if (guest.HasItem(ShopItem::Voucher) && guest.VoucherType == VOUCHER_TYPE_RIDE_FREE
+                && !guest.VoucherRideId.IsNull())
+            {
+                affordable[guest.VoucherRideId.ToUnderlying()] = true;
+            }
+            checks &= affordable;
+        }
+    }
+    if (guest.Happiness < 225)
+    {
+        checks &= ~filters.Crashed;
+    }
+
+    return filters.Candidates & (filters.Exempt | checks);
+}
+
 BitSet<OpenRCT2::Limits::MaxRidesInPark> Guest::FindRidesToGoOn()
 {
     BitSet<OpenRCT2::Limits::MaxRidesInPark> rideConsideration;
@@ -1877,27 +2160,9 @@ BitSet<OpenRCT2::Limits::MaxRidesInPark> Guest::FindRidesToGoOn()
     else
     {
         // Take nearby rides into consideration
-        constexpr auto radius = 10 * 32;
-        int32_t cx = floor2(x, 32);
-        int32_t cy = floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
-        {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
-            {
-                auto location = CoordsXY{ tileX, tileY };
-                if (!map_is_location_valid(location))
-                    continue;
-
-                for (auto* trackElement : TileElementsView<TrackElement>(location))
-                {
-                    auto rideIndex = trackElement->GetRideIndex();
-                    if (!rideIndex.IsNull())
-                    {
-                        rideConsideration[rideIndex.ToUnderlying()] = true;
-                    }
-                }
-            }
-        }
+        auto centre = CoordsXY{ floor2(x, 32), floor2(y, 32) };
+        auto* scan = FindNearbyRideScan(sprite_index, centre);
+        rideConsideration = scan != nullptr ? scan->Rides : FindNearbyRides(centre);
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
         for (auto& ride : GetRideManager())
@@ -7138,6 +7403,7 @@ Guest* Guest::Generate(const CoordsXYZ& coords)
     peep->EnergyTarget = energy;
 
     increment_guests_heading_for_park();
+    GuestNeeds::Get().Update(*peep);
 
 #ifdef ENABLE_SCRIPTING
     auto& hookEngine = OpenRCT2::GetContext()->GetScriptEngine().GetHookEngine();
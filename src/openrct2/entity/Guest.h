@@ -335,6 +335,7 @@ public:
     void TryGetUpFromSitting();
     bool ShouldRideWhileRaining(const Ride& ride);
     void ChoseNotToGoOnRide(Ride* ride, bool peepAtRide, bool updateLastRide);
+    bool CanPickRideToGoOn() const;
     void PickRideToGoOn();
     void ReadMap();
     bool ShouldGoOnRide(Ride* ride, StationIndex entranceNum, bool atQueue, bool thinking);
@@ -471,6 +472,25 @@ void guest_set_name(EntityId spriteIndex, const char* name);
 
 void peep_thought_set_format_args(const PeepThought* thought, Formatter& ft);
 
+/**
+ * Scans the surroundings of the guests that may look for a ride during this tick on worker threads, ahead of
+ * peep_update_all. The scans only read the map, which guests do not change while they update, so FindRidesToGoOn gets
+ * the same result as when scanning on its own and the simulation stays deterministic. This is the only part of the
+ * guest update that runs in parallel, everything else draws from the scenario RNG or reads state that guests earlier
+ * in the same tick change.
+ */
+void guest_prepare_nearby_ride_scans();
+void guest_discard_nearby_ride_scans();
+
+/**
+ * Gathers the ride attributes that guests picking a ride judge rides on into sets of rides, so that FindBestRideToGoOn
+ * can rule out the rides a guest would turn down with a few bitwise operations. Guests do not change those attributes
+ * while they update, so the sets are gathered once ahead of peep_update_all and dropped after it. Whether a queue is
+ * full is still checked ride by ride, as guests set and clear it during the update.
+ */
+void guest_prepare_ride_filters();
+void guest_discard_ride_filters();
+
 void increment_guests_in_park();
 void increment_guests_heading_for_park();
 void decrement_guests_in_park();
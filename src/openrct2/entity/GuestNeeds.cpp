@@ -0,0 +1,156 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+#include "GuestNeeds.h"
+
+#include "EntityList.h"
+#include "EntityRegistry.h"
+#include "Guest.h"
+
+GuestNeeds& GuestNeeds::Get()
+{
+    static GuestNeeds guestNeeds;
+    return guestNeeds;
+}
+
+void GuestNeeds::AddToCounts(uint16_t slot, int32_t sign)
+{
+    constexpr uint8_t leavingMask = GUEST_NEEDS_FLAG_IN_PARK | GUEST_NEEDS_FLAG_LEAVING_PARK;
+    const auto flags = _flags[slot];
+    if ((flags & GUEST_NEEDS_FLAG_IN_PARK) && _happiness[slot] > HappyThreshold)
+        _happyCount += sign;
+    if ((flags & leavingMask) == leavingMask && _lostCountdown[slot] < LostCountdownThreshold)
+        _lostCount += sign;
+}
+
+void GuestNeeds::Update(const Guest& guest)
+{
+    if (!_isValid)
+        return;
+
+    const auto index = guest.sprite_index.ToUnderlying();
+    auto slot = _slots[index];
+    if (slot == NoSlot)
+    {
+        slot = static_cast<uint16_t>(_ids.size());
+        _slots[index] = slot;
+        _ids.push_back(guest.sprite_index);
+        _flags.emplace_back();
+        _happiness.emplace_back();
+        _energy.emplace_back();
+        _hunger.emplace_back();
+        _thirst.emplace_back();
+        _toilet.emplace_back();
+        _nausea.emplace_back();
+        _cash.emplace_back();
+        _lostCountdown.emplace_back();
+    }
+    else
+    {
+        AddToCounts(slot, -1);
+    }
+
+    uint8_t flags = 0;
+    if (!guest.OutsideOfPark)
+        flags |= GUEST_NEEDS_FLAG_IN_PARK;
+    if (guest.PeepFlags & PEEP_FLAGS_LEAVING_PARK)
+        flags |= GUEST_NEEDS_FLAG_LEAVING_PARK;
+
+    _flags[slot] = flags;
+    _happiness[slot] = guest.Happiness;
+    _energy[slot] = guest.Energy;
+    _hunger[slot] = guest.Hunger;
+    _thirst[slot] = guest.Thirst;
+    _toilet[slot] = guest.Toilet;
+    _nausea[slot] = guest.Nausea;
+    _cash[slot] = guest.CashInPocket;
+    _lostCountdown[slot] = guest.GuestIsLostCountdown;
+    AddToCounts(slot, 1);
+}
+
+void GuestNeeds::Remove(EntityId id)
+{
+    if (!_isValid)
+        return;
+
+    const auto slot = _slots[id.ToUnderlying()];
+    if (slot == NoSlot)
+        return;
+
+    AddToCounts(slot, -1);
+
+    // Move the last guest into the freed slot to keep the arrays packed
+    const auto last = _ids.size() - 1;
+    _slots[_ids[last].ToUnderlying()] = slot;
+    _slots[id.ToUnderlying()] = NoSlot;
+    _ids[slot] = _ids[last];
+    _flags[slot] = _flags[last];
+    _happiness[slot] = _happiness[last];
+    _energy[slot] = _energy[last];
+    _hunger[slot] = _hunger[last];
+    _thirst[slot] = _thirst[last];
+    _toilet[slot] = _toilet[last];
+    _nausea[slot] = _nausea[last];
+    _cash[slot] = _cash[last];
+    _lostCountdown[slot] = _lostCountdown[last];
+
+    _ids.pop_back();
+    _flags.pop_back();
+    _happiness.pop_back();
+    _energy.pop_back();
+    _hunger.pop_back();
+    _thirst.pop_back();
+    _toilet.pop_back();
+    _nausea.pop_back();
+    _cash.pop_back();
+    _lostCountdown.pop_back();
+}
+
+void GuestNeeds::Invalidate()
+{
+    _isValid = false;
+    _happyCount = 0;
+    _lostCount = 0;
+    _slots.clear();
+    _ids.clear();
+    _flags.clear();
+    _happiness.clear();
+    _energy.clear();
+    _hunger.clear();
+    _thirst.clear();
+    _toilet.clear();
+    _nausea.clear();
+    _cash.clear();
+    _lostCountdown.clear();
+}
+
+void GuestNeeds::Validate()
+{
+    // Guests created by scripts only enter the table after their first update
+    if (_isValid && _ids.size() != GetEntityListCount(EntityType::Guest))
+        Invalidate();
+    if (_isValid)
+        return;
+
+    _slots.assign(MAX_ENTITIES, NoSlot);
+    _isValid = true;
+    for (auto guest : EntityList<Guest>())
+    {
+        Update(*guest);
+    }
+}
+
+GuestNeedsRow GuestNeeds::GetRow(const Guest& guest) const
+{
+    const auto slot = _isValid ? _slots[guest.sprite_index.ToUnderlying()] : NoSlot;
+    if (slot == NoSlot)
+    {
+        return { guest.Happiness, guest.Energy, guest.Hunger, guest.Thirst, guest.Toilet, guest.Nausea, guest.CashInPocket };
+    }
+    return { _happiness[slot], _energy[slot], _hunger[slot], _thirst[slot], _toilet[slot], _nausea[slot], _cash[slot] };
+}
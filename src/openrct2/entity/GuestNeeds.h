@@ -0,0 +1,128 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../Identifiers.h"
+#include "../common.h"
+
+#include <vector>
+
+struct Guest;
+
+enum
+{
+    GUEST_NEEDS_FLAG_IN_PARK = 1 << 0,
+    GUEST_NEEDS_FLAG_LEAVING_PARK = 1 << 1,
+};
+
+/**
+ * The needs of a guest as they were when its row in GuestNeeds was last written.
+ */
+struct GuestNeedsRow
+{
+    uint8_t Happiness;
+    uint8_t Energy;
+    uint8_t Hunger;
+    uint8_t Thirst;
+    uint8_t Toilet;
+    uint8_t Nausea;
+    money32 CashInPocket;
+};
+
+/**
+ * The needs of every guest, stored as a structure of arrays so the park rating and the need checks of the 128 tick
+ * guest update walk a few tightly packed arrays instead of loading a whole guest entity for a couple of bytes. Guests
+ * are copied in when they are generated and after each of their updates in peep_update_all, while they are still in
+ * the cache, so the table holds the guests as they were after their last update. The guest entity still owns the
+ * fields: anything that changes them outside of the guest's own update has to call Update for that guest.
+ */
+class GuestNeeds
+{
+    // Slot of each entity id, or NoSlot for entities that are not in the table
+    std::vector<uint16_t> _slots;
+    std::vector<EntityId> _ids;
+    std::vector<uint8_t> _flags;
+    std::vector<uint8_t> _happiness;
+    std::vector<uint8_t> _energy;
+    std::vector<uint8_t> _hunger;
+    std::vector<uint8_t> _thirst;
+    std::vector<uint8_t> _toilet;
+    std::vector<uint8_t> _nausea;
+    std::vector<money32> _cash;
+    std::vector<uint8_t> _lostCountdown;
+    uint32_t _happyCount = 0;
+    uint32_t _lostCount = 0;
+    bool _isValid = false;
+
+    static constexpr uint16_t NoSlot = 0xFFFF;
+
+    void AddToCounts(uint16_t slot, int32_t sign);
+
+public:
+    // Guests above this happiness count as happy for the park rating
+    static constexpr uint8_t HappyThreshold = 128;
+    // Guests leaving the park with a lost countdown below this can not find the exit
+    static constexpr uint8_t LostCountdownThreshold = 90;
+
+    static GuestNeeds& Get();
+
+    /**
+     * Copies the fields of the guest into the table, adding it if it is not in there yet.
+     */
+    void Update(const Guest& guest);
+    void Remove(EntityId id);
+
+    /**
+     * Drops the contents of the table, it is gathered again from the guest list the next time it is needed. Used when
+     * entities are replaced wholesale, such as when a park is loaded.
+     */
+    void Invalidate();
+
+    /**
+     * Gathers the table from the guest list if it was invalidated since it was last used, or if guests were created
+     * without going through Guest::Generate.
+     */
+    void Validate();
+
+    /**
+     * Reads the needs of the guest from its row, or from the guest itself if it has not entered the table yet.
+     */
+    GuestNeedsRow GetRow(const Guest& guest) const;
+
+    size_t GetCount() const
+    {
+        return _ids.size();
+    }
+
+    const std::vector<uint8_t>& GetFlags() const
+    {
+        return _flags;
+    }
+    const std::vector<uint8_t>& GetHappiness() const
+    {
+        return _happiness;
+    }
+    const std::vector<uint8_t>& GetLostCountdown() const
+    {
+        return _lostCountdown;
+    }
+
+    /**
+     * Running counts of the happy guests and the lost guests in the park, kept up to date as rows change.
+     */
+    uint32_t GetHappyGuestCount() const
+    {
+        return _happyCount;
+    }
+    uint32_t GetLostGuestCount() const
+    {
+        return _lostCount;
+    }
+};
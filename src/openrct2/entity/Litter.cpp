@@ -11,6 +11,29 @@
 #include "EntityList.h"
 #include "EntityRegistry.h"
 
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+struct TrackedLitter
+{
+    // Null once the litter has been removed, the entry is then dropped when it reaches the front
+    EntityId Id;
+    uint32_t CreationTick;
+
+    uint32_t GetAge() const
+    {
+        return gCurrentTicks - CreationTick;
+    }
+};
+
+// Litter younger than Litter::OldAge ordered from oldest to newest, how many of them have been removed and the number
+// of litter at least that old
+static std::deque<TrackedLitter> _youngLitter;
+static size_t _removedYoungLitterCount;
+static uint32_t _oldLitterCount;
+static bool _litterAgesValid;
+
 template<> bool EntityBase::Is<Litter>() const
 {
     return Type == EntityType::Litter;
@@ -87,6 +110,11 @@ void Litter::Create(const CoordsXYZD& litterPos, Type type)
     litter->SubType = type;
     litter->MoveTo(offsetLitterPos);
     litter->creationTick = gCurrentTicks;
+
+    if (_litterAgesValid)
+    {
+        _youngLitter.push_back({ litter->sprite_index, litter->creationTick });
+    }
 }
 
 /**
@@ -113,6 +141,90 @@ void Litter::RemoveAt(const CoordsXYZ& litterPos)
     }
 }
 
+uint32_t Litter::CountOld()
+{
+    // Litter created by scripts is not seen by Create
+    if (_litterAgesValid
+        && _youngLitter.size() - _removedYoungLitterCount + _oldLitterCount != GetEntityListCount(EntityType::Litter))
+        ResetAges();
+
+    if (!_litterAgesValid)
+    {
+        std::vector<Litter*> youngLitter;
+        for (auto litter : EntityList<Litter>())
+        {
+            if (litter->GetAge() >= OldAge)
+                _oldLitterCount++;
+            else
+                youngLitter.push_back(litter);
+        }
+        std::stable_sort(youngLitter.begin(), youngLitter.end(), [](const Litter* a, const Litter* b) {
+            return a->GetAge() > b->GetAge();
+        });
+        for (auto* litter : youngLitter)
+        {
+            _youngLitter.push_back({ litter->sprite_index, litter->creationTick });
+        }
+        _litterAgesValid = true;
+    }
+
+    while (!_youngLitter.empty())
+    {
+        const auto& front = _youngLitter.front();
+        if (front.Id.IsNull())
+        {
+            _youngLitter.pop_front();
+            _removedYoungLitterCount--;
+            continue;
+        }
+        if (GetEntity<Litter>(front.Id) == nullptr)
+        {
+            _youngLitter.pop_front();
+            continue;
+        }
+        if (front.GetAge() < OldAge)
+            break;
+
+        _youngLitter.pop_front();
+        _oldLitterCount++;
+    }
+    return _oldLitterCount;
+}
+
+void Litter::ResetAges()
+{
+    _youngLitter.clear();
+    _removedYoungLitterCount = 0;
+    _oldLitterCount = 0;
+    _litterAgesValid = false;
+}
+
+void Litter::ForgetAge(const Litter& litter)
+{
+    if (!_litterAgesValid)
+        return;
+
+    // The young list is ordered by age, so only the litter of the same age has to be looked at. Litter that reached
+    // the old age since the last count is still in there.
+    const auto age = litter.GetAge();
+    auto it = std::lower_bound(
+        _youngLitter.begin(), _youngLitter.end(), age, [](const TrackedLitter& a, uint32_t b) { return a.GetAge() > b; });
+    while (it != _youngLitter.end() && it->GetAge() == age && it->Id != litter.sprite_index)
+    {
+        it++;
+    }
+    if (it != _youngLitter.end() && it->Id == litter.sprite_index)
+    {
+        // Erasing from the middle of the list would move half of it
+        it->Id = EntityId::GetNull();
+        _removedYoungLitterCount++;
+    }
+    else if (_oldLitterCount > 0)
+    {
+        _oldLitterCount--;
+    }
+}
+
 static const rct_string_id litterNames[12] = {
     STR_LITTER_VOMIT,
     STR_LITTER_VOMIT,
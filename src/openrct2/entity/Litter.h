@@ -35,10 +35,29 @@ struct Litter : EntityBase
     };
 
     static constexpr auto cEntityType = EntityType::Litter;
+    // Litter that has been lying around for at least this many ticks (about 5 minutes) counts against the park rating
+    static constexpr uint32_t OldAge = 7680;
     Type SubType;
     uint32_t creationTick;
     static void Create(const CoordsXYZD& litterPos, Type type);
     static void RemoveAt(const CoordsXYZ& litterPos);
+
+    /**
+     * Returns the number of litter at least OldAge ticks old. The count is kept up to date as litter is created and
+     * removed, so this only has to look at the litter that reached the age since it was last called.
+     */
+    static uint32_t CountOld();
+
+    /**
+     * Drops the tracked ages, they are gathered again from the litter list on the next call to CountOld. Used when
+     * entities or the tick counter are replaced, such as when a park is loaded.
+     */
+    static void ResetAges();
+
+    /**
+     * Stops tracking the age of litter that is about to be removed.
+     */
+    static void ForgetAge(const Litter& litter);
     void Serialise(DataSerialiser& stream);
     rct_string_id GetName() const;
     uint32_t GetAge() const;
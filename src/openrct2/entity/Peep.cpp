@@ -23,6 +23,7 @@
 #include "../entity/Balloon.h"
 #include "../entity/EntityRegistry.h"
 #include "../entity/EntityTweener.h"
+#include "../entity/GuestNeeds.h"
 #include "../interface/Window.h"
 #include "../localisation/Formatter.h"
 #include "../localisation/Localisation.h"
@@ -204,6 +205,12 @@ void peep_update_all()
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
         return;
 
+    guest_prepare_nearby_ride_scans();
+    guest_prepare_ride_filters();
+
+    auto& guestNeeds = GuestNeeds::Get();
+    guestNeeds.Validate();
+
     int32_t i = 0;
     // Warning this loop can delete peeps
     for (auto peep : EntityList<Guest>())
@@ -222,9 +229,18 @@ void peep_update_all()
             }
         }
 
+        // Update can delete as well, removed guests are dropped from the needs table as they are freed
+        if (peep->Type == EntityType::Guest)
+        {
+            guestNeeds.Update(*peep);
+        }
+
         i++;
     }
 
+    guest_discard_nearby_ride_scans();
+    guest_discard_ride_filters();
+
     for (auto staff : EntityList<Staff>())
     {
         if (static_cast<uint32_t>(i & 0x7F) != (gCurrentTicks & 0x7F))
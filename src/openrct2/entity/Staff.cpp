@@ -331,18 +331,25 @@ Direction Staff::HandymanDirectionToNearestLitter() const
 {
     uint16_t nearestLitterDist = 0xFFFF;
     Litter* nearestLitter = nullptr;
-    for (auto litter : EntityList<Litter>())
+    for (auto litterIndex : GetLitterInRange({ x, y }, MAX_LITTER_DISTANCE))
     {
+        auto* litter = GetEntity<Litter>(litterIndex);
+        if (litter == nullptr)
+            continue;
+
         uint16_t distance = abs(litter->x - x) + abs(litter->y - y) + abs(litter->z - z) * 4;
 
-        if (distance < nearestLitterDist)
+        // Ties go to the lowest index, as they did when the whole litter list was walked in order
+        if (distance < nearestLitterDist
+            || (distance == nearestLitterDist && nearestLitter != nullptr
+                && litter->sprite_index.ToUnderlying() < nearestLitter->sprite_index.ToUnderlying()))
         {
             nearestLitterDist = distance;
             nearestLitter = litter;
         }
     }
 
-    if (nearestLitterDist > MAX_LITTER_DISTANCE)
+    if (nearestLitter == nullptr || nearestLitterDist > MAX_LITTER_DISTANCE)
     {
         return INVALID_DIRECTION;
     }
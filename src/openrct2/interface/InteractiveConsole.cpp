@@ -36,6 +36,7 @@
 #include "../drawing/Image.h"
 #include "../entity/EntityList.h"
 #include "../entity/EntityRegistry.h"
+#include "../entity/GuestNeeds.h"
 #include "../entity/Staff.h"
 #include "../interface/Chat.h"
 #include "../interface/Colour.h"
@@ -53,6 +54,7 @@
 #include "../profiling/Profiling.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
+#include "../ride/RideRatings.h"
 #include "../ride/Vehicle.h"
 #include "../ride/TrackDesignRepository.h"
 #include "../util/Util.h"
@@ -493,6 +495,8 @@ static int32_t cc_staff(InteractiveConsole& console, const arguments_t& argv)
                     {
                         peep->Energy = int_val[1];
                         peep->EnergyTarget = int_val[1];
+                        if (auto* guest = peep->As<Guest>(); guest != nullptr)
+                            GuestNeeds::Get().Update(*guest);
                     }
                 }
             }
@@ -599,6 +603,10 @@ static int32_t cc_get(InteractiveConsole& console, const arguments_t& argv)
             console.WriteFormatLine(
                 "guest_initial_thirst %d%%  (%d)", ((255 - gGuestInitialThirst) * 100) / 255, gGuestInitialThirst);
         }
+        else if (argv[0] == "ride_rating_update_budget")
+        {
+            console.WriteFormatLine("ride_rating_update_budget %d", gRideRatingUpdateBudget);
+        }
         else if (argv[0] == "guest_prefer_less_intense_rides")
         {
             console.WriteFormatLine(
@@ -862,6 +870,18 @@ static int32_t cc_set(InteractiveConsole& console, const arguments_t& argv)
             });
             GameActions::Execute(&scenarioSetSetting);
         }
+        else if (argv[0] == "ride_rating_update_budget" && invalidArguments(&invalidArgs, int_valid[0]))
+        {
+            auto scenarioSetSetting = ScenarioSetSettingAction(
+                ScenarioSetSetting::RideRatingUpdateBudget, std::clamp(int_val[0], 1, 255));
+            scenarioSetSetting.SetCallback([&console](const GameAction*, const GameActions::Result* res) {
+                if (res->Error != GameActions::Status::Ok)
+                    console.WriteLineError("set ride_rating_update_budget command failed, likely due to permissions.");
+                else
+                    console.Execute("get ride_rating_update_budget");
+            });
+            GameActions::Execute(&scenarioSetSetting);
+        }
         else if (argv[0] == "guest_prefer_less_intense_rides" && invalidArguments(&invalidArgs, int_valid[0]))
         {
             auto scenarioSetSetting = ScenarioSetSettingAction(ScenarioSetSetting::GuestsPreferLessIntenseRides, int_val[0]);
@@ -2097,6 +2117,7 @@ static constexpr const utf8* console_variable_table[] = {
     "guest_initial_happiness",
     "guest_initial_hunger",
     "guest_initial_thirst",
+    "ride_rating_update_budget",
     "guest_prefer_less_intense_rides",
     "guest_prefer_more_intense_rides",
     "forbid_marketing_campaigns",
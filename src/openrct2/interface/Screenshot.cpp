@@ -20,6 +20,7 @@
 #include "../core/Console.hpp"
 #include "../core/File.h"
 #include "../core/Imaging.h"
+#include "../core/JobPool.h"
 #include "../core/Path.hpp"
 #include "../drawing/Drawing.h"
 #include "../drawing/X8DrawingEngine.h"
@@ -36,6 +37,8 @@
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
+#include <exception>
+#include <fstream>
 #include <memory>
 #include <optional>
 #include <string>
@@ -46,6 +49,9 @@ using namespace OpenRCT2::Drawing;
 
 uint8_t gScreenshotCountdown = 0;
 
+// Memory used by each of the two strips of rows RenderViewportToFile renders into
+static constexpr size_t ScreenshotStripSize = 32 * 1024 * 1024;
+
 static bool WriteDpiToFile(std::string_view path, const rct_drawpixelinfo* dpi, const GamePalette& palette)
 {
     auto const pixels8 = dpi->bits;
@@ -377,12 +383,109 @@ static void RenderViewport(IDrawingEngine* drawingEngine, const rct_viewport& vi
         drawingEngine = tempDrawingEngine.get();
     }
     dpi.DrawingEngine = drawingEngine;
-    viewport_render(&dpi, &viewport, { { 0, 0 }, { viewport.width, viewport.height } });
+    viewport_render(&dpi, &viewport, { { dpi.x, dpi.y }, { dpi.x + dpi.width, dpi.y + dpi.height } });
+}
+
+void RenderViewportToPng(
+    const rct_viewport& viewport, std::ostream& stream, const GamePalette& palette, int32_t stripHeight)
+{
+    const auto width = viewport.width;
+    const auto height = viewport.height;
+
+    std::vector<uint8_t> strips[2];
+    for (auto& strip : strips)
+    {
+        strip.resize(static_cast<size_t>(width) * std::min(stripHeight, height));
+    }
+
+    Imaging::PngWriter writer(stream, width, height, 8, &palette);
+    auto drawingEngine = std::make_unique<X8DrawingEngine>(GetContext()->GetUiContext());
+
+    // Nothing else is drawn until the file is written, so the strips are rendered on every thread even when
+    // multithreading is off
+    const auto backupForceMultithreading = gViewportForceMultithreading;
+    gViewportForceMultithreading = true;
+
+    auto& jobPool = JobPool::Get();
+    JobPool::TaskGroup writing;
+    std::exception_ptr writeError;
+    try
+    {
+        size_t stripIndex = 0;
+        for (int32_t top = 0; top < height; top += stripHeight)
+        {
+            // Each strip is only queued for writing once the one before it has been written, so the strip rendered two
+            // strips ago is no longer in use
+            auto& strip = strips[stripIndex++ % 2];
+            const auto rows = std::min(stripHeight, height - top);
+            // Parts outside of the map are not drawn to, clear what the previous strip left there
+            std::memset(strip.data(), PALETTE_INDEX_0, strip.size());
+
+            rct_drawpixelinfo dpi{};
+            dpi.bits = strip.data();
+            dpi.y = top;
+            dpi.width = width;
+            dpi.height = rows;
+            RenderViewport(drawingEngine.get(), viewport, dpi);
+
+            jobPool.Wait(writing);
+            if (writeError != nullptr)
+            {
+                std::rethrow_exception(writeError);
+            }
+            jobPool.AddTask(writing, [&writer, &writeError, pixels = strip.data(), rows, width]() {
+                try
+                {
+                    writer.WriteRows(pixels, rows, width);
+                }
+                catch (...)
+                {
+                    writeError = std::current_exception();
+                }
+            });
+        }
+    }
+    catch (...)
+    {
+        gViewportForceMultithreading = backupForceMultithreading;
+        jobPool.Wait(writing);
+        throw;
+    }
+    gViewportForceMultithreading = backupForceMultithreading;
+
+    jobPool.Wait(writing);
+    if (writeError != nullptr)
+    {
+        std::rethrow_exception(writeError);
+    }
+    writer.Finish();
+}
+
+/**
+ * Renders the viewport into a PNG file a strip of rows at a time, so the memory used stays the same however large the
+ * image is.
+ */
+static void RenderViewportToFile(const rct_viewport& viewport, std::string_view path, const GamePalette& palette)
+{
+    // Strips start on whole rows of tiles, see viewport_paint
+    auto stripHeight = static_cast<int32_t>(ScreenshotStripSize / std::max(viewport.width, 1));
+    stripHeight = std::clamp(stripHeight / 32 * 32, 32, std::max(viewport.height, 32));
+
+    std::ofstream fs(fs::u8path(path), std::ios::binary);
+    if (!fs.is_open())
+    {
+        throw std::runtime_error("Unable to open " + std::string(path) + " for writing.");
+    }
+    RenderViewportToPng(viewport, fs, palette, stripHeight);
+    fs.close();
+    if (fs.fail())
+    {
+        throw std::runtime_error("Unable to write " + std::string(path) + ".");
+    }
 }
 
 void screenshot_giant()
 {
-    rct_drawpixelinfo dpi{};
     try
     {
         auto path = screenshot_get_next_path();
@@ -410,10 +513,7 @@ void screenshot_giant()
             viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
         }
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(path.value(), &dpi, gPalette);
+        RenderViewportToFile(viewport, path.value(), gPalette);
 
         // Show user that screenshot saved successfully
         const auto filename = Path::GetFileName(path.value());
@@ -427,8 +527,6 @@ void screenshot_giant()
         log_error("%s", e.what());
         context_show_error(STR_SCREENSHOT_FAILED, STR_NONE, {});
     }
-
-    ReleaseDPI(dpi);
 }
 
 // TODO: Move this at some point into a more appropriate place.
@@ -625,7 +723,6 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     }
 
     int32_t exitCode = 1;
-    rct_drawpixelinfo dpi;
     try
     {
         Platform::CoreInit();
@@ -728,17 +825,13 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
 
         ApplyOptions(options, viewport);
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(outputPath, &dpi, gPalette);
+        RenderViewportToFile(viewport, outputPath, gPalette);
     }
     catch (const std::exception& e)
     {
         std::printf("%s\n", e.what());
         exitCode = -1;
     }
-    ReleaseDPI(dpi);
 
     drawing_engine_dispose();
 
@@ -825,10 +918,15 @@ void CaptureImage(const CaptureOptions& options)
     }
 
     auto outputPath = ResolveFilenameForCapture(options.Filename);
-    auto dpi = CreateDPI(viewport);
-    RenderViewport(nullptr, viewport, dpi);
-    WriteDpiToFile(outputPath, &dpi, gPalette);
-    ReleaseDPI(dpi);
+    try
+    {
+        RenderViewportToFile(viewport, outputPath, gPalette);
+    }
+    catch (...)
+    {
+        gCurrentRotation = backupRotation;
+        throw;
+    }
 
     gCurrentRotation = backupRotation;
 }
@@ -15,10 +15,13 @@
 #include "../world/Location.hpp"
 #include "ZoomLevel.h"
 
+#include <iosfwd>
 #include <optional>
 #include <string>
 
+struct GamePalette;
 struct rct_drawpixelinfo;
+struct rct_viewport;
 
 extern uint8_t gScreenshotCountdown;
 
@@ -62,3 +65,10 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
 int32_t cmdline_for_gfxbench(const char** argv, int32_t argc);
 
 void CaptureImage(const CaptureOptions& options);
+
+/**
+ * Renders the viewport into a PNG image on the stream, stripHeight rows at a time. Strips are rendered on every thread,
+ * and each one is written on the job pool while the next one is rendered. Errors from writing are rethrown here.
+ */
+void RenderViewportToPng(
+    const rct_viewport& viewport, std::ostream& stream, const GamePalette& palette, int32_t stripHeight);
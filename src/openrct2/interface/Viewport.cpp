@@ -15,7 +15,6 @@
 #include "../OpenRCT2.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
-#include "../core/JobPool.h"
 #include "../drawing/Drawing.h"
 #include "../drawing/IDrawingEngine.h"
 #include "../entity/EntityList.h"
@@ -23,6 +22,8 @@
 #include "../entity/PatrolArea.h"
 #include "../entity/Staff.h"
 #include "../paint/Paint.h"
+#include "../paint/PaintCache.h"
+#include "../paint/RenderScheduler.h"
 #include "../profiling/Profiling.h"
 #include "../ride/Ride.h"
 #include "../ride/TrackDesign.h"
@@ -52,8 +53,28 @@ uint8_t gShowConstuctionRightsRefCount;
 static std::list<rct_viewport> _viewports;
 rct_viewport* g_music_tracking_viewport;
 
-static std::unique_ptr<JobPool> _paintJobs;
-static std::vector<paint_session*> _paintColumns;
+static std::unique_ptr<RenderScheduler> _renderScheduler;
+
+// A column, or part of one, painted by a single session
+struct PaintTile
+{
+    paint_session* Session;
+    uint64_t ColumnKey;
+};
+static std::vector<PaintTile> _paintTiles;
+
+// Columns expected to generate more paint structs than this are split into tiles painted on different threads
+static constexpr float PaintTileTargetStructs = 1024.0f;
+static constexpr int32_t PaintTileMinHeight = 64;
+static constexpr size_t MaxPaintColumnDensities = 8192;
+
+struct PaintColumnCost
+{
+    size_t Structs;
+    int32_t Height;
+};
+// Paint structs generated per row of each column painted before, by column position, zoom level and rotation
+static std::unordered_map<uint64_t, float> _paintColumnDensities;
 
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
@@ -61,6 +82,7 @@ uint8_t gSavedViewRotation;
 
 paint_entry* gNextFreePaintStruct;
 uint8_t gCurrentRotation;
+bool gViewportForceMultithreading;
 
 static uint32_t _currentImageType;
 InteractionInfo::InteractionInfo(const paint_struct* ps)
@@ -863,9 +885,11 @@ static void record_session(
         for (size_t i = 0; i < chain->Count; i++)
         {
             auto& src = chain->PaintStructs[i];
-            auto& dst = recordedSession.Entries[paintIndex++];
+            auto& dst = recordedSession.Entries[paintIndex];
             dst = src;
-            entryRemap[src.AsBasic()] = reinterpret_cast<paint_struct*>(i * sizeof(paint_entry));
+            // Offsets are relative to the start of all entries, not to the current node
+            entryRemap[src.GetBasic()] = reinterpret_cast<paint_struct*>(paintIndex * sizeof(paint_entry));
+            paintIndex++;
         }
         chain = chain->Next;
     }
@@ -874,7 +898,7 @@ static void record_session(
     // Remap all entries
     for (auto& ps : recordedSession.Entries)
     {
-        auto& ptr = ps.AsBasic()->next_quadrant_ps;
+        auto& ptr = ps.GetBasic()->next_quadrant_ps;
         auto it = entryRemap.find(ptr);
         if (it == entryRemap.end())
         {
@@ -945,6 +969,43 @@ static void viewport_paint_column(paint_session& session)
     }
 }
 
+/**
+ * Number of tiles to split a column into, from the paint structs generated for it in earlier frames.
+ */
+static int32_t viewport_get_column_tile_count(uint64_t columnKey, const rct_drawpixelinfo& dpi)
+{
+    auto it = _paintColumnDensities.find(columnKey);
+    if (it == _paintColumnDensities.end())
+        return 1;
+
+    const auto expectedStructs = it->second * dpi.height;
+    const auto maxTiles = std::max(1, dpi.zoom_level.ApplyInversedTo(dpi.height) / PaintTileMinHeight);
+    return std::clamp(static_cast<int32_t>(expectedStructs / PaintTileTargetStructs) + 1, 1, maxTiles);
+}
+
+static void viewport_update_column_densities()
+{
+    if (_paintColumnDensities.size() > MaxPaintColumnDensities)
+    {
+        _paintColumnDensities.clear();
+    }
+
+    std::unordered_map<uint64_t, PaintColumnCost> costs;
+    for (const auto& tile : _paintTiles)
+    {
+        auto& cost = costs[tile.ColumnKey];
+        cost.Structs += tile.Session->PaintEntryChain.GetCount();
+        cost.Height += tile.Session->DPI.height;
+    }
+    for (const auto& [columnKey, cost] : costs)
+    {
+        if (cost.Height > 0)
+        {
+            _paintColumnDensities[columnKey] = static_cast<float>(cost.Structs) / cost.Height;
+        }
+    }
+}
+
 /**
  *
  *  rct2: 0x00685CBF
@@ -997,16 +1058,16 @@ void viewport_paint(
     auto rightBorder = dpi1.x + dpi1.width;
     auto alignedX = floor2(dpi1.x, 32);
 
-    _paintColumns.clear();
+    _paintTiles.clear();
 
-    bool useMultithreading = gConfigGeneral.multithreading;
-    if (useMultithreading && _paintJobs == nullptr)
+    bool useMultithreading = gConfigGeneral.multithreading || gViewportForceMultithreading;
+    if (useMultithreading && _renderScheduler == nullptr)
     {
-        _paintJobs = std::make_unique<JobPool>();
+        _renderScheduler = std::make_unique<RenderScheduler>();
     }
-    else if (useMultithreading == false && _paintJobs != nullptr)
+    else if (useMultithreading == false && _renderScheduler != nullptr)
     {
-        _paintJobs.reset();
+        _renderScheduler.reset();
     }
 
     bool useParallelDrawing = false;
@@ -1016,7 +1077,6 @@ void viewport_paint(
     }
 
     // Create space to record sessions and keep track which index is being drawn
-    size_t index = 0;
     if (recorded_sessions != nullptr)
     {
         auto columnSize = rightBorder - alignedX;
@@ -1024,13 +1084,12 @@ void viewport_paint(
         recorded_sessions->resize(columnCount);
     }
 
-    // Generate and sort columns.
-    for (x = alignedX; x < rightBorder; x += 32, index++)
-    {
-        paint_session* session = PaintSessionAlloc(&dpi1, viewFlags);
-        _paintColumns.push_back(session);
+    const bool usePaintCache = PaintCache::Get().Prepare();
 
-        rct_drawpixelinfo& dpi2 = session->DPI;
+    // Split the columns into tiles.
+    for (x = alignedX; x < rightBorder; x += 32)
+    {
+        rct_drawpixelinfo dpi2 = dpi1;
         if (x >= dpi2.x)
         {
             auto leftPitch = x - dpi2.x;
@@ -1049,43 +1108,79 @@ void viewport_paint(
         }
         dpi2.width = paintRight - dpi2.x;
 
-        if (useMultithreading)
+        const auto zoom = static_cast<uint8_t>(static_cast<int8_t>(viewport->zoom));
+        const uint64_t columnKey = static_cast<uint32_t>(x) | (static_cast<uint64_t>(zoom) << 32)
+            | (static_cast<uint64_t>(get_current_rotation()) << 40);
+
+        // Recorded sessions are stored by column
+        int32_t tileCount = 1;
+        if (useMultithreading && recorded_sessions == nullptr)
         {
-            _paintJobs->AddTask(
-                [session, recorded_sessions, index]() -> void { viewport_fill_column(*session, recorded_sessions, index); });
+            tileCount = viewport_get_column_tile_count(columnKey, dpi2);
         }
-        else
+
+        // Tile boundaries are kept on whole rows of pixels
+        const int32_t granularity = std::max(1, dpi2.zoom_level.ApplyTo(32));
+        const auto bytesPerRow = dpi2.zoom_level.ApplyInversedTo(dpi2.width) + dpi2.pitch;
+        int32_t top = 0;
+        for (int32_t tile = 1; tile <= tileCount; tile++)
         {
-            viewport_fill_column(*session, recorded_sessions, index);
+            int32_t bottom = dpi2.height;
+            if (tile != tileCount)
+            {
+                bottom = (dpi2.height * tile / tileCount) / granularity * granularity;
+            }
+            if (bottom <= top)
+                continue;
+
+            rct_drawpixelinfo dpi3 = dpi2;
+            dpi3.y += top;
+            dpi3.height = bottom - top;
+            dpi3.bits += dpi2.zoom_level.ApplyInversedTo(top) * bytesPerRow;
+
+            paint_session* session = PaintSessionAlloc(&dpi3, viewFlags);
+            session->UsePaintCache = usePaintCache;
+            _paintTiles.push_back({ session, columnKey });
+            top = bottom;
         }
     }
 
+    // Generate, sort and draw the tiles. Parallel drawing engines draw each tile on the thread that sorted it, others
+    // draw them in order on this thread while the remaining tiles are still being generated.
+    const std::function<void(size_t)> fillTile = [recorded_sessions, useParallelDrawing](size_t index) {
+        auto& session = *_paintTiles[index].Session;
+        viewport_fill_column(session, recorded_sessions, index);
+        if (useParallelDrawing)
+        {
+            viewport_paint_column(session);
+        }
+    };
     if (useMultithreading)
-    {
-        _paintJobs->Join();
-    }
-
-    // Paint columns.
-    for (auto* session : _paintColumns)
     {
         if (useParallelDrawing)
         {
-            _paintJobs->AddTask([session]() -> void { viewport_paint_column(*session); });
+            _renderScheduler->Run(_paintTiles.size(), fillTile);
         }
         else
         {
-            viewport_paint_column(*session);
+            _renderScheduler->Run(
+                _paintTiles.size(), fillTile, [](size_t index) { viewport_paint_column(*_paintTiles[index].Session); });
         }
+        viewport_update_column_densities();
     }
-    if (useParallelDrawing)
+    else
     {
-        _paintJobs->Join();
+        for (size_t index = 0; index < _paintTiles.size(); index++)
+        {
+            fillTile(index);
+            viewport_paint_column(*_paintTiles[index].Session);
+        }
     }
 
     // Release resources.
-    for (auto* session : _paintColumns)
+    for (auto& tile : _paintTiles)
     {
-        PaintSessionFree(session);
+        PaintSessionFree(tile.Session);
     }
 }
 
@@ -119,6 +119,8 @@ extern uint8_t gSavedViewRotation;
 
 extern paint_entry* gNextFreePaintStruct;
 extern uint8_t gCurrentRotation;
+// Spreads the rendering of viewports over the job pool whatever the multithreading setting, for offscreen renders
+extern bool gViewportForceMultithreading;
 
 void viewport_init_all();
 std::optional<ScreenCoordsXY> centre_2d_coordinates(const CoordsXYZ& loc, rct_viewport* viewport);
@@ -21,11 +21,14 @@
 #include "../util/Math.hpp"
 #include "../world/SmallScenery.h"
 #include "Paint.Entity.h"
+#include "PaintCache.h"
 #include "tile_element/Paint.TileElement.h"
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <limits>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -85,7 +88,7 @@ static int32_t RemapPositionToQuadrant(const paint_struct& ps, uint8_t rotation)
     return 0;
 }
 
-static void PaintSessionAddPSToQuadrant(paint_session& session, paint_struct* ps)
+void PaintSessionAddPSToQuadrant(paint_session& session, paint_struct* ps)
 {
     const auto positionHash = RemapPositionToQuadrant(*ps, session.CurrentRotation);
 
@@ -199,7 +202,19 @@ static paint_struct* CreateNormalPaintStruct(
     return ps;
 }
 
-template<uint8_t direction> void PaintSessionGenerateRotate(paint_session& session)
+static void PaintSessionPaintTile(paint_session& session, PaintCache::Column* column, const CoordsXY& mapCoords)
+{
+    if (column != nullptr)
+    {
+        PaintCache::Get().PaintTile(session, *column, mapCoords);
+    }
+    else
+    {
+        tile_element_paint_setup(session, mapCoords);
+    }
+}
+
+template<uint8_t direction> void PaintSessionGenerateRotate(paint_session& session, PaintCache::Column* column)
 {
     // Optimised modified version of viewport_coord_to_map_coord
     ScreenCoordsXY screenCoord = { floor2(session.DPI.x, 32), floor2((session.DPI.y - 16), 32) };
@@ -224,14 +239,14 @@ template<uint8_t direction> void PaintSessionGenerateRotate(paint_session& sessi
 
     for (; numVerticalTiles > 0; --numVerticalTiles)
     {
-        tile_element_paint_setup(session, mapTile);
+        PaintSessionPaintTile(session, column, mapTile);
         EntityPaintSetup(session, mapTile);
 
         const auto loc1 = mapTile + adjacentTiles[0];
         EntityPaintSetup(session, loc1);
 
         const auto loc2 = mapTile + adjacentTiles[1];
-        tile_element_paint_setup(session, loc2);
+        PaintSessionPaintTile(session, column, loc2);
         EntityPaintSetup(session, loc2);
 
         const auto loc3 = mapTile + adjacentTiles[2];
@@ -248,19 +263,20 @@ template<uint8_t direction> void PaintSessionGenerateRotate(paint_session& sessi
 void PaintSessionGenerate(paint_session& session)
 {
     session.CurrentRotation = get_current_rotation();
+    PaintCache::Column* column = session.UsePaintCache ? &PaintCache::Get().GetColumn(session) : nullptr;
     switch (DirectionFlipXAxis(session.CurrentRotation))
     {
         case 0:
-            PaintSessionGenerateRotate<0>(session);
+            PaintSessionGenerateRotate<0>(session, column);
             break;
         case 1:
-            PaintSessionGenerateRotate<1>(session);
+            PaintSessionGenerateRotate<1>(session, column);
             break;
         case 2:
-            PaintSessionGenerateRotate<2>(session);
+            PaintSessionGenerateRotate<2>(session, column);
             break;
         case 3:
-            PaintSessionGenerateRotate<3>(session);
+            PaintSessionGenerateRotate<3>(session, column);
             break;
     }
 }
@@ -319,11 +335,72 @@ namespace PaintSortFlags
     static constexpr uint8_t OutsideQuadrant = (1U << 7);
 } // namespace PaintSortFlags
 
+// Number of nodes summarised together when looking for the nodes to move in front of another
+static constexpr size_t PaintSortBlockSize = 8;
+
+struct PaintSortItem
+{
+    paint_struct_bound_box Bounds;
+    paint_struct* Node;
+    uint8_t Flags;
+};
+
+// Smallest and largest bounding box starts of the neighbour nodes of a block
+struct PaintSortBlock
+{
+    int32_t MinX;
+    int32_t MaxX;
+    int32_t MinY;
+    int32_t MaxY;
+    int32_t MinZ;
+};
+
+// Scratch space of PaintArrangeStructsHelperRotation, sessions are arranged on several threads at once
+static thread_local std::vector<PaintSortItem> _sortItems;
+static thread_local std::vector<PaintSortItem> _sortReordered;
+static thread_local std::vector<PaintSortBlock> _sortBlocks;
+static thread_local std::vector<size_t> _sortMatches;
+
+static void UpdatePaintSortBlock(PaintSortBlock& block, const std::vector<PaintSortItem>& items, size_t blockIndex)
+{
+    block = { std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(),
+              std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max() };
+    const size_t end = std::min(items.size(), (blockIndex + 1) * PaintSortBlockSize);
+    for (size_t i = blockIndex * PaintSortBlockSize; i < end; i++)
+    {
+        if (!(items[i].Flags & PaintSortFlags::Neighbour))
+            continue;
+
+        const auto& bounds = items[i].Bounds;
+        block.MinX = std::min(block.MinX, bounds.x);
+        block.MaxX = std::max(block.MaxX, bounds.x);
+        block.MinY = std::min(block.MinY, bounds.y);
+        block.MaxY = std::max(block.MaxY, bounds.y);
+        block.MinZ = std::min(block.MinZ, bounds.z);
+    }
+}
+
+/**
+ * Whether CheckBoundingBox can be true for any neighbour node of the block, from the starts of the bounding boxes
+ * alone.
+ */
+template<uint8_t TRotation>
+static bool PaintSortBlockMayMatch(const PaintSortBlock& block, const paint_struct_bound_box& initialBBox)
+{
+    if (initialBBox.z_end < block.MinZ)
+        return false;
+
+    const bool yMatches = (TRotation == 0 || TRotation == 1) ? initialBBox.y_end >= block.MinY
+                                                              : initialBBox.y_end < block.MaxY;
+    const bool xMatches = (TRotation == 0 || TRotation == 3) ? initialBBox.x_end >= block.MinX
+                                                              : initialBBox.x_end < block.MaxX;
+    return yMatches && xMatches;
+}
+
 template<uint8_t TRotation>
 static paint_struct* PaintArrangeStructsHelperRotation(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
 {
     paint_struct* ps;
-    paint_struct* ps_temp;
 
     // Get the first node in the specified quadrant.
     do
@@ -340,7 +417,6 @@ static paint_struct* PaintArrangeStructsHelperRotation(paint_struct* ps_next, ui
 
     // Visit all nodes in the linked quadrant list and determine their current
     // sorting relevancy.
-    ps_temp = ps;
     do
     {
         ps = ps->next_quadrant_ps;
@@ -363,68 +439,93 @@ static paint_struct* PaintArrangeStructsHelperRotation(paint_struct* ps_next, ui
             ps->SortFlags = flag | PaintSortFlags::PendingVisit;
         }
     } while (ps->quadrant_index <= quadrantIndex + 1);
-    ps = ps_temp;
 
-    // Iterate all nodes in the current list and re-order them based on
-    // the current rotation and their bounding box.
+    // Copy the nodes up to the first one outside of the range into an array, with a summary of the bounding boxes of
+    // each block of nodes, so the comparisons below can skip blocks without a node that can be moved.
+    auto& items = _sortItems;
+    items.clear();
+    paint_struct* psOutside = psQuadrantEntry->next_quadrant_ps;
+    for (; psOutside != nullptr && !(psOutside->SortFlags & PaintSortFlags::OutsideQuadrant);
+         psOutside = psOutside->next_quadrant_ps)
+    {
+        items.push_back({ psOutside->bounds, psOutside, psOutside->SortFlags });
+    }
+    const size_t count = items.size();
+    auto& blocks = _sortBlocks;
+    blocks.resize((count + PaintSortBlockSize - 1) / PaintSortBlockSize);
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        UpdatePaintSortBlock(blocks[i], items, i);
+    }
+
+    // Visit the pending nodes in list order. Each visit moves the neighbours after the node that have to be drawn
+    // before it to just in front of it, the last one found first, and continues with the first of them.
+    auto& matches = _sortMatches;
+    auto& reordered = _sortReordered;
+    size_t next = 0;
     while (true)
     {
-        // Get the first pending node in the quadrant list
-        while (true)
-        {
-            ps_next = ps->next_quadrant_ps;
-            if (ps_next == nullptr)
-            {
-                // End of the current list.
-                return psQuadrantEntry;
-            }
-            if (ps_next->SortFlags & PaintSortFlags::OutsideQuadrant)
-            {
-                // Reached point outside of specified quadrant.
-                return psQuadrantEntry;
-            }
-            if (ps_next->SortFlags & PaintSortFlags::PendingVisit)
-            {
-                // Found node to check on.
-                break;
-            }
-            ps = ps_next;
-        }
+        while (next < count && !(items[next].Flags & PaintSortFlags::PendingVisit))
+            next++;
+        if (next == count)
+            break;
 
-        // Mark visited.
-        ps_next->SortFlags &= ~PaintSortFlags::PendingVisit;
-        ps_temp = ps;
+        items[next].Flags &= ~PaintSortFlags::PendingVisit;
+        const paint_struct_bound_box initialBBox = items[next].Bounds;
 
-        // Compare current node against the remaining children.
-        const paint_struct_bound_box& initialBBox = ps_next->bounds;
-        while (true)
+        matches.clear();
+        for (size_t block = (next + 1) / PaintSortBlockSize; block < blocks.size(); block++)
         {
-            ps = ps_next;
-            ps_next = ps_next->next_quadrant_ps;
-            if (ps_next == nullptr)
-                break;
-            if (ps_next->SortFlags & PaintSortFlags::OutsideQuadrant)
-                break;
-            if (!(ps_next->SortFlags & PaintSortFlags::Neighbour))
+            if (!PaintSortBlockMayMatch<TRotation>(blocks[block], initialBBox))
                 continue;
 
-            const paint_struct_bound_box& currentBBox = ps_next->bounds;
-
-            const bool compareResult = CheckBoundingBox<TRotation>(initialBBox, currentBBox);
-
-            if (compareResult)
+            const size_t end = std::min(count, (block + 1) * PaintSortBlockSize);
+            for (size_t i = std::max(next + 1, block * PaintSortBlockSize); i < end; i++)
             {
-                // Child node intersects with current node, move behind.
-                ps->next_quadrant_ps = ps_next->next_quadrant_ps;
-                paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
-                ps_temp->next_quadrant_ps = ps_next;
-                ps_next->next_quadrant_ps = ps_temp2;
-                ps_next = ps;
+                if (!(items[i].Flags & PaintSortFlags::Neighbour))
+                    continue;
+
+                if (CheckBoundingBox<TRotation>(initialBBox, items[i].Bounds))
+                {
+                    matches.push_back(i);
+                }
             }
         }
+        if (matches.empty())
+            continue;
+
+        const size_t last = matches.back();
+        reordered.clear();
+        for (auto it = matches.rbegin(); it != matches.rend(); it++)
+        {
+            reordered.push_back(items[*it]);
+        }
+        reordered.push_back(items[next]);
+        auto match = matches.begin();
+        for (size_t i = next + 1; i <= last; i++)
+        {
+            if (match != matches.end() && *match == i)
+                match++;
+            else
+                reordered.push_back(items[i]);
+        }
+        std::copy(reordered.begin(), reordered.end(), items.begin() + next);
+        for (size_t block = next / PaintSortBlockSize; block <= last / PaintSortBlockSize; block++)
+        {
+            UpdatePaintSortBlock(blocks[block], items, block);
+        }
+    }
 
-        ps = ps_temp;
+    // Link the nodes back up in their new order
+    ps = psQuadrantEntry;
+    for (auto& item : items)
+    {
+        item.Node->SortFlags = item.Flags;
+        ps->next_quadrant_ps = item.Node;
+        ps = item.Node;
     }
+    ps->next_quadrant_ps = psOutside;
+    return psQuadrantEntry;
 }
 
 template<int TRotation> static void PaintSessionArrange(PaintSessionCore& session, bool)
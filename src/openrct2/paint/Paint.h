@@ -98,6 +98,12 @@ public:
         ::new (res) paint_string_struct();
         return res;
     }
+
+    // The paint_struct already held by the entry, the As functions above start a new one and clear it
+    paint_struct* GetBasic()
+    {
+        return reinterpret_cast<paint_struct*>(data.data());
+    }
 };
 static_assert(sizeof(paint_entry) >= sizeof(paint_struct));
 static_assert(sizeof(paint_entry) >= sizeof(attached_paint_struct));
@@ -222,6 +228,8 @@ struct paint_session : public PaintSessionCore
 {
     rct_drawpixelinfo DPI;
     PaintEntryPool::Chain PaintEntryChain;
+    // Whether tiles are painted through the PaintCache
+    bool UsePaintCache;
 
     paint_struct* AllocateNormalPaintEntry() noexcept
     {
@@ -340,6 +348,7 @@ void PaintFloatingMoneyEffect(
 paint_session* PaintSessionAlloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void PaintSessionFree(paint_session* session);
 void PaintSessionGenerate(paint_session& session);
+void PaintSessionAddPSToQuadrant(paint_session& session, paint_struct* ps);
 void PaintSessionArrange(PaintSessionCore& session);
 void PaintDrawStructs(paint_session& session);
 void PaintDrawMoneyStructs(rct_drawpixelinfo* dpi, paint_string_struct* ps);
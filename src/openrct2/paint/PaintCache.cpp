@@ -0,0 +1,465 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "PaintCache.h"
+
+#include "../Cheats.h"
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../drawing/Drawing.h"
+#include "../entity/PatrolArea.h"
+#include "../profiling/Profiling.h"
+#include "../ride/TrackDesign.h"
+#include "../util/Math.hpp"
+#include "../world/Entrance.h"
+#include "../world/Map.h"
+#include "../world/Park.h"
+#include "VirtualFloor.h"
+#include "tile_element/Paint.TileElement.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <tuple>
+
+// Tiles are painted for the whole height of their column, which no map comes close to
+static constexpr int32_t RecordingTop = -(1 << 20);
+static constexpr int32_t RecordingHeight = 1 << 21;
+
+// Paint session each thread paints tiles into before they are cached
+static thread_local std::unique_ptr<paint_session> _recordingSession;
+// Paint structs copied into the session so far for each cached paint struct of the tile being replayed
+static thread_local std::vector<paint_struct*> _replayedStructs;
+// Index of each paint struct of the tile being recorded
+static thread_local std::unordered_map<const void*, int32_t> _recordedIndices;
+
+bool PaintCache::ColumnKey::operator==(const ColumnKey& other) const
+{
+    return X == other.X && ViewFlags == other.ViewFlags && Zoom == other.Zoom && Rotation == other.Rotation;
+}
+
+size_t PaintCache::ColumnKeyHash::operator()(const ColumnKey& key) const
+{
+    auto hash = std::hash<uint64_t>()((static_cast<uint64_t>(static_cast<uint32_t>(key.X)) << 32) | key.ViewFlags);
+    return hash ^ (static_cast<size_t>(static_cast<uint8_t>(key.Zoom)) << 2) ^ key.Rotation;
+}
+
+bool PaintCache::Settings::operator==(const Settings& other) const
+{
+    const auto tie = [](const Settings& s) {
+        return std::tie(
+            s.MapSelectFlags, s.MapSelectType, s.MapSelectArrowPosition, s.MapSelectArrowDirection, s.ClipHeight,
+            s.ClipSelectionA, s.ClipSelectionB, s.ScreenFlags, s.MapBaseZ, s.PeepSpawnCount, s.PatrolAreaToRender,
+            s.TrackDesignSaveRideIndex, s.TrackDesignSaveMode, s.ShowSupportSegmentHeights, s.PaintWidePathsAsGhost,
+            s.PaintBlockedTiles, s.SandboxMode, s.ParkOpen, s.LandscapeSmoothing, s.TransparentWater, s.UpperCaseBanners);
+    };
+    return tie(*this) == tie(other);
+}
+
+PaintCache& PaintCache::Get()
+{
+    static PaintCache paintCache;
+    return paintCache;
+}
+
+PaintCache::Settings PaintCache::GetCurrentSettings()
+{
+    Settings settings{};
+    settings.MapSelectFlags = gMapSelectFlags;
+    settings.MapSelectType = gMapSelectType;
+    settings.MapSelectArrowPosition = gMapSelectArrowPosition;
+    settings.MapSelectArrowDirection = gMapSelectArrowDirection;
+    settings.ClipHeight = gClipHeight;
+    settings.ClipSelectionA = gClipSelectionA;
+    settings.ClipSelectionB = gClipSelectionB;
+    settings.ScreenFlags = gScreenFlags;
+    settings.MapBaseZ = gMapBaseZ;
+    settings.PeepSpawnCount = gPeepSpawns.size();
+    settings.PatrolAreaToRender = GetPatrolAreaToRender();
+    settings.TrackDesignSaveRideIndex = gTrackDesignSaveRideIndex;
+    settings.TrackDesignSaveMode = gTrackDesignSaveMode;
+    settings.ShowSupportSegmentHeights = gShowSupportSegmentHeights;
+    settings.PaintWidePathsAsGhost = gPaintWidePathsAsGhost;
+    settings.PaintBlockedTiles = gPaintBlockedTiles;
+    settings.SandboxMode = gCheatsSandboxMode;
+    settings.ParkOpen = (gParkFlags & PARK_FLAGS_PARK_OPEN) != 0;
+    settings.LandscapeSmoothing = gConfigGeneral.landscape_smoothing;
+    settings.TransparentWater = gConfigGeneral.transparent_water;
+    settings.UpperCaseBanners = gConfigGeneral.upper_case_banners;
+    return settings;
+}
+
+void PaintCache::Clear()
+{
+    _columns.clear();
+    _structCount = 0;
+}
+
+void PaintCache::InvalidateTile(const CoordsXY& loc)
+{
+    if (_tileGenerations.empty())
+        return;
+
+    const auto centre = TileCoordsXY(loc);
+    for (int32_t y = centre.y - 1; y <= centre.y + 1; y++)
+    {
+        for (int32_t x = centre.x - 1; x <= centre.x + 1; x++)
+        {
+            if (x >= 0 && y >= 0 && x < MAXIMUM_MAP_SIZE_TECHNICAL && y < MAXIMUM_MAP_SIZE_TECHNICAL)
+            {
+                _tileGenerations[y * MAXIMUM_MAP_SIZE_TECHNICAL + x]++;
+            }
+        }
+    }
+}
+
+void PaintCache::InvalidateRange(const CoordsXY& mins, const CoordsXY& maxs)
+{
+    if (_tileGenerations.empty())
+        return;
+
+    const auto first = TileCoordsXY(CoordsXY{ std::min(mins.x, maxs.x), std::min(mins.y, maxs.y) });
+    const auto last = TileCoordsXY(CoordsXY{ std::max(mins.x, maxs.x), std::max(mins.y, maxs.y) });
+    for (int32_t y = std::max(first.y - 1, 0); y <= std::min(last.y + 1, MAXIMUM_MAP_SIZE_TECHNICAL - 1); y++)
+    {
+        for (int32_t x = std::max(first.x - 1, 0); x <= std::min(last.x + 1, MAXIMUM_MAP_SIZE_TECHNICAL - 1); x++)
+        {
+            _tileGenerations[y * MAXIMUM_MAP_SIZE_TECHNICAL + x]++;
+        }
+    }
+}
+
+void PaintCache::Invalidate()
+{
+    _invalidated = true;
+}
+
+bool PaintCache::Prepare()
+{
+    // The virtual floor follows the cursor and the bounding box overlay is drawn from the bounds, not the images
+    if (virtual_floor_is_enabled() || gPaintBoundingBoxes)
+        return false;
+
+    if (_tileGenerations.empty())
+    {
+        _tileGenerations.resize(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL);
+    }
+
+    auto settings = GetCurrentSettings();
+    if (_invalidated || !_settings.has_value() || !(*_settings == settings) || _structCount > MaxCachedStructs)
+    {
+        Clear();
+        _settings = settings;
+        _invalidated = false;
+    }
+    return true;
+}
+
+PaintCache::Column& PaintCache::GetColumn(const paint_session& session)
+{
+    const ColumnKey key{ floor2(session.DPI.x, 32), session.ViewFlags, static_cast<int8_t>(session.DPI.zoom_level),
+                         session.CurrentRotation };
+    std::lock_guard<std::mutex> lock(_columnsMutex);
+    return _columns[key];
+}
+
+/**
+ * Tiles showing the state of a ride are not cached, as nothing invalidates them when that state changes.
+ */
+static bool IsTileCacheable(const CoordsXY& mapCoords)
+{
+    const auto* element = map_get_first_element_at(mapCoords);
+    if (element == nullptr)
+        return true;
+
+    do
+    {
+        switch (element->GetType())
+        {
+            case TileElementType::Track:
+                return false;
+            case TileElementType::Entrance:
+                if (element->AsEntrance()->GetEntranceType() != ENTRANCE_TYPE_PARK_ENTRANCE)
+                    return false;
+                break;
+            case TileElementType::Path:
+                if (element->AsPath()->IsQueue() && element->AsPath()->HasQueueBanner())
+                    return false;
+                break;
+            default:
+                break;
+        }
+    } while (!(element++)->IsLastForTile());
+    return true;
+}
+
+static void ExtendBounds(int32_t& left, int32_t& top, int32_t& right, int32_t& bottom, ImageId imageId, int32_t x, int32_t y)
+{
+    const auto* g1 = gfx_get_g1_element(imageId);
+    if (g1 == nullptr)
+        return;
+
+    left = std::min(left, x + g1->x_offset);
+    top = std::min(top, y + g1->y_offset);
+    right = std::max(right, x + g1->x_offset + g1->width);
+    bottom = std::max(bottom, y + g1->y_offset + g1->height);
+}
+
+bool PaintCache::Record(paint_session& session, const CoordsXY& mapCoords, CachedTile& tile)
+{
+    if (_recordingSession == nullptr)
+    {
+        _recordingSession = std::make_unique<paint_session>();
+        std::fill(std::begin(_recordingSession->Quadrants), std::end(_recordingSession->Quadrants), nullptr);
+    }
+
+    auto& recorder = *_recordingSession;
+    recorder.DPI = session.DPI;
+    recorder.DPI.x = floor2(session.DPI.x, 32);
+    recorder.DPI.width = 32;
+    recorder.DPI.y = RecordingTop;
+    recorder.DPI.height = RecordingHeight;
+    recorder.ViewFlags = session.ViewFlags;
+    recorder.CurrentRotation = session.CurrentRotation;
+    recorder.Flags = session.Flags;
+    recorder.QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
+    recorder.QuadrantFrontIndex = 0;
+    recorder.PaintEntryChain = PaintEntryPool::Chain(session.PaintEntryChain.Pool);
+    recorder.LastPS = nullptr;
+    recorder.LastAttachedPS = nullptr;
+    recorder.PSStringHead = nullptr;
+    recorder.LastPSString = nullptr;
+    recorder.WoodenSupportsPrependTo = nullptr;
+    recorder.CurrentlyDrawnEntity = nullptr;
+    recorder.CurrentlyDrawnTileElement = nullptr;
+    recorder.SurfaceElement = nullptr;
+    recorder.PathElementOnSameHeight = nullptr;
+    recorder.TrackElementOnSameHeight = nullptr;
+
+    tile_element_paint_setup(recorder, mapCoords);
+
+    const auto* firstElement = map_get_first_element_at(mapCoords);
+    int32_t elementCount = 0;
+    if (firstElement != nullptr)
+    {
+        const auto* element = firstElement;
+        do
+        {
+            elementCount++;
+        } while (!(element++)->IsLastForTile());
+    }
+
+    tile.Structs.clear();
+    tile.Attached.clear();
+    tile.Roots.clear();
+    _recordedIndices.clear();
+    bool cacheable = recorder.PSStringHead == nullptr;
+
+    // Adds the paint struct and the chain of children below it, returning its index
+    const auto addStruct = [&](const paint_struct* ps, CachedRoot& root) {
+        int32_t first = -1;
+        int32_t previous = -1;
+        for (; ps != nullptr; ps = ps->children)
+        {
+            auto found = _recordedIndices.find(ps);
+            if (found != _recordedIndices.end())
+            {
+                if (previous == -1)
+                    return found->second;
+                tile.Structs[previous].Children = found->second;
+                break;
+            }
+
+            const auto index = static_cast<int32_t>(tile.Structs.size());
+            _recordedIndices.emplace(ps, index);
+
+            int32_t elementIndex = -1;
+            if (ps->tileElement != nullptr)
+            {
+                elementIndex = firstElement != nullptr ? static_cast<int32_t>(ps->tileElement - firstElement) : -1;
+                if (elementIndex < 0 || elementIndex >= elementCount)
+                    cacheable = false;
+            }
+            if (ps->entity != nullptr)
+                cacheable = false;
+
+            int32_t attachedIndex = -1;
+            for (auto* attached = ps->attached_ps; attached != nullptr; attached = attached->next)
+            {
+                const auto next = static_cast<int32_t>(tile.Attached.size());
+                if (attachedIndex == -1)
+                    attachedIndex = next;
+                else
+                    tile.Attached.back().Next = next;
+                tile.Attached.push_back({ *attached, -1 });
+                ExtendBounds(
+                    root.Left, root.Top, root.Right, root.Bottom, attached->image_id, ps->x + attached->x,
+                    ps->y + attached->y);
+            }
+            ExtendBounds(root.Left, root.Top, root.Right, root.Bottom, ps->image_id, ps->x, ps->y);
+
+            tile.Structs.push_back({ *ps, -1, attachedIndex, elementIndex });
+            if (previous == -1)
+                first = index;
+            else
+                tile.Structs[previous].Children = index;
+            previous = index;
+        }
+        return first;
+    };
+
+    if (recorder.QuadrantBackIndex != std::numeric_limits<uint32_t>::max())
+    {
+        std::vector<const paint_struct*> quadrant;
+        for (auto i = recorder.QuadrantBackIndex; i <= recorder.QuadrantFrontIndex; i++)
+        {
+            // Quadrants are built by pushing to the front, walk them backwards to get the order the structs were added
+            quadrant.clear();
+            for (auto* ps = recorder.Quadrants[i]; ps != nullptr; ps = ps->next_quadrant_ps)
+            {
+                quadrant.push_back(ps);
+            }
+            for (auto it = quadrant.rbegin(); it != quadrant.rend(); it++)
+            {
+                CachedRoot root{ -1, std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max(),
+                                 std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min() };
+                root.Index = addStruct(*it, root);
+                tile.Roots.push_back(root);
+            }
+            recorder.Quadrants[i] = nullptr;
+        }
+    }
+
+    recorder.PaintEntryChain.Clear();
+    recorder.PaintEntryChain = PaintEntryPool::Chain();
+
+    if (!cacheable)
+    {
+        tile.Structs.clear();
+        tile.Attached.clear();
+        tile.Roots.clear();
+    }
+    return cacheable;
+}
+
+void PaintCache::Replay(paint_session& session, const CoordsXY& mapCoords, const CachedTile& tile) const
+{
+    const auto& dpi = session.DPI;
+    auto* firstElement = map_get_first_element_at(mapCoords);
+
+    _replayedStructs.assign(tile.Structs.size(), nullptr);
+    for (const auto& root : tile.Roots)
+    {
+        if (root.Right <= dpi.x || root.Bottom <= dpi.y || root.Left >= dpi.x + dpi.width || root.Top >= dpi.y + dpi.height)
+            continue;
+
+        paint_struct* first = nullptr;
+        paint_struct* previous = nullptr;
+        for (auto index = root.Index; index != -1; index = tile.Structs[index].Children)
+        {
+            auto* ps = _replayedStructs[index];
+            if (ps == nullptr)
+            {
+                const auto& cached = tile.Structs[index];
+                ps = session.AllocateNormalPaintEntry();
+                if (ps == nullptr)
+                    return;
+
+                *ps = cached.Struct;
+                ps->children = nullptr;
+                ps->next_quadrant_ps = nullptr;
+                ps->tileElement = cached.TileElementIndex != -1 ? firstElement + cached.TileElementIndex : nullptr;
+
+                attached_paint_struct* lastAttached = nullptr;
+                ps->attached_ps = nullptr;
+                for (auto attachedIndex = cached.Attached; attachedIndex != -1;
+                     attachedIndex = tile.Attached[attachedIndex].Next)
+                {
+                    auto* attached = session.AllocateAttachedPaintEntry();
+                    if (attached == nullptr)
+                        return;
+
+                    *attached = tile.Attached[attachedIndex].Struct;
+                    attached->next = nullptr;
+                    if (lastAttached == nullptr)
+                        ps->attached_ps = attached;
+                    else
+                        lastAttached->next = attached;
+                    lastAttached = attached;
+                }
+                _replayedStructs[index] = ps;
+            }
+            else if (previous != nullptr)
+            {
+                // Already copied along with everything below it
+                previous->children = ps;
+                break;
+            }
+
+            if (previous == nullptr)
+                first = ps;
+            else
+                previous->children = ps;
+            previous = ps;
+        }
+
+        if (first != nullptr)
+        {
+            PaintSessionAddPSToQuadrant(session, first);
+        }
+    }
+
+    session.LastPS = nullptr;
+    session.LastAttachedPS = nullptr;
+}
+
+void PaintCache::PaintTile(paint_session& session, Column& column, const CoordsXY& mapCoords)
+{
+    const auto tileCoords = TileCoordsXY(mapCoords);
+    if (mapCoords.x < 0 || mapCoords.y < 0 || tileCoords.x >= MAXIMUM_MAP_SIZE_TECHNICAL
+        || tileCoords.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+    {
+        tile_element_paint_setup(session, mapCoords);
+        return;
+    }
+
+    const auto tileIndex = static_cast<uint32_t>(tileCoords.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileCoords.x);
+    const auto generation = _tileGenerations[tileIndex];
+    CachedTile* cachedTile;
+    bool inserted;
+    {
+        // References to the elements stay valid while other threads insert tiles
+        std::lock_guard<std::mutex> lock(column.TilesMutex);
+        auto result = column.Tiles.try_emplace(tileIndex);
+        cachedTile = &result.first->second;
+        inserted = result.second;
+    }
+
+    auto& tile = *cachedTile;
+    std::lock_guard<std::mutex> tileLock(tile.Mutex);
+    if (inserted || tile.Generation != generation)
+    {
+        PROFILED_FUNCTION();
+
+        const auto previousCount = tile.Structs.size();
+        tile.Generation = generation;
+        tile.Cacheable = IsTileCacheable(mapCoords) && Record(session, mapCoords, tile);
+        _structCount += tile.Structs.size();
+        _structCount -= previousCount;
+    }
+
+    if (tile.Cacheable)
+    {
+        Replay(session, mapCoords, tile);
+    }
+    else
+    {
+        tile_element_paint_setup(session, mapCoords);
+    }
+}
@@ -0,0 +1,184 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../Identifiers.h"
+#include "../common.h"
+#include "../ride/RideTypes.h"
+#include "../world/Location.hpp"
+#include "Paint.h"
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+enum class StaffType : uint8_t;
+
+/**
+ * Keeps the paint structs generated for the tile elements of each tile, per 32 pixel viewport column, rotation, zoom
+ * level and set of view flags, so that the columns of viewport_paint copy them into their session instead of painting
+ * every tile element again each frame. Entities are still painted every frame and merged in as before.
+ *
+ * A tile is painted again after a map_invalidate_tile* call for it or one of its neighbours, which every change to the
+ * map and every map animation already goes through. Everything is painted again after gfx_invalidate_screen, after the
+ * tile elements are replaced, or when one of the global settings that tile painting reads changes. Tiles with track or
+ * ride entrances on them, and queues with a banner, show the state of their ride and are painted every frame.
+ *
+ * Tiles are painted for the full height of their column, and only the paint structs overlapping the area being drawn
+ * are copied into the session, along with everything attached to them.
+ */
+class PaintCache
+{
+    struct CachedPaintStruct
+    {
+        paint_struct Struct;
+        int32_t Children;
+        int32_t Attached;
+        // Index of the tile element among the elements of the tile, or -1
+        int32_t TileElementIndex;
+    };
+
+    struct CachedAttachedPaintStruct
+    {
+        attached_paint_struct Struct;
+        int32_t Next;
+    };
+
+    // A paint struct added to a quadrant, with the screen area covered by it and everything attached to it
+    struct CachedRoot
+    {
+        int32_t Index;
+        int32_t Left;
+        int32_t Top;
+        int32_t Right;
+        int32_t Bottom;
+    };
+
+    struct CachedTile
+    {
+        // Held while the tile is painted and copied, the sessions splitting a column share its tiles
+        std::mutex Mutex;
+        uint32_t Generation{};
+        bool Cacheable{};
+        std::vector<CachedPaintStruct> Structs;
+        std::vector<CachedAttachedPaintStruct> Attached;
+        // In the order they were added to their quadrants
+        std::vector<CachedRoot> Roots;
+    };
+
+    struct ColumnKey
+    {
+        int32_t X;
+        uint32_t ViewFlags;
+        int8_t Zoom;
+        uint8_t Rotation;
+
+        bool operator==(const ColumnKey& other) const;
+    };
+
+    struct ColumnKeyHash
+    {
+        size_t operator()(const ColumnKey& key) const;
+    };
+
+    // Global state read by tile painting that is changed without invalidating the tiles it affects
+    struct Settings
+    {
+        uint16_t MapSelectFlags;
+        uint16_t MapSelectType;
+        CoordsXYZ MapSelectArrowPosition;
+        uint8_t MapSelectArrowDirection;
+        uint8_t ClipHeight;
+        CoordsXY ClipSelectionA;
+        CoordsXY ClipSelectionB;
+        uint8_t ScreenFlags;
+        int32_t MapBaseZ;
+        size_t PeepSpawnCount;
+        std::variant<StaffType, EntityId> PatrolAreaToRender;
+        RideId TrackDesignSaveRideIndex;
+        bool TrackDesignSaveMode;
+        bool ShowSupportSegmentHeights;
+        bool PaintWidePathsAsGhost;
+        bool PaintBlockedTiles;
+        bool SandboxMode;
+        bool ParkOpen;
+        bool LandscapeSmoothing;
+        bool TransparentWater;
+        bool UpperCaseBanners;
+
+        bool operator==(const Settings& other) const;
+    };
+
+public:
+    struct Column
+    {
+        // Guards Tiles only, each tile has its own lock
+        std::mutex TilesMutex;
+        std::unordered_map<uint32_t, CachedTile> Tiles;
+    };
+
+private:
+    // Dropped wholesale once more paint structs than this are cached
+    static constexpr size_t MaxCachedStructs = 1 << 18;
+
+    std::unordered_map<ColumnKey, Column, ColumnKeyHash> _columns;
+    std::mutex _columnsMutex;
+    // Bumped for a tile whenever it is invalidated, cached tiles painted at an older generation are painted again
+    std::vector<uint32_t> _tileGenerations;
+    std::atomic<size_t> _structCount{};
+    std::optional<Settings> _settings;
+    bool _invalidated{};
+
+    static Settings GetCurrentSettings();
+    void Clear();
+    bool Record(paint_session& session, const CoordsXY& mapCoords, CachedTile& tile);
+    void Replay(paint_session& session, const CoordsXY& mapCoords, const CachedTile& tile) const;
+
+public:
+    static PaintCache& Get();
+
+    /**
+     * Drops the paint structs of the tile and its neighbours, whose painting can depend on it.
+     */
+    void InvalidateTile(const CoordsXY& loc);
+    void InvalidateRange(const CoordsXY& mins, const CoordsXY& maxs);
+
+    /**
+     * Drops everything, it is painted again the next time it is needed.
+     */
+    void Invalidate();
+
+    /**
+     * Drops the cache if the settings tile painting reads changed or it grew too large. Must be called before the
+     * columns of a viewport are generated, while no other thread is painting. Returns whether the columns can use the
+     * cache.
+     */
+    bool Prepare();
+
+    /**
+     * Returns the cached tiles for the column the session draws, creating them if needed. Safe to call from the threads
+     * generating columns, the sessions a column is split into all get the same one.
+     */
+    Column& GetColumn(const paint_session& session);
+
+    /**
+     * Paints the tile elements of the tile into the session like tile_element_paint_setup, from the column if the tile
+     * has not changed since it was last painted.
+     */
+    void PaintTile(paint_session& session, Column& column, const CoordsXY& mapCoords);
+
+    size_t GetStructCount() const
+    {
+        return _structCount;
+    }
+};
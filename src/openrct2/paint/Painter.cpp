@@ -158,6 +158,7 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     session->QuadrantFrontIndex = 0;
     session->PaintEntryChain = _paintStructPool.Create();
     session->Flags = 0;
+    session->UsePaintCache = false;
 
     std::fill(std::begin(session->Quadrants), std::end(session->Quadrants), nullptr);
     session->LastPS = nullptr;
@@ -0,0 +1,134 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "RenderScheduler.h"
+
+#include "../core/JobPool.h"
+
+#include <algorithm>
+#include <thread>
+
+RenderScheduler::RenderScheduler(size_t maxThreads)
+    : _maxThreads(std::max<size_t>(maxThreads, 1))
+{
+}
+
+size_t RenderScheduler::GetThreadCount() const
+{
+    return std::min(_maxThreads, JobPool::Get().GetThreadCount());
+}
+
+void RenderScheduler::Run(
+    size_t count, const std::function<void(size_t)>& workFn, const std::function<void(size_t)>& orderedFn)
+{
+    if (count == 0)
+        return;
+
+    if (_finishedCapacity < count)
+    {
+        _finished = std::make_unique<std::atomic<bool>[]>(count);
+        _finishedCapacity = count;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        _finished[i].store(false, std::memory_order_relaxed);
+    }
+
+    // Hand out contiguous shares, neighbouring tiles tend to draw the same sprites
+    const auto queueCount = GetThreadCount();
+    while (_queues.size() < queueCount)
+    {
+        _queues.push_back(std::make_unique<Queue>());
+    }
+    _queues.resize(queueCount);
+    for (size_t q = 0; q < queueCount; q++)
+    {
+        std::unique_lock<std::mutex> lock(_queues[q]->Mutex);
+        for (size_t tile = count * q / queueCount; tile < count * (q + 1) / queueCount; tile++)
+        {
+            _queues[q]->Tiles.push_back(tile);
+        }
+    }
+    _workFn = &workFn;
+
+    // The tasks steal from the other queues once theirs is empty, so a task the pool gets to late finds little left
+    auto& jobPool = JobPool::Get();
+    JobPool::TaskGroup group;
+    const auto ownQueue = queueCount - 1;
+    for (size_t q = 0; q < ownQueue; q++)
+    {
+        jobPool.AddTask(group, [this, q]() {
+            while (RunNextTile(q))
+            {
+            }
+        });
+    }
+
+    if (orderedFn)
+    {
+        for (size_t tile = 0; tile < count; tile++)
+        {
+            while (!_finished[tile].load(std::memory_order_acquire))
+            {
+                if (!RunNextTile(ownQueue))
+                {
+                    // The tile is being worked on by another thread
+                    std::this_thread::yield();
+                }
+            }
+            orderedFn(tile);
+        }
+    }
+    else
+    {
+        while (RunNextTile(ownQueue))
+        {
+        }
+    }
+
+    // The pool tasks may still be finishing their last tile
+    jobPool.Wait(group);
+    _workFn = nullptr;
+}
+
+bool RenderScheduler::RunNextTile(size_t queueIndex)
+{
+    size_t tile = 0;
+    bool found = false;
+    {
+        auto& queue = *_queues[queueIndex];
+        std::unique_lock<std::mutex> lock(queue.Mutex);
+        if (!queue.Tiles.empty())
+        {
+            tile = queue.Tiles.front();
+            queue.Tiles.pop_front();
+            found = true;
+        }
+    }
+
+    // Steal from the end of another queue, which its owner would get to last
+    for (size_t offset = 1; !found && offset < _queues.size(); offset++)
+    {
+        auto& queue = *_queues[(queueIndex + offset) % _queues.size()];
+        std::unique_lock<std::mutex> lock(queue.Mutex);
+        if (!queue.Tiles.empty())
+        {
+            tile = queue.Tiles.back();
+            queue.Tiles.pop_back();
+            found = true;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    (*_workFn)(tile);
+    _finished[tile].store(true, std::memory_order_release);
+    return true;
+}
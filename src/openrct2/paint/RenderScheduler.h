@@ -0,0 +1,57 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Runs the tiles of a viewport on the shared JobPool. Each thread working on them, including the one calling Run, gets
+ * its own queue of tile indices, starting with an even contiguous share of them. A thread takes tiles from the front of
+ * its own queue and, once that is empty, steals from the back of the queues of the other threads, so a few expensive
+ * tiles do not keep the other threads idle.
+ */
+class RenderScheduler
+{
+    struct Queue
+    {
+        std::mutex Mutex;
+        std::deque<size_t> Tiles;
+    };
+
+    size_t _maxThreads;
+    // One per pool task, then one for the thread calling Run
+    std::vector<std::unique_ptr<Queue>> _queues;
+
+    const std::function<void(size_t)>* _workFn{};
+    std::unique_ptr<std::atomic<bool>[]> _finished;
+    size_t _finishedCapacity{};
+
+public:
+    RenderScheduler(size_t maxThreads = 255);
+
+    size_t GetThreadCount() const;
+
+    /**
+     * Calls workFn for every tile index below count, spread over the threads of the pool. If orderedFn is set, the
+     * calling thread also calls it for every tile, in order, as soon as workFn has finished for that tile, helping with
+     * the remaining tiles while it waits. Returns once every call has finished.
+     */
+    void Run(
+        size_t count, const std::function<void(size_t)>& workFn, const std::function<void(size_t)>& orderedFn = nullptr);
+
+private:
+    bool RunNextTile(size_t queueIndex);
+};
@@ -0,0 +1,555 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "FootpathGraph.h"
+
+#include "../profiling/Profiling.h"
+#include "../ride/Ride.h"
+#include "../ride/RideData.h"
+#include "../util/Util.h"
+#include "../world/Map.h"
+#include "GuestPathfinding.h"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <unordered_set>
+
+// Guards against walking forever along path edges that do not match up
+static constexpr size_t MaxCorridorLength = 4096;
+// The search gives up after visiting this many junctions, leaving the choice to the bounded search
+static constexpr size_t MaxSearchedJunctions = 16384;
+static constexpr size_t MaxNextHops = 65536;
+static constexpr size_t MaxFlowFields = 64;
+// Searches made for a destination before it is given a flow field
+static constexpr uint32_t FlowFieldMinRequests = 4;
+static constexpr size_t MaxDestinationRequests = 4096;
+
+static uint64_t GetTileKey(const TileCoordsXYZ& loc)
+{
+    return static_cast<uint64_t>(loc.x & 0xFFFF) | (static_cast<uint64_t>(loc.y & 0xFFFF) << 16)
+        | (static_cast<uint64_t>(loc.z & 0xFFFF) << 32);
+}
+
+static uint64_t GetCorridorKey(const TileCoordsXYZ& start, Direction direction)
+{
+    return GetTileKey(start) | (static_cast<uint64_t>(direction) << 48);
+}
+
+static TileCoordsXY GetCorridorStart(uint64_t key)
+{
+    return { static_cast<int32_t>(key & 0xFFFF), static_cast<int32_t>((key >> 16) & 0xFFFF) };
+}
+
+static uint32_t GetTileIndex(const TileCoordsXY& tile)
+{
+    return static_cast<uint32_t>(tile.x + tile.y * MAXIMUM_MAP_SIZE_TECHNICAL);
+}
+
+/**
+ * Edges of the path element that no entry banners on it do not block.
+ */
+static uint8_t GetBannerAllowedEdges(const TileElement* pathElement)
+{
+    uint8_t allowedEdges = 0x0F;
+    for (const auto* element = pathElement; !element->IsLastForTile();)
+    {
+        element++;
+        if (element->GetType() == TileElementType::Path)
+            break;
+        if (element->GetType() == TileElementType::Banner)
+            allowedEdges &= element->AsBanner()->GetAllowedEdges();
+    }
+    return allowedEdges;
+}
+
+/**
+ * Whether the element is a place a corridor can end at that peeps head for: a park entrance, a ride entrance or exit
+ * facing the direction walked in, or a shop.
+ */
+static bool IsCorridorDestination(const TileElement* element, int32_t z, Direction direction)
+{
+    if (element->base_height != z)
+        return false;
+
+    switch (element->GetType())
+    {
+        case TileElementType::Entrance:
+            switch (element->AsEntrance()->GetEntranceType())
+            {
+                case ENTRANCE_TYPE_PARK_ENTRANCE:
+                    return true;
+                case ENTRANCE_TYPE_RIDE_ENTRANCE:
+                case ENTRANCE_TYPE_RIDE_EXIT:
+                    return element->GetDirection() == direction;
+                default:
+                    return false;
+            }
+        case TileElementType::Track:
+        {
+            auto ride = get_ride(element->AsTrack()->GetRideIndex());
+            return ride != nullptr && ride->GetRideTypeDescriptor().HasFlag(RIDE_TYPE_FLAG_IS_SHOP);
+        }
+        default:
+            return false;
+    }
+}
+
+bool FootpathGraph::Destination::operator==(const Destination& other) const
+{
+    return Goal == other.Goal && QueueRideIndex == other.QueueRideIndex && IsStaff == other.IsStaff
+        && IgnoreForeignQueues == other.IgnoreForeignQueues;
+}
+
+size_t FootpathGraph::DestinationHash::operator()(const Destination& destination) const
+{
+    auto hash = std::hash<uint64_t>()(GetTileKey(destination.Goal));
+    hash ^= std::hash<uint32_t>()(
+                (destination.QueueRideIndex.ToUnderlying() << 2) | (destination.IsStaff << 1)
+                | destination.IgnoreForeignQueues)
+        + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+bool FootpathGraph::NextHopKey::operator==(const NextHopKey& other) const
+{
+    return Dest == other.Dest && Start == other.Start && Edges == other.Edges;
+}
+
+size_t FootpathGraph::NextHopKeyHash::operator()(const NextHopKey& key) const
+{
+    auto hash = DestinationHash()(key.Dest);
+    hash ^= std::hash<uint64_t>()(GetTileKey(key.Start) | (static_cast<uint64_t>(key.Edges) << 48)) + 0x9E3779B9
+        + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+FootpathGraph& FootpathGraph::Get()
+{
+    static FootpathGraph footpathGraph;
+    return footpathGraph;
+}
+
+void FootpathGraph::Invalidate()
+{
+    _corridors.clear();
+    _tileCorridors.clear();
+    ClearSearchCaches();
+}
+
+void FootpathGraph::InvalidateTile(const CoordsXY& loc)
+{
+    // Any change can shorten or cut off routes far away from the tile
+    ClearSearchCaches();
+    if (_corridors.empty())
+        return;
+
+    const auto tile = TileCoordsXY{ loc };
+    const TileCoordsXY tiles[] = {
+        tile,
+        tile + TileDirectionDelta[0],
+        tile + TileDirectionDelta[1],
+        tile + TileDirectionDelta[2],
+        tile + TileDirectionDelta[3],
+    };
+    for (const auto& invalidTile : tiles)
+    {
+        auto it = _tileCorridors.find(GetTileIndex(invalidTile));
+        if (it == _tileCorridors.end())
+            continue;
+
+        // Removing the corridors changes the list
+        const auto keys = it->second;
+        for (auto key : keys)
+        {
+            RemoveCorridor(key);
+        }
+    }
+}
+
+void FootpathGraph::ClearSearchCaches()
+{
+    _nextHops.clear();
+    _flowFields.clear();
+    _flowFieldIndex.clear();
+    _destinationRequests.clear();
+}
+
+void FootpathGraph::RegisterCorridor(uint64_t key, const TileCoordsXY& tile)
+{
+    _tileCorridors[GetTileIndex(tile)].push_back(key);
+}
+
+void FootpathGraph::RemoveCorridor(uint64_t key)
+{
+    auto it = _corridors.find(key);
+    if (it == _corridors.end())
+        return;
+
+    auto unregister = [this, key](const TileCoordsXY& tile) {
+        auto tileIt = _tileCorridors.find(GetTileIndex(tile));
+        if (tileIt == _tileCorridors.end())
+            return;
+
+        auto& keys = tileIt->second;
+        auto keyIt = std::find(keys.begin(), keys.end(), key);
+        if (keyIt != keys.end())
+        {
+            *keyIt = keys.back();
+            keys.pop_back();
+        }
+        if (keys.empty())
+            _tileCorridors.erase(tileIt);
+    };
+
+    unregister(GetCorridorStart(key));
+    for (const auto& tile : it->second.Tiles)
+    {
+        unregister(tile);
+    }
+    _corridors.erase(it);
+}
+
+const FootpathGraph::Corridor& FootpathGraph::GetCorridor(const TileCoordsXYZ& start, Direction direction)
+{
+    const auto key = GetCorridorKey(start, direction);
+    auto it = _corridors.find(key);
+    if (it != _corridors.end())
+        return it->second;
+
+    Corridor corridor;
+    size_t guestLength = MaxCorridorLength;
+
+    const TileElement* current = nullptr;
+    auto* startPath = map_get_path_element_at(start);
+    if (startPath != nullptr)
+    {
+        current = startPath->as<TileElement>();
+        if (!(GetBannerAllowedEdges(current) & (1 << direction)))
+            guestLength = 0;
+    }
+
+    auto loc = start;
+    auto walkDirection = direction;
+    while (current != nullptr && corridor.Tiles.size() < MaxCorridorLength)
+    {
+        if (current->AsPath()->IsSloped() && current->AsPath()->GetSlopeDirection() == walkDirection)
+            loc.z += 2;
+        loc += TileDirectionDelta[walkDirection];
+
+        TileElement* element = map_get_first_element_at(loc);
+        if (element == nullptr)
+            break;
+
+        const TileElement* next = nullptr;
+        bool isDestination = false;
+        do
+        {
+            if (element->IsGhost())
+                continue;
+            if (element->GetType() == TileElementType::Path)
+            {
+                if (IsValidPathZAndDirection(element, loc.z, walkDirection))
+                    next = element;
+            }
+            else
+            {
+                isDestination = IsCorridorDestination(element, loc.z, walkDirection);
+            }
+        } while (next == nullptr && !isDestination && !(element++)->IsLastForTile());
+
+        if (isDestination)
+        {
+            corridor.Tiles.push_back(loc);
+            corridor.EndDirection = walkDirection;
+            break;
+        }
+        if (next == nullptr)
+            break;
+
+        // Path may be sloped, so set z to path base height
+        loc.z = next->base_height;
+        corridor.Tiles.push_back(loc);
+        corridor.EndDirection = walkDirection;
+        if (loc == start)
+            break;
+
+        const auto edges = next->AsPath()->GetEdges();
+        const auto onwardEdges = edges & ~(1 << direction_reverse(walkDirection));
+        if (bitcount(edges) != 2 || bitcount(onwardEdges) != 1)
+        {
+            corridor.EndEdges = onwardEdges;
+            break;
+        }
+
+        if (next->AsPath()->IsQueue())
+            corridor.QueueTiles.push_back(static_cast<uint16_t>(corridor.Tiles.size() - 1));
+        if (guestLength == MaxCorridorLength && !(GetBannerAllowedEdges(next) & onwardEdges))
+            guestLength = corridor.Tiles.size();
+
+        current = next;
+        walkDirection = bitscanforward(onwardEdges);
+    }
+    corridor.GuestLength = static_cast<uint16_t>(std::min(guestLength, corridor.Tiles.size()));
+
+    RegisterCorridor(key, start);
+    for (const auto& tile : corridor.Tiles)
+    {
+        RegisterCorridor(key, tile);
+    }
+    return _corridors.emplace(key, std::move(corridor)).first->second;
+}
+
+size_t FootpathGraph::GetReachableLength(const Corridor& corridor, const Destination& destination) const
+{
+    size_t length = destination.IsStaff ? corridor.Tiles.size() : corridor.GuestLength;
+    if (destination.IgnoreForeignQueues)
+    {
+        for (auto queueTile : corridor.QueueTiles)
+        {
+            if (queueTile >= length)
+                break;
+
+            // Queues are chained to rides without touching the graph, so their ride is looked up each time
+            const auto* queue = map_get_path_element_at(corridor.Tiles[queueTile]);
+            if (queue != nullptr && !queue->GetRideIndex().IsNull() && queue->GetRideIndex() != destination.QueueRideIndex)
+                return queueTile + 1;
+        }
+    }
+    return length;
+}
+
+Direction FootpathGraph::ChooseDirection(
+    const TileCoordsXYZ& start, uint8_t edges, const TileCoordsXYZ& goal, bool isStaff, bool ignoreForeignQueues,
+    RideId queueRideIndex, bool useFlowFields)
+{
+    const NextHopKey key{ { goal, queueRideIndex, isStaff, ignoreForeignQueues }, start, edges };
+    auto it = _nextHops.find(key);
+    if (it != _nextHops.end())
+        return it->second;
+
+    const auto* flowField = useFlowFields ? GetFlowField(key.Dest) : nullptr;
+    auto direction = flowField != nullptr ? LookUpFlowField(*flowField, start, edges) : Search(start, edges, key.Dest);
+    if (_nextHops.size() >= MaxNextHops)
+        _nextHops.clear();
+    _nextHops.emplace(key, direction);
+    return direction;
+}
+
+Direction FootpathGraph::Search(const TileCoordsXYZ& start, uint8_t edges, const Destination& destination)
+{
+    PROFILED_FUNCTION();
+
+    struct OpenEntry
+    {
+        // Steps walked so far plus the least number of steps left to the goal
+        uint32_t Estimate;
+        uint32_t Steps;
+        Direction FirstDirection;
+        bool AtGoal;
+        TileCoordsXYZ Location;
+        uint8_t Edges;
+
+        // Ordered so the top of the queue is the best entry. Ties go to the lowest first direction, so of several
+        // equally short walks the one a flow field would pick is found.
+        bool operator<(const OpenEntry& other) const
+        {
+            if (Estimate != other.Estimate)
+                return Estimate > other.Estimate;
+            if (FirstDirection != other.FirstDirection)
+                return FirstDirection > other.FirstDirection;
+            return other.AtGoal && !AtGoal;
+        }
+    };
+
+    const auto& goal = destination.Goal;
+    std::priority_queue<OpenEntry> open;
+    auto addCorridor = [&](const TileCoordsXYZ& from, Direction direction, uint32_t steps, Direction firstDirection) {
+        const auto& corridor = GetCorridor(from, direction);
+        const auto length = GetReachableLength(corridor, destination);
+        for (size_t i = 0; i < length; i++)
+        {
+            if (corridor.Tiles[i] == goal)
+            {
+                const auto goalSteps = steps + static_cast<uint32_t>(i + 1);
+                open.push({ goalSteps, goalSteps, firstDirection, true, goal, 0 });
+                return;
+            }
+        }
+
+        if (length == corridor.Tiles.size() && corridor.EndEdges != 0)
+        {
+            const auto& end = corridor.Tiles.back();
+            const auto endSteps = steps + static_cast<uint32_t>(length);
+            const auto remaining = static_cast<uint32_t>(std::abs(end.x - goal.x) + std::abs(end.y - goal.y));
+            open.push({ endSteps + remaining, endSteps, firstDirection, false, end, corridor.EndEdges });
+        }
+    };
+
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        if (edges & (1 << direction))
+            addCorridor(start, direction, 0, direction);
+    }
+
+    std::unordered_set<uint64_t> visited;
+    visited.insert(GetTileKey(start));
+    while (!open.empty() && visited.size() <= MaxSearchedJunctions)
+    {
+        const auto entry = open.top();
+        open.pop();
+        if (entry.AtGoal)
+            return entry.FirstDirection;
+        if (!visited.insert(GetTileKey(entry.Location)).second)
+            continue;
+
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (entry.Edges & (1 << direction))
+                addCorridor(entry.Location, direction, entry.Steps, entry.FirstDirection);
+        }
+    }
+    return INVALID_DIRECTION;
+}
+
+const FootpathGraph::FlowField* FootpathGraph::GetFlowField(const Destination& destination)
+{
+    auto it = _flowFieldIndex.find(destination);
+    if (it != _flowFieldIndex.end())
+    {
+        _flowFields.splice(_flowFields.begin(), _flowFields, it->second);
+        return &_flowFields.front();
+    }
+
+    // Only destinations that keep being searched for are worth a search over the whole network
+    if (_destinationRequests.size() >= MaxDestinationRequests)
+        _destinationRequests.clear();
+    if (++_destinationRequests[destination] < FlowFieldMinRequests)
+        return nullptr;
+
+    _destinationRequests.erase(destination);
+    _flowFields.push_front(BuildFlowField(destination));
+    _flowFieldIndex.emplace(destination, _flowFields.begin());
+    if (_flowFields.size() > MaxFlowFields)
+    {
+        _flowFieldIndex.erase(_flowFields.back().Dest);
+        _flowFields.pop_back();
+    }
+    return &_flowFields.front();
+}
+
+FootpathGraph::FlowField FootpathGraph::BuildFlowField(const Destination& destination)
+{
+    PROFILED_FUNCTION();
+
+    using OpenEntry = std::pair<uint32_t, TileCoordsXYZ>;
+    auto compare = [](const OpenEntry& a, const OpenEntry& b) { return a.first > b.first; };
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, decltype(compare)> open(compare);
+
+    const auto& goal = destination.Goal;
+    if (map_get_path_element_at(goal) != nullptr)
+    {
+        open.push({ 0, goal });
+    }
+    else
+    {
+        // The goal is an entrance or a shop, start from the paths leading into it, which may slope up towards it
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            for (auto z : { goal.z, goal.z - 2 })
+            {
+                const TileCoordsXYZ pathLoc{ goal.x - TileDirectionDelta[direction].x,
+                                             goal.y - TileDirectionDelta[direction].y, z };
+                const auto* path = map_get_path_element_at(pathLoc);
+                if (path == nullptr || !(path->GetEdges() & (1 << direction)))
+                    continue;
+
+                const auto& corridor = GetCorridor(pathLoc, direction);
+                if (GetReachableLength(corridor, destination) > 0 && corridor.Tiles.front() == goal)
+                    open.push({ 1, pathLoc });
+            }
+        }
+    }
+
+    // Dijkstra outward from the goal. Corridors are one way for guests, so each junction found is checked by walking
+    // the corridor from it back towards the tile it was found from.
+    FlowField flowField{ destination, {} };
+    while (!open.empty() && flowField.Distances.size() <= MaxSearchedJunctions)
+    {
+        const auto [distance, loc] = open.top();
+        open.pop();
+        if (!flowField.Distances.emplace(GetTileKey(loc), distance).second)
+            continue;
+
+        const auto* path = map_get_path_element_at(loc);
+        if (path == nullptr)
+            continue;
+
+        const auto edges = path->GetEdges();
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (!(edges & (1 << direction)))
+                continue;
+
+            const auto& outward = GetCorridor(loc, direction);
+            if (outward.Tiles.empty() || outward.Tiles.back() == loc)
+                continue;
+
+            const auto junction = outward.Tiles.back();
+            if (flowField.Distances.count(GetTileKey(junction)) != 0 || map_get_path_element_at(junction) == nullptr)
+                continue;
+
+            const auto& back = GetCorridor(junction, direction_reverse(outward.EndDirection));
+            const auto length = GetReachableLength(back, destination);
+            for (size_t i = 0; i < length; i++)
+            {
+                if (back.Tiles[i] == loc)
+                {
+                    open.push({ distance + static_cast<uint32_t>(i + 1), junction });
+                    break;
+                }
+            }
+        }
+    }
+    return flowField;
+}
+
+Direction FootpathGraph::LookUpFlowField(const FlowField& flowField, const TileCoordsXYZ& start, uint8_t edges)
+{
+    const auto& goal = flowField.Dest.Goal;
+    Direction bestDirection = INVALID_DIRECTION;
+    uint32_t bestDistance = std::numeric_limits<uint32_t>::max();
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        if (!(edges & (1 << direction)))
+            continue;
+
+        const auto& corridor = GetCorridor(start, direction);
+        const auto length = GetReachableLength(corridor, flowField.Dest);
+        auto distance = std::numeric_limits<uint32_t>::max();
+        auto goalIt = std::find(corridor.Tiles.begin(), corridor.Tiles.begin() + length, goal);
+        if (goalIt != corridor.Tiles.begin() + length)
+        {
+            distance = static_cast<uint32_t>(goalIt - corridor.Tiles.begin()) + 1;
+        }
+        else if (length != 0 && length == corridor.Tiles.size())
+        {
+            auto it = flowField.Distances.find(GetTileKey(corridor.Tiles.back()));
+            if (it != flowField.Distances.end())
+                distance = static_cast<uint32_t>(length) + it->second;
+        }
+
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            bestDirection = direction;
+        }
+    }
+    return bestDirection;
+}
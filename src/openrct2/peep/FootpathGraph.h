@@ -0,0 +1,157 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../ride/RideTypes.h"
+#include "../world/Location.hpp"
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The footpath network as a graph of junctions connected by corridors. A corridor is the run of tiles walked from a
+ * path tile in one direction until the walk reaches a junction (a path tile without exactly two edges), a dead end or
+ * something that is not a path, such as a ride or park entrance.
+ *
+ * Corridors are walked the first time they are needed and kept until a tile they cross, or one next to it, changes.
+ * The footpath actions and the functions that connect path edges call InvalidateTile for the tiles they touch, and
+ * everything is dropped when the map is replaced. Which queue a queue tile belongs to is read from the map on each
+ * search, so chaining a queue to a ride keeps the corridors, but PathElement::SetRideIndex still drops the next hops
+ * and flow fields found with the old owner.
+ *
+ * Unlike the bounded heuristic search, the graph does not treat wide paths differently and has no junction limit, so
+ * guests routed over it can take different (shorter) routes.
+ *
+ * Destinations that many peeps head for, such as popular rides or the park exit, can be given a flow field: the walking
+ * distance to the destination from every junction that can reach it, found with one search outward from the
+ * destination. A peep then only has to look at the corridors leaving its own tile. Flow fields are evicted least
+ * recently used first, and all of them are dropped whenever the graph changes.
+ */
+class FootpathGraph
+{
+public:
+    struct Corridor
+    {
+        // Tiles entered after leaving the start tile, in walking order. The last one is where the corridor ends.
+        std::vector<TileCoordsXYZ> Tiles;
+        // Indices into Tiles of the queue tiles along the corridor that are not junctions
+        std::vector<uint16_t> QueueTiles;
+        // Number of tiles guests can reach before a no entry banner turns them back
+        uint16_t GuestLength{};
+        // Edges to continue on from the end of the corridor, without the one it arrived through
+        uint8_t EndEdges{};
+        // Direction the last tile of the corridor was entered in
+        Direction EndDirection{};
+    };
+
+private:
+    // The goal of a search along with the peep properties that change which corridors can be used to get there
+    struct Destination
+    {
+        TileCoordsXYZ Goal;
+        RideId QueueRideIndex;
+        bool IsStaff;
+        bool IgnoreForeignQueues;
+
+        bool operator==(const Destination& other) const;
+    };
+
+    struct DestinationHash
+    {
+        size_t operator()(const Destination& destination) const;
+    };
+
+    struct NextHopKey
+    {
+        Destination Dest;
+        TileCoordsXYZ Start;
+        uint8_t Edges;
+
+        bool operator==(const NextHopKey& other) const;
+    };
+
+    struct NextHopKeyHash
+    {
+        size_t operator()(const NextHopKey& key) const;
+    };
+
+    struct FlowField
+    {
+        Destination Dest;
+        // Walking distance to the goal from each junction that can reach it, by tile key
+        std::unordered_map<uint64_t, uint32_t> Distances;
+    };
+
+    std::unordered_map<uint64_t, Corridor> _corridors;
+    // Keys of the corridors that cross each tile
+    std::unordered_map<uint32_t, std::vector<uint64_t>> _tileCorridors;
+    // Directions chosen for earlier searches, dropped whenever the graph changes
+    std::unordered_map<NextHopKey, Direction, NextHopKeyHash> _nextHops;
+    // Most recently used first
+    std::list<FlowField> _flowFields;
+    std::unordered_map<Destination, std::list<FlowField>::iterator, DestinationHash> _flowFieldIndex;
+    // Number of searches made for each destination that does not have a flow field yet
+    std::unordered_map<Destination, uint32_t, DestinationHash> _destinationRequests;
+
+    const Corridor& GetCorridor(const TileCoordsXYZ& start, Direction direction);
+    void RegisterCorridor(uint64_t key, const TileCoordsXY& tile);
+    void RemoveCorridor(uint64_t key);
+    size_t GetReachableLength(const Corridor& corridor, const Destination& destination) const;
+    Direction Search(const TileCoordsXYZ& start, uint8_t edges, const Destination& destination);
+    const FlowField* GetFlowField(const Destination& destination);
+    FlowField BuildFlowField(const Destination& destination);
+    Direction LookUpFlowField(const FlowField& flowField, const TileCoordsXYZ& start, uint8_t edges);
+
+public:
+    static FootpathGraph& Get();
+
+    /**
+     * Drops every corridor, they are walked again as they are needed.
+     */
+    void Invalidate();
+
+    /**
+     * Drops the corridors crossing the tile or any of its neighbours.
+     */
+    void InvalidateTile(const CoordsXY& loc);
+
+    /**
+     * Drops the next hops and flow fields found so far, but keeps the corridors. Used for changes that only affect
+     * which corridors a search may use, such as the ride a queue belongs to.
+     */
+    void ClearSearchCaches();
+
+    size_t GetCorridorCount() const
+    {
+        return _corridors.size();
+    }
+
+    size_t GetFlowFieldCount() const
+    {
+        return _flowFields.size();
+    }
+
+    /**
+     * Finds the shortest walk to the goal with A* over the junctions of the graph, and returns the direction of the
+     * given edges of the start tile that it begins with. Returns INVALID_DIRECTION if the goal can not be reached,
+     * leaving the choice to the bounded heuristic search, which still gets peeps closer to it.
+     *
+     * Staff are not stopped by no entry banners. If ignoreForeignQueues is set, corridors are not followed past queue
+     * tiles of other rides than queueRideIndex.
+     *
+     * With useFlowFields set, destinations that keep being searched for get a flow field, which answers all later
+     * searches for them.
+     */
+    Direction ChooseDirection(
+        const TileCoordsXYZ& start, uint8_t edges, const TileCoordsXYZ& goal, bool isStaff, bool ignoreForeignQueues,
+        RideId queueRideIndex, bool useFlowFields);
+};
@@ -9,9 +9,11 @@
 
 #include "GuestPathfinding.h"
 
+#include "../config/Config.h"
 #include "../core/Guard.hpp"
 #include "../entity/Guest.h"
 #include "../entity/Staff.h"
+#include "../network/network.h"
 #include "../profiling/Profiling.h"
 #include "../ride/RideData.h"
 #include "../ride/Station.h"
@@ -20,6 +22,7 @@
 #include "../util/Util.h"
 #include "../world/Entrance.h"
 #include "../world/Footpath.h"
+#include "FootpathGraph.h"
 
 #include <bitset>
 #include <cstring>
@@ -1254,6 +1257,20 @@ static void peep_pathfind_heuristic_search(
     }
 }
 
+/**
+ * Whether the choice between several edges can be made over the footpath graph. Mechanics are kept to the bounded
+ * search as the graph does not know about patrol areas.
+ */
+static bool peep_pathfind_can_use_graph(Peep* peep)
+{
+    if (gConfigGeneral.peep_pathfinding_mode == PeepPathfindingMode::BoundedSearch
+        || network_get_mode() != NETWORK_MODE_NONE)
+        return false;
+
+    auto* staff = peep->As<Staff>();
+    return staff == nullptr || !staff->IsMechanic() || !staff->HasPatrolArea();
+}
+
 /**
  * Returns:
  *   -1   - no direction chosen
@@ -1427,9 +1444,20 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
         return INVALID_DIRECTION;
 
     int32_t chosen_edge = bitscanforward(edges);
+    Direction graphEdge = INVALID_DIRECTION;
+    if ((edges & ~(1 << chosen_edge)) && peep_pathfind_can_use_graph(peep))
+    {
+        graphEdge = FootpathGraph::Get().ChooseDirection(
+            loc, edges, goal, _peepPathFindIsStaff, gPeepPathFindIgnoreForeignQueues, gPeepPathFindQueueRideIndex,
+            gConfigGeneral.peep_pathfinding_mode == PeepPathfindingMode::FlowField);
+    }
 
+    if (graphEdge != INVALID_DIRECTION)
+    {
+        chosen_edge = graphEdge;
+    }
     // Peep has multiple edges still to try.
-    if (edges & ~(1 << chosen_edge))
+    else if (edges & ~(1 << chosen_edge))
     {
         uint16_t best_score = 0xFFFF;
         uint8_t best_sub = 0xFF;
@@ -37,6 +37,18 @@ extern RideId gPeepPathFindQueueRideIndex;
 // In practice, if this is false, gPeepPathFindQueueRideIndex is always RIDE_ID_NULL.
 extern bool gPeepPathFindIgnoreForeignQueues;
 
+// How peep_pathfind_choose_direction picks between several edges, set by peep_pathfinding_mode in the config. The
+// bounded search reproduces the behaviour of existing parks, so it is the default and it is always used in multiplayer.
+enum class PeepPathfindingMode : uint8_t
+{
+    // The original search, limited in the number of junctions and tiles it looks at
+    BoundedSearch,
+    // A* over the cached FootpathGraph, falling back to the bounded search when the goal can not be reached
+    FootpathGraph,
+    // As FootpathGraph, with the destinations that many peeps head for looked up in cached flow fields
+    FlowField,
+};
+
 // Given a peep 'peep' at tile 'loc', who is trying to get to 'gPeepPathFindGoalPosition', decide
 // the direction the peep should walk in from the current tile.
 Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep);
@@ -949,8 +949,8 @@ namespace RCT2
         void ImportRideRatingsCalcData()
         {
             const auto& src = _s6.ride_ratings_calc_data;
-            auto& dst = gRideRatingUpdateState;
-            dst = {};
+            ride_ratings_reset_update_states();
+            auto& dst = gRideRatingUpdateStates[0];
             dst.Proximity = { src.proximity_x, src.proximity_y, src.proximity_z };
             dst.ProximityStart = { src.proximity_start_x, src.proximity_start_y, src.proximity_start_z };
             dst.CurrentRide = RCT12RideIdToOpenRCT2RideId(src.current_ride);
@@ -0,0 +1,111 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "T9Exporter.h"
+
+#include "../core/FileStream.h"
+#include "../core/String.hpp"
+#include "../ride/Ride.h"
+#include "../ride/TrackDesign.h"
+
+#include <cstring>
+#include <string>
+
+namespace RCT2
+{
+    T9Exporter::T9Exporter(const TrackDesign* trackDesign)
+        : _trackDesign(trackDesign)
+    {
+    }
+
+    bool T9Exporter::SaveTrack(const utf8* path)
+    {
+        try
+        {
+            auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_WRITE);
+            return SaveTrack(&fs);
+        }
+        catch (const std::exception& e)
+        {
+            log_error("Unable to save track design: %s", e.what());
+            return false;
+        }
+    }
+
+    bool T9Exporter::SaveTrack(OpenRCT2::IStream* stream)
+    {
+        const auto& td = *_trackDesign;
+        std::string text;
+        auto writeLine = [&text](int64_t value) { text += std::to_string(value) + "\n"; };
+
+        writeLine(td.type);
+        writeLine(td.vehicle_type);
+        writeLine(td.cost);
+        writeLine(td.flags);
+        writeLine(static_cast<uint8_t>(td.ride_mode));
+        writeLine(td.track_flags);
+        writeLine(td.colour_scheme);
+        writeLine(td.entrance_style);
+        writeLine(td.total_air_time);
+        writeLine(td.depart_flags);
+        writeLine(td.number_of_trains);
+        writeLine(td.number_of_cars_per_train);
+        writeLine(td.min_waiting_time);
+        writeLine(td.max_waiting_time);
+        writeLine(td.operation_setting);
+        writeLine(td.max_speed);
+        writeLine(td.average_speed);
+        writeLine(td.ride_length);
+        writeLine(td.max_positive_vertical_g);
+        writeLine(td.max_negative_vertical_g);
+        writeLine(td.max_lateral_g);
+        writeLine(td.type == RIDE_TYPE_MINI_GOLF ? td.holes : td.inversions);
+        writeLine(td.drops);
+        writeLine(td.highest_drop_height);
+        writeLine(td.excitement);
+        writeLine(td.intensity);
+        writeLine(td.nausea);
+        writeLine(td.upkeep_cost);
+        writeLine(td.flags2);
+        // The vehicle object is not part of the format, its flags are always 0
+        writeLine(0);
+        writeLine(td.space_required_x);
+        writeLine(td.space_required_y);
+        writeLine(td.lift_hill_speed);
+        writeLine(td.num_circuits);
+
+        writeLine(td.track_elements.size());
+        for (const auto& trackElement : td.track_elements)
+        {
+            text += String::StdFormat("%d,%d\n", trackElement.type, trackElement.flags);
+        }
+
+        text += "ENT\n";
+        for (const auto& entranceElement : td.entrance_elements)
+        {
+            text += String::StdFormat(
+                "%d,%d,%d,%d\n", entranceElement.z == -1 ? -128 : entranceElement.z,
+                entranceElement.direction | (entranceElement.isExit << 7), entranceElement.x, entranceElement.y);
+        }
+
+        text += "SCEN\n";
+        for (const auto& sceneryElement : td.scenery_elements)
+        {
+            const auto& entry = sceneryElement.scenery_object.Entry;
+            auto name = entry.GetName();
+            text += String::StdFormat(
+                "%d,%d,%d,%d,%u,%s\n", sceneryElement.loc.x / COORDS_XY_STEP, sceneryElement.loc.y / COORDS_XY_STEP,
+                sceneryElement.loc.z / COORDS_Z_STEP, sceneryElement.flags, entry.flags,
+                std::string(name.data(), strnlen(name.data(), name.size())).c_str());
+        }
+
+        stream->Write(text.data(), text.size());
+        return true;
+    }
+} // namespace RCT2
@@ -0,0 +1,39 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../core/String.hpp"
+
+struct TrackDesign;
+
+namespace OpenRCT2
+{
+    struct IStream;
+}
+
+namespace RCT2
+{
+    /**
+     * Class to export track designs in the TD9 text format, see TD9Importer for the layout. Ride and track types are
+     * written as OpenRCT2 types, which is what the importer reads back.
+     */
+    class T9Exporter final
+    {
+    public:
+        T9Exporter(const TrackDesign* trackDesign);
+
+        bool SaveTrack(const utf8* path);
+        bool SaveTrack(OpenRCT2::IStream* stream);
+
+    private:
+        const TrackDesign* _trackDesign;
+    };
+} // namespace RCT2
@@ -8,77 +8,106 @@
  *****************************************************************************/
 
 #include "../TrackImporter.h"
-#include "../config/Config.h"
 #include "../core/FileStream.h"
-#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../core/String.hpp"
-#include "../object/ObjectRepository.h"
-#include "../object/RideObject.h"
-#include "../rct12/SawyerChunkReader.h"
-#include "../rct12/SawyerEncoding.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
+#include "../ride/Track.h"
 #include "../ride/TrackDesign.h"
 #include "../ride/TrackDesignRepository.h"
 
-#include <mutex>
-#include <iostream>
+#include <algorithm>
+#include <cstdlib>
 #include <string>
-#include <sstream>
 #include <vector>
-#include <iterator>
-
-template <typename Out>
-void split(const std::string &s, char delim, Out result) {
-    std::istringstream iss(s);
-    std::string item;
-    while (std::getline(iss, item, delim)) {
-        *result++ = item;
-    }
-}
-
-std::vector<std::string> split(const std::string &s, char delim) {
-    std::vector<std::string> elems;
-    split(s, delim, std::back_inserter(elems));
-    return elems;
-}
-/*#include <boost/lexical_cast.hpp>
-
-template <typename T>
-void Convert(const std::string& source, T& target)
-{
-    target = boost::lexical_cast<T>(source);
-}
-
-template <>
-void Convert(const std::string& source, int8_t& target)
-{
-    int value = boost::lexical_cast<int>(source);
-
-    if(value < std::numeric_limits<int8_t>::min() || value > std::numeric_limits<int8_t>::max())
-    {
-        //handle error
-    }
-    else
-    {
-        target = (int8_t)value;
-    }
-}*/
 
 namespace RCT2
 {
-    static std::mutex _objectLookupMutex;
-
     /**
-     * Class to import RollerCoaster Tycoon 2 track designs (*.TD9).
+     * Class to import track designs in the TD9 text format. A TD9 file has one value per line:
+     *
+     * - 34 header lines holding, in order: ride type, vehicle type, cost, flags, ride mode, track flags, colour scheme,
+     *   entrance style, total air time, departure flags, number of trains, cars per train, minimum waiting time,
+     *   maximum waiting time, operation setting, max speed, average speed, ride length, max positive g, max negative
+     *   g, max lateral g, holes / inversions, drops, highest drop height, excitement, intensity, nausea, upkeep cost,
+     *   flags 2, vehicle object flags, space required x, space required y, lift hill speed and number of circuits.
+     * - the number of track elements, followed by "type,flags" for each track element.
+     * - "ENT" followed by "z,direction,x,y" for each entrance and exit. Exits have bit 7 of the direction set, files
+     *   that do not mark them alternate between entrances and exits.
+     * - "SCEN" followed by "x,y,z,flags,object flags,object name" for each scenery element.
+     *
+     * Ride and track types are OpenRCT2 types, as written by T9Exporter. The vehicle object is not part of the format,
+     * the first loaded vehicle of the ride type is used instead.
      */
     class TD9Importer final : public ITrackImporter
     {
     private:
-        OpenRCT2::MemoryStream _stream;
+        static constexpr size_t NumHeaderLines = 34;
+
+        enum HeaderLine
+        {
+            HEADER_RIDE_TYPE = 0,
+            HEADER_VEHICLE_TYPE = 1,
+            HEADER_COST = 2,
+            HEADER_FLAGS = 3,
+            HEADER_RIDE_MODE = 4,
+            HEADER_TRACK_FLAGS = 5,
+            HEADER_COLOUR_SCHEME = 6,
+            HEADER_ENTRANCE_STYLE = 7,
+            HEADER_TOTAL_AIR_TIME = 8,
+            HEADER_DEPART_FLAGS = 9,
+            HEADER_NUMBER_OF_TRAINS = 10,
+            HEADER_CARS_PER_TRAIN = 11,
+            HEADER_MIN_WAITING_TIME = 12,
+            HEADER_MAX_WAITING_TIME = 13,
+            HEADER_OPERATION_SETTING = 14,
+            HEADER_MAX_SPEED = 15,
+            HEADER_AVERAGE_SPEED = 16,
+            HEADER_RIDE_LENGTH = 17,
+            HEADER_MAX_POSITIVE_VERTICAL_G = 18,
+            HEADER_MAX_NEGATIVE_VERTICAL_G = 19,
+            HEADER_MAX_LATERAL_G = 20,
+            HEADER_INVERSIONS = 21,
+            HEADER_DROPS = 22,
+            HEADER_HIGHEST_DROP_HEIGHT = 23,
+            HEADER_EXCITEMENT = 24,
+            HEADER_INTENSITY = 25,
+            HEADER_NAUSEA = 26,
+            HEADER_UPKEEP_COST = 27,
+            HEADER_FLAGS2 = 28,
+            HEADER_LIFT_HILL_SPEED = 32,
+            HEADER_NUM_CIRCUITS = 33,
+        };
+
         std::string _name;
-		std::string _path;
+        std::vector<std::string> _lines;
+
+        static int32_t ParseValue(const std::string& value)
+        {
+            // Values are written like C literals, so they may also be hexadecimal. Flags can use all 32 bits.
+            return static_cast<int32_t>(std::strtoll(value.c_str(), nullptr, 0));
+        }
+
+        static std::vector<std::string> SplitValues(const std::string& line, size_t minValues)
+        {
+            auto values = String::Split(line, ",");
+            if (values.size() < minValues)
+            {
+                throw IOException("Invalid TD9 element: " + line);
+            }
+            return values;
+        }
+
+        size_t FindSection(const char* name, size_t start) const
+        {
+            for (size_t i = start; i < _lines.size(); i++)
+            {
+                if (_lines[i] == name)
+                    return i;
+            }
+            return _lines.size();
+        }
 
     public:
         TD9Importer()
@@ -90,459 +119,151 @@ namespace RCT2
             const auto extension = Path::GetExtension(path);
             if (String::Equals(extension, ".td9", true))
             {
-				_path = path;
                 _name = GetNameFromTrackPath(path);
-                auto fs = OpenRCT2::FileStream("/Applications/Games/RollerCoaster Tycoon 2.app/Contents/Resources/drive_c/Program Files/RollerCoaster Tycoon 2/Utilities/tracksorter/Tracks/Miner's revenge.TD6", OpenRCT2::FILE_MODE_OPEN);
+                auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_OPEN);
                 return LoadFromStream(&fs);
             }
 
-            throw std::runtime_error("Invalid RCT2 track extension.");
+            throw std::runtime_error("Invalid TD9 track extension.");
         }
 
         bool LoadFromStream(OpenRCT2::IStream* stream) override
         {
-            if (!gConfigGeneral.allow_loading_with_incorrect_checksum
-                && SawyerEncoding::ValidateTrackChecksum(stream) != RCT12TrackDesignVersion::TD6)
+            std::string text(stream->GetLength() - stream->GetPosition(), '\0');
+            stream->Read(text.data(), text.size());
+
+            _lines.clear();
+            for (const auto& line : String::Split(text, "\n"))
             {
-                throw IOException("Invalid checksum.");
+                auto trimmed = String::Trim(line);
+                if (!trimmed.empty())
+                {
+                    _lines.push_back(std::move(trimmed));
+                }
+            }
+            if (_lines.size() < NumHeaderLines)
+            {
+                throw IOException("TD9 header is incomplete.");
             }
-
-            auto chunkReader = SawyerChunkReader(stream);
-            auto data = chunkReader.ReadChunkTrack();
-            _stream.WriteArray<const uint8_t>(reinterpret_cast<const uint8_t*>(data->GetData()), data->GetLength());
-            _stream.SetPosition(0);
             return true;
         }
 
         std::unique_ptr<TrackDesign> Import() override
         {
-            std::unique_ptr<TrackDesign> td = std::make_unique<TrackDesign>();
-
-            TD6Track td6{};
-            // Rework td6 so that it is just the fields
-            _stream.Read(&td6, 0xA3);
-			
-			///new
-			
-			std::ifstream in(_path);
-			std::string str;
-			std::vector<std::string> lines;
-			while (std::getline(in, str))
-			{
-				//std::cout<<str<<"\n";
-			    if(str.size() > 0)
-			        lines.push_back(str);
-			}
-			in.close();
-			
-			short type2;
-			std::vector<short> conv_lines;
-			int k = 0;
-			for (std::string line : lines)
-			{
-				const char *c = line.c_str();
-				sscanf(c, "%hi", &type2);	
-				conv_lines.push_back(type2);	
-				k += 1;
-				//std::cout<<type2<<":"<<k<<"\n";
-				if (k == 33)
-					break;		
-			}
-			//std::cout<<"T1:"<<td->type<<"\n";
-			td->type = (uint8_t)(conv_lines[0]);
-			
-			/*td->type = (uint8_t)(conv_lines[0]);
-			td->vehicle_type = (uint8_t)(conv_lines[1]);
-			td->cost = (uint8_t)(conv_lines[2]);
-			td->flags = (uint8_t)(conv_lines[3]);
-			td->ride_mode = (RideMode)(conv_lines[4]);
-			td->track_flags = (uint8_t)(conv_lines[5]);
-			td->colour_scheme = (uint8_t)(conv_lines[6]);
-			td->entrance_style = (uint8_t)(conv_lines[7]);
-			td->total_air_time = (uint8_t)(conv_lines[8]);
-			td->depart_flags = (uint8_t)(conv_lines[9]);
-			td->number_of_trains = (uint8_t)(conv_lines[10]);
-			td->number_of_cars_per_train = (uint8_t)(conv_lines[11]);
-			td->min_waiting_time = (uint8_t)(conv_lines[12]);
-			td->max_waiting_time = (uint8_t)(conv_lines[13]);
-			td->operation_setting = (uint8_t)(conv_lines[14]);
-			td->max_speed = (uint8_t)(conv_lines[15]);
-			td->average_speed = (uint8_t)(conv_lines[16]);
-			td->ride_length = (uint8_t)(conv_lines[17]);
-			td->max_positive_vertical_g = (uint8_t)(conv_lines[18]);
-			td->max_negative_vertical_g = (uint8_t)(conv_lines[19]);
-			td->max_lateral_g = (uint8_t)(conv_lines[20]);
-			//td->holes_inversions = (uint8_t)(conv_lines[21]);
-			td->drops = (uint8_t)(conv_lines[22]);
-			td->highest_drop_height = (uint8_t)(conv_lines[23]);
-			td->excitement = (uint8_t)(conv_lines[24]);
-			td->intensity = (uint8_t)(conv_lines[25]);
-			td->nausea = (uint8_t)(conv_lines[26]);
-			td->upkeep_cost = (uint8_t)(conv_lines[27]);
-			td->flags2 = (uint8_t)(conv_lines[28]);
-			rct_object_entry entry{};
-			entry.flags = (uint8_t)(conv_lines[29]);
-			td->vehicle_object = ObjectEntryDescriptor(entry);
-			td->space_required_x = 255; //(uint8_t)(conv_lines[30]);
-			td->space_required_y = 255; //(uint8_t)(conv_lines[31]);
-			td->lift_hill_speed = (uint8_t)(conv_lines[32]);
-			td->num_circuits = (uint8_t)(conv_lines[33]);*/
-			td->name = "Test";
+            auto td = std::make_unique<TrackDesign>();
+            auto header = [this](HeaderLine line) { return ParseValue(_lines[line]); };
 
-			int ent = 0;
-			for (size_t j = 34; j < lines.size(); j ++)
-			{
-				if (lines[j] == "ENT")
-				{
-					ent = j;
-					break;
-				}
-			}
-			
-			for (size_t j = 34; j < ent; j ++)
-			{ // track elements
-				//std::cout<<"track elem " << j << "\n";				
-                rct_td46_track_element t6TrackElement{};
-				
-				// split at comma then convert to uint8_t
-				size_t pos = 0;
-				std::string token;
-				std::string s = lines[j];
-				pos = s.find(',');
-				if (pos == std::string::npos)
-				{
-					//assert(false);
-					continue;
-				}
-			    token = s.substr(0, pos);
-				// convert token
-				const char *c = token.c_str();
-				short type;
-				sscanf(c, "%hi", &type);	
-				t6TrackElement.type = (uint8_t)type;
-				
-				s.erase(0, pos + 1);
-				// convert s
-				const char *d = s.c_str();
-				sscanf(d, "%hi", &type);
-				t6TrackElement.flags = (uint8_t)type;	
-								
-                //_stream.SetPosition(_stream.GetPosition() - 1);
-                //_stream.Read(&t6TrackElement, sizeof(rct_td46_track_element));
-                
-				TrackDesignTrackElement trackElement{};
-                track_type_t trackType = RCT2TrackTypeToOpenRCT2(t6TrackElement.type, td->type, true);
-                if (trackType == TrackElemType::InvertedUp90ToFlatQuarterLoopAlias)
-                {
-                    trackType = TrackElemType::MultiDimInvertedUp90ToFlatQuarterLoop;
-                }
-                trackElement.type = trackType;
-                trackElement.flags = t6TrackElement.flags;
-                td->track_elements.push_back(trackElement);	
-			}
-			bool isExit = false;
-			for (size_t j = ent; j < lines.size(); j ++)
-			{
-				ent = j;
-				if (lines[j] == "ENT")
-					continue;
-				if (lines[j] == "SCEN")
-					break;
-                TrackDesignEntranceElement entranceElement{};
-                
-				std::vector<std::string> vals = split(lines[j], ',');
-				//std::cout<<"val0:"<<vals[0]<<"\n";
-				
-				//size_t pos = 0;
-				//std::string token;
-				//std::string s = lines[j];
-				//pos = s.find(',');
-			    //token = s.substr(0, pos);
-				// convert token
-				const char *c = vals[0].c_str();
-				signed char type;
-				sscanf(c, "%hhi", &type);	
-				
-				//entranceElement.z = (int8_t)type;
-				entranceElement.z = (uint8_t)type;
-				//entranceElement.z = (entranceElement.z == -128) ? -1 : entranceElement.z;
-				
-				//s.erase(0, pos + 1);
-				//pos = s.find(',');
-			    //token = s.substr(0, pos);
-				
-				// convert s
-				c = vals[1].c_str();
-				unsigned char type2;
-				//sscanf(c, "%hhu", &type2);
-				sscanf(c, "%hi", &type2);
-				entranceElement.direction = (uint8_t)type2;	
-				uint8_t dir_cpy = (uint8_t)type2;
-                //entranceElement.direction = entranceElement.direction & 0x7F;
-				
-				//s.erase(0, pos + 1);
-				//pos = s.find(',');
-			    //token = s.substr(0, pos);
-				
-				// convert s
-				c = vals[2].c_str();
-				short type3;
-				sscanf(c, "%hi", &type3);
-				//entranceElement.x = (int16_t)type3;	
-				entranceElement.x = (uint8_t)type3;	
-				
-				//s.erase(0, pos + 1);
-				//pos = s.find(',');
-			    //token = s.substr(0, pos);
-				
-				// convert s
-				c = vals[3].c_str();
-				short type4;
-				sscanf(c, "%hi", &type4);
-				//entranceElement.y = (int16_t)type4;	
-				entranceElement.y = (uint8_t)type4;	
-				
-                //entranceElement.isExit = dir_cpy >> 7;
-				
-				//entranceElement.z = (t6EntranceElement.z == -128) ? -1 : t6EntranceElement.z;
-                //entranceElement.direction = t6EntranceElement.direction & 0x7F;
-                //entranceElement.x = t6EntranceElement.x;
-                //entranceElement.y = t6EntranceElement.y;
-				
-				
-                entranceElement.isExit = isExit; // t6EntranceElement.direction >> 7;
-				isExit = !isExit;
-                td->entrance_elements.push_back(entranceElement);
-			}
-			for (size_t j = ent; j < lines.size(); j ++)
-			{
-				if (lines[j] == "SCEN")
-					continue;
-				                
-				std::vector<std::string> vals = split(lines[j], ',');
-				
-                //TD6SceneryElement t6SceneryElement{};
-                //_stream.Read(&t6SceneryElement, sizeof(TD6SceneryElement));
-                TrackDesignSceneryElement sceneryElement{};
-                //sceneryElement.scenery_object = ObjectEntryDescriptor(t6SceneryElement.scenery_object);
-				
-				const char *c = vals[0].c_str();
-				unsigned char type;
-				sscanf(c, "%hhi", &type);				
-                sceneryElement.loc.x = (int8_t)type * COORDS_XY_STEP;
-				
-				c = vals[1].c_str();
-				unsigned char type2;
-				sscanf(c, "%hhi", &type2);
-                sceneryElement.loc.y = (int8_t)type2 * COORDS_XY_STEP;
-				
-				c = vals[2].c_str();
-				unsigned char type3;
-				sscanf(c, "%hhi", &type3);				
-                sceneryElement.loc.z = (int8_t)type3 * COORDS_Z_STEP;
-
-				c = vals[3].c_str();
-				unsigned char type4;
-				sscanf(c, "%hhi", &type4);				
-                sceneryElement.flags = (uint8_t)type4;
-				
-				rct_object_entry entry{};
-				c = vals[4].c_str();
-				unsigned char type5;
-				sscanf(c, "%hhi", &type5);				
-				entry.flags = (uint8_t)type5;
-				
-				if (vals[5][vals[5].size()-1] == ' ' || vals[5][vals[5].size()-1] == '\n')
-				{
-					vals[5].pop_back();
-				}
-				
-				entry.SetName(vals[5]);
-				//strcpy(entry.name, vals[5].c_str());
-				
-				std::cout<<"name:<"<<entry.GetName()<<">\n";
-				
-				sceneryElement.scenery_object = ObjectEntryDescriptor(entry);
-				
-                //sceneryElement.primary_colour = t6SceneryElement.primary_colour;
-                //sceneryElement.secondary_colour = t6SceneryElement.secondary_colour;
-                td->scenery_elements.push_back(std::move(sceneryElement));
-				
-				/*      rct_object_entry scenery_object; // 0x00 ? 
-				        int8_t x;                        // 0x10
-				        int8_t y;                        // 0x11
-				        int8_t z;                        // 0x12
-				        uint8_t flags;                   // 0x13 direction quadrant tertiary colour
-				        uint8_t primary_colour;          // 0x14
-				        uint8_t secondary_colour;        // 0x15
-				*/
-			}
-			
-            td->vehicle_type = td6.vehicle_type;
-
-            td->cost = 0;
-            td->flags = td6.flags;
-            td->ride_mode = static_cast<RideMode>(td6.ride_mode);
-            td->track_flags = 0;
-            td->colour_scheme = td6.version_and_colour_scheme & 0x3;
-            for (auto i = 0; i < Limits::MaxTrainsPerRide; ++i)
+            td->type = static_cast<uint8_t>(header(HEADER_RIDE_TYPE));
+            if (td->type >= RIDE_TYPE_COUNT)
             {
-                td->vehicle_colours[i] = td6.vehicle_colours[i];
-                td->vehicle_additional_colour[i] = td6.vehicle_additional_colour[i];
+                throw IOException("Invalid TD9 ride type.");
             }
-            td->entrance_style = td6.entrance_style;
-            td->total_air_time = td6.total_air_time;
-            td->depart_flags = td6.depart_flags;
-            td->number_of_trains = td6.number_of_trains;
-            td->number_of_cars_per_train = td6.number_of_cars_per_train;
-            td->min_waiting_time = td6.min_waiting_time;
-            td->max_waiting_time = td6.max_waiting_time;
-            td->operation_setting = td6.operation_setting;
-            td->max_speed = td6.max_speed;
-            td->average_speed = td6.average_speed;
-            td->ride_length = td6.ride_length;
-            td->max_positive_vertical_g = td6.max_positive_vertical_g;
-            td->max_negative_vertical_g = td6.max_negative_vertical_g;
-            td->max_lateral_g = td6.max_lateral_g;
-
+            td->vehicle_type = static_cast<uint8_t>(header(HEADER_VEHICLE_TYPE));
+            td->cost = header(HEADER_COST);
+            td->flags = static_cast<uint32_t>(header(HEADER_FLAGS));
+            td->ride_mode = static_cast<RideMode>(header(HEADER_RIDE_MODE));
+            td->track_flags = static_cast<uint8_t>(header(HEADER_TRACK_FLAGS));
+            td->colour_scheme = static_cast<uint8_t>(header(HEADER_COLOUR_SCHEME) & 0x3);
+            td->entrance_style = static_cast<uint8_t>(header(HEADER_ENTRANCE_STYLE));
+            td->total_air_time = static_cast<uint8_t>(header(HEADER_TOTAL_AIR_TIME));
+            td->depart_flags = static_cast<uint8_t>(header(HEADER_DEPART_FLAGS));
+            td->number_of_trains = static_cast<uint8_t>(header(HEADER_NUMBER_OF_TRAINS));
+            td->number_of_cars_per_train = static_cast<uint8_t>(header(HEADER_CARS_PER_TRAIN));
+            td->min_waiting_time = static_cast<uint8_t>(header(HEADER_MIN_WAITING_TIME));
+            td->max_waiting_time = static_cast<uint8_t>(header(HEADER_MAX_WAITING_TIME));
+            td->operation_setting = std::min(
+                static_cast<uint8_t>(header(HEADER_OPERATION_SETTING)),
+                GetRideTypeDescriptor(td->type).OperatingSettings.MaxValue);
+            td->max_speed = static_cast<int8_t>(header(HEADER_MAX_SPEED));
+            td->average_speed = static_cast<int8_t>(header(HEADER_AVERAGE_SPEED));
+            td->ride_length = static_cast<uint16_t>(header(HEADER_RIDE_LENGTH));
+            td->max_positive_vertical_g = static_cast<uint8_t>(header(HEADER_MAX_POSITIVE_VERTICAL_G));
+            td->max_negative_vertical_g = static_cast<int8_t>(header(HEADER_MAX_NEGATIVE_VERTICAL_G));
+            td->max_lateral_g = static_cast<uint8_t>(header(HEADER_MAX_LATERAL_G));
             if (td->type == RIDE_TYPE_MINI_GOLF)
             {
-                td->holes = td6.holes;
+                td->holes = static_cast<uint8_t>(header(HEADER_INVERSIONS));
             }
             else
             {
-                td->inversions = td6.inversions;
+                td->inversions = static_cast<uint8_t>(header(HEADER_INVERSIONS));
             }
-
-            td->drops = td6.drops;
-            td->highest_drop_height = td6.highest_drop_height;
-            td->excitement = td6.excitement;
-            td->intensity = td6.intensity;
-            td->nausea = td6.nausea;
-            td->upkeep_cost = td6.upkeep_cost;
-            for (auto i = 0; i < Limits::NumColourSchemes; ++i)
+            td->drops = static_cast<uint8_t>(header(HEADER_DROPS));
+            td->highest_drop_height = static_cast<uint8_t>(header(HEADER_HIGHEST_DROP_HEIGHT));
+            td->excitement = static_cast<uint8_t>(header(HEADER_EXCITEMENT));
+            td->intensity = static_cast<uint8_t>(header(HEADER_INTENSITY));
+            td->nausea = static_cast<uint8_t>(header(HEADER_NAUSEA));
+            td->upkeep_cost = static_cast<money16>(header(HEADER_UPKEEP_COST));
+            td->flags2 = static_cast<uint32_t>(header(HEADER_FLAGS2));
+            td->lift_hill_speed = static_cast<uint8_t>(header(HEADER_LIFT_HILL_SPEED) & 0b00011111);
+            td->num_circuits = static_cast<uint8_t>(header(HEADER_NUM_CIRCUITS));
+            // Leaves the space required to be calculated when the design is placed
+            td->space_required_x = 255;
+            td->space_required_y = 255;
+            td->name = _name;
+
+            auto entrances = FindSection("ENT", NumHeaderLines);
+            auto scenery = FindSection("SCEN", entrances);
+
+            for (size_t i = NumHeaderLines; i < entrances; i++)
             {
-                td->track_spine_colour[i] = td6.track_spine_colour[i];
-                td->track_rail_colour[i] = td6.track_rail_colour[i];
-                td->track_support_colour[i] = td6.track_support_colour[i];
-            }
-            td->flags2 = td6.flags2;
-            td->vehicle_object = ObjectEntryDescriptor(td6.vehicle_object);
-            td->space_required_x = td6.space_required_x;
-            td->space_required_y = td6.space_required_y;
-            td->lift_hill_speed = td6.lift_hill_speed_num_circuits & 0b00011111;
-            td->num_circuits = td6.lift_hill_speed_num_circuits >> 5;
-			
-			
-
-            auto version = static_cast<RCT12TrackDesignVersion>((td6.version_and_colour_scheme >> 2) & 3);
-            if (version != RCT12TrackDesignVersion::TD6)
-            {
-				std::cout<<"unsupp\n";
-                log_error("Unsupported track design.");
-                return nullptr;
-            }
-
-            td->operation_setting = std::min(td->operation_setting, GetRideTypeDescriptor(td->type).OperatingSettings.MaxValue);
-
-            /*if (td->type == RIDE_TYPE_MAZE)
-            {
-                rct_td46_maze_element t6MazeElement{};
-                t6MazeElement.all = !0;
-                while (t6MazeElement.all != 0)
+                // Anything else between the header and the entrances, such as the element count, is not a track element
+                auto values = String::Split(_lines[i], ",");
+                if (values.size() < 2)
+                    continue;
+
+                TrackDesignTrackElement trackElement{};
+                trackElement.type = static_cast<track_type_t>(ParseValue(values[0]));
+                if (trackElement.type >= TrackElemType::Count)
                 {
-                    _stream.Read(&t6MazeElement, sizeof(rct_td46_maze_element));
-                    if (t6MazeElement.all != 0)
-                    {
-                        TrackDesignMazeElement mazeElement{};
-                        mazeElement.x = t6MazeElement.x;
-                        mazeElement.y = t6MazeElement.y;
-                        mazeElement.direction = t6MazeElement.direction;
-                        mazeElement.type = t6MazeElement.type;
-                        td->maze_elements.push_back(mazeElement);
-                    }
+                    throw IOException("Invalid TD9 track type: " + _lines[i]);
                 }
+                trackElement.flags = static_cast<uint8_t>(ParseValue(values[1]));
+                td->track_elements.push_back(trackElement);
             }
-            else
-            {*/
-            rct_td46_track_element t6TrackElement{};
-            for (uint8_t endFlag = _stream.ReadValue<uint8_t>(); endFlag != 0xFF; endFlag = _stream.ReadValue<uint8_t>())
-            {
-                _stream.SetPosition(_stream.GetPosition() - 1);
-                _stream.Read(&t6TrackElement, sizeof(rct_td46_track_element));
-                //TrackDesignTrackElement trackElement{};
-
-                //track_type_t trackType = RCT2TrackTypeToOpenRCT2(t6TrackElement.type, td->type, true);
-                //if (trackType == TrackElemType::InvertedUp90ToFlatQuarterLoopAlias)
-                //{
-                //    trackType = TrackElemType::MultiDimInvertedUp90ToFlatQuarterLoop;
-				//}
 
-                //trackElement.type = trackType;
-                //trackElement.flags = t6TrackElement.flags;
-                //td->track_elements.push_back(trackElement);
+            std::vector<std::vector<std::string>> entranceValues;
+            for (size_t i = entrances + 1; i < scenery; i++)
+            {
+                entranceValues.push_back(SplitValues(_lines[i], 4));
             }
-			/*
-            TD6EntranceElement t6EntranceElement{};
-            for (uint8_t endFlag = _stream.ReadValue<uint8_t>(); endFlag != 0xFF; endFlag = _stream.ReadValue<uint8_t>())
+            const bool exitsMarked = std::any_of(entranceValues.begin(), entranceValues.end(), [](const auto& values) {
+                return (ParseValue(values[1]) & 0x80) != 0;
+            });
+            for (size_t i = 0; i < entranceValues.size(); i++)
             {
-                _stream.SetPosition(_stream.GetPosition() - 1);
-                _stream.Read(&t6EntranceElement, sizeof(TD6EntranceElement));
+                const auto& values = entranceValues[i];
+                auto z = static_cast<int8_t>(ParseValue(values[0]));
+                auto direction = ParseValue(values[1]);
+
                 TrackDesignEntranceElement entranceElement{};
-                entranceElement.z = (t6EntranceElement.z == -128) ? -1 : t6EntranceElement.z;
-                entranceElement.direction = t6EntranceElement.direction & 0x7F;
-                entranceElement.x = t6EntranceElement.x;
-                entranceElement.y = t6EntranceElement.y;
-                entranceElement.isExit = t6EntranceElement.direction >> 7;
+                entranceElement.z = (z == -128) ? -1 : z;
+                entranceElement.direction = static_cast<uint8_t>(direction & 0x7F);
+                entranceElement.x = static_cast<int16_t>(ParseValue(values[2]));
+                entranceElement.y = static_cast<int16_t>(ParseValue(values[3]));
+                entranceElement.isExit = exitsMarked ? (direction & 0x80) != 0 : (i % 2) != 0;
                 td->entrance_elements.push_back(entranceElement);
-            }*/
-			
-			/*}
+            }
 
-            for (uint8_t endFlag = _stream.ReadValue<uint8_t>(); endFlag != 0xFF; endFlag = _stream.ReadValue<uint8_t>())
+            for (size_t i = scenery + 1; i < _lines.size(); i++)
             {
-                _stream.SetPosition(_stream.GetPosition() - 1);
-                TD6SceneryElement t6SceneryElement{};
-                _stream.Read(&t6SceneryElement, sizeof(TD6SceneryElement));
+                auto values = SplitValues(_lines[i], 6);
+
+                rct_object_entry entry{};
+                entry.flags = static_cast<uint32_t>(ParseValue(values[4]));
+                entry.SetName(String::Trim(values[5]));
+
                 TrackDesignSceneryElement sceneryElement{};
-                sceneryElement.scenery_object = ObjectEntryDescriptor(t6SceneryElement.scenery_object);
-                sceneryElement.loc.x = t6SceneryElement.x * COORDS_XY_STEP;
-                sceneryElement.loc.y = t6SceneryElement.y * COORDS_XY_STEP;
-                sceneryElement.loc.z = t6SceneryElement.z * COORDS_Z_STEP;
-                sceneryElement.flags = t6SceneryElement.flags;
-                sceneryElement.primary_colour = t6SceneryElement.primary_colour;
-                sceneryElement.secondary_colour = t6SceneryElement.secondary_colour;
+                sceneryElement.scenery_object = ObjectEntryDescriptor(entry);
+                sceneryElement.loc.x = static_cast<int8_t>(ParseValue(values[0])) * COORDS_XY_STEP;
+                sceneryElement.loc.y = static_cast<int8_t>(ParseValue(values[1])) * COORDS_XY_STEP;
+                sceneryElement.loc.z = static_cast<int8_t>(ParseValue(values[2])) * COORDS_Z_STEP;
+                sceneryElement.flags = static_cast<uint8_t>(ParseValue(values[3]));
                 td->scenery_elements.push_back(std::move(sceneryElement));
             }
 
-            td->name = _name;*/
-
-			//std::cout<<"T2:"<<td->type<<"\n";
-
-            UpdateRideType(td);
-			//std::cout<<"T3:"<<td->type<<"\n";
-
             return td;
         }
-
-        void UpdateRideType(std::unique_ptr<TrackDesign>& td)
-        {
-            if (RCT2RideTypeNeedsConversion(td->type))
-            {
-                std::scoped_lock<std::mutex> lock(_objectLookupMutex);
-                auto rawObject = object_repository_load_object(&td->vehicle_object.Entry);
-                if (rawObject != nullptr)
-                {
-                    const auto* rideEntry = static_cast<const rct_ride_entry*>(
-                        static_cast<RideObject*>(rawObject.get())->GetLegacyData());
-                    if (rideEntry != nullptr)
-                    {
-                        td->type = RCT2RideTypeToOpenRCT2RideType(td->type, rideEntry);
-                    }
-                    rawObject->Unload();
-                }
-            }
-        }
     };
 } // namespace RCT2
 
@@ -13,6 +13,7 @@
 #include "../Context.h"
 #include "../Editor.h"
 #include "../Game.h"
+#include "../GameState.h"
 #include "../Input.h"
 #include "../OpenRCT2.h"
 #include "../actions/RideSetSettingAction.h"
@@ -901,6 +902,21 @@ void ride_init_all()
     _rides.shrink_to_fit();
 }
 
+std::vector<Ride> CreateRidesCheckpoint()
+{
+    auto checkpoint = _rides;
+    for (auto& ride : checkpoint)
+    {
+        ride.measurement = {};
+    }
+    return checkpoint;
+}
+
+void RestoreRidesCheckpoint(const std::vector<Ride>& checkpoint)
+{
+    _rides = checkpoint;
+}
+
 /**
  *
  *  rct2: 0x006B7A38
@@ -1363,6 +1379,12 @@ static void ride_breakdown_update(Ride* ride)
     ride->reliability = static_cast<uint16_t>(std::max(0, (ride->reliability - unreliabilityAccumulator)));
     ride->window_invalidate_flags |= RIDE_INVALIDATE_RIDE_MAINTENANCE;
 
+    // Guests and the park draw from the same random numbers as the breakdowns, so a test run only simulation that
+    // skips them would break rides down at different times than the full simulation does. Its test results only have
+    // to match the full simulation's for a ride that does not break down, so it does not roll for breakdowns at all.
+    if (!GetContext()->GetGameState()->IsFullSimulation())
+        return;
+
     // Random probability of a breakdown. Roughly this is 1 in
     //
     // (25000 - reliability) / 3 000 000
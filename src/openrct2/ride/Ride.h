@@ -288,9 +288,12 @@ public:
     uint16_t holes;
     uint8_t sheltered_eighths;
 
-    std::unique_ptr<RideMeasurement> measurement;
+    // Shared rather than unique so rides can be copied into a game state checkpoint
+    std::shared_ptr<RideMeasurement> measurement;
 
 private:
+    friend uint32_t vehicle_update_test_run(Ride& ride, uint32_t maxTicks);
+
     void Update();
     void UpdateChairlift();
     void UpdateSpiralSlide();
@@ -978,6 +981,13 @@ extern ObjectEntryIndex gLastEntranceStyle;
 
 int32_t ride_get_count();
 void ride_init_all();
+
+/**
+ * Copies all rides so they can be put back with RestoreRidesCheckpoint. Measurements are only used by the ride window
+ * and are left out, they are recorded again from the next test run.
+ */
+std::vector<Ride> CreateRidesCheckpoint();
+void RestoreRidesCheckpoint(const std::vector<Ride>& checkpoint);
 void reset_all_ride_build_dates();
 void ride_update_favourited_stat();
 void ride_check_all_reachable();
@@ -19,6 +19,7 @@
 #include "../common.h"
 #include "../entity/EntityList.h"
 #include "../entity/EntityRegistry.h"
+#include "../entity/GuestNeeds.h"
 #include "../entity/Staff.h"
 #include "../interface/Window.h"
 #include "../localisation/Date.h"
@@ -311,6 +312,7 @@ void Ride::RemovePeeps()
             peep->Happiness = std::min(peep->Happiness, peep->HappinessTarget) / 2;
             peep->HappinessTarget = peep->Happiness;
             peep->WindowInvalidateFlags |= PEEP_INVALIDATE_PEEP_STATS;
+            GuestNeeds::Get().Update(*peep);
         }
     }
     // Place all the staff at exit
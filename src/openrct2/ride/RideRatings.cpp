@@ -26,22 +26,10 @@
 
 #include <algorithm>
 #include <iterator>
-#include <iostream>
-#include <fstream>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Scripting;
 
-enum
-{
-    RIDE_RATINGS_STATE_FIND_NEXT_RIDE,
-    RIDE_RATINGS_STATE_INITIALISE,
-    RIDE_RATINGS_STATE_2,
-    RIDE_RATINGS_STATE_CALCULATE,
-    RIDE_RATINGS_STATE_4,
-    RIDE_RATINGS_STATE_5
-};
-
 enum
 {
     PROXIMITY_WATER_OVER,                   // 0x0138B596
@@ -79,7 +67,8 @@ struct ShelteredEights
     uint8_t TotalShelteredEighths;
 };
 
-RideRatingUpdateState gRideRatingUpdateState;
+RideRatingUpdateStates gRideRatingUpdateStates;
+uint8_t gRideRatingUpdateBudget = RideRatingDefaultUpdateBudget;
 
 static void ride_ratings_update_state(RideRatingUpdateState& state);
 static void ride_ratings_update_state_0(RideRatingUpdateState& state);
@@ -95,6 +84,47 @@ static void ride_ratings_score_close_proximity(RideRatingUpdateState& state, Til
 
 static void ride_ratings_add(RatingTuple* rating, int32_t excitement, int32_t intensity, int32_t nausea);
 
+static void ride_ratings_reset_update_state(RideRatingUpdateState& state)
+{
+    state = {};
+    state.State = RIDE_RATINGS_STATE_FIND_NEXT_RIDE;
+    state.CurrentRide = RideId::GetNull();
+}
+
+void ride_ratings_reset_update_states()
+{
+    for (auto& state : gRideRatingUpdateStates)
+    {
+        ride_ratings_reset_update_state(state);
+    }
+    gRideRatingUpdateBudget = RideRatingDefaultUpdateBudget;
+}
+
+static bool ride_ratings_is_updating_ride(RideId id)
+{
+    return std::any_of(std::begin(gRideRatingUpdateStates), std::end(gRideRatingUpdateStates), [id](auto& state) {
+        return state.CurrentRide == id && state.State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE;
+    });
+}
+
+/**
+ * Steps the given update state through the whole circuit of the ride, from initialising to the point where it would
+ * look for the next ride. Returns whether the ratings of the ride have been calculated.
+ */
+static bool ride_ratings_update_ride_state(RideRatingUpdateState& state, const Ride& ride)
+{
+    state.CurrentRide = ride.id;
+    state.State = RIDE_RATINGS_STATE_INITIALISE;
+    bool calculated = false;
+    while (state.State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
+    {
+        // The calculate state gives up on rides that have been closed in the meantime
+        calculated = state.State == RIDE_RATINGS_STATE_CALCULATE && ride.status != RideStatus::Closed;
+        ride_ratings_update_state(state);
+    }
+    return calculated;
+}
+
 /**
  * This is a small hack function to keep calling the ride rating processor until
  * the given ride's ratings have been calculated. What ever is currently being
@@ -106,15 +136,25 @@ void ride_ratings_update_ride(const Ride& ride)
     RideRatingUpdateState state;
     if (ride.status != RideStatus::Closed)
     {
-        state.CurrentRide = ride.id;
-        state.State = RIDE_RATINGS_STATE_INITIALISE;
-        while (state.State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
-        {
-            ride_ratings_update_state(state);
-        }
+        ride_ratings_update_ride_state(state, ride);
     }
 }
 
+std::optional<RideRatingResult> RideRatings::ComputeNow(Ride& ride)
+{
+    RideRatingUpdateState state{};
+    if (!ride_ratings_update_ride_state(state, ride))
+        return std::nullopt;
+
+    RideRatingResult result{};
+    result.Ratings = ride.ratings;
+    result.ProximityTotal = state.ProximityTotal;
+    std::copy(std::begin(state.ProximityScores), std::end(state.ProximityScores), result.ProximityScores);
+    result.AmountOfBrakes = state.AmountOfBrakes;
+    result.AmountOfReversers = state.AmountOfReversers;
+    return result;
+}
+
 /**
  *
  *  rct2: 0x006B5A2A
@@ -126,9 +166,25 @@ void ride_ratings_update_all()
     if (gScreenFlags & SCREEN_FLAGS_SCENARIO_EDITOR)
         return;
 
-    // NOTE: Until the new save format only one ride can be updated at once.
-    // The SV6 format can store only a single state.
-    ride_ratings_update_state(gRideRatingUpdateState);
+    // Each step advances one update state by one track piece, the steps are handed out to the update states in
+    // order. With the default budget only the first state is used which matches the SV6 behaviour.
+    const size_t numStates = std::clamp<size_t>(gRideRatingUpdateBudget, 1, RideRatingMaxUpdateStates);
+    const size_t numSteps = std::max<size_t>(gRideRatingUpdateBudget, 1);
+
+    // Update states left out after the budget was lowered let go of their ride, otherwise it would count as being
+    // updated and never be picked up by the remaining states
+    for (size_t i = numStates; i < RideRatingMaxUpdateStates; i++)
+    {
+        if (gRideRatingUpdateStates[i].State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
+        {
+            ride_ratings_reset_update_state(gRideRatingUpdateStates[i]);
+        }
+    }
+
+    for (size_t i = 0; i < numSteps; i++)
+    {
+        ride_ratings_update_state(gRideRatingUpdateStates[i % numStates]);
+    }
 }
 
 static void ride_ratings_update_state(RideRatingUpdateState& state)
@@ -171,7 +227,11 @@ static void ride_ratings_update_state_0(RideRatingUpdateState& state)
     auto ride = get_ride(nextRide);
     if (ride != nullptr && ride->status != RideStatus::Closed && !(ride->lifecycle_flags & RIDE_LIFECYCLE_FIXED_RATINGS))
     {
-        state.State = RIDE_RATINGS_STATE_INITIALISE;
+        // Skip the ride if a different update state is already calculating it
+        if (!ride_ratings_is_updating_ride(nextRide))
+        {
+            state.State = RIDE_RATINGS_STATE_INITIALISE;
+        }
     }
     state.CurrentRide = nextRide;
 }
@@ -741,13 +801,6 @@ static void ride_ratings_calculate(RideRatingUpdateState& state, Ride* ride)
         ride->ratings.nausea = max(0, ride->ratings.nausea);
     }
 #endif
-	
-	//std::cout<<"excite:"<<ride->ratings.Excitement<<"\n";
-    std::ofstream myfile;
-    myfile.open ("excitement.txt");
-    myfile << ride->ratings.Excitement;
-    myfile.close();
-	
 
 #ifdef ENABLE_SCRIPTING
     auto& hookEngine = GetContext()->GetScriptEngine().GetHookEngine();
@@ -3611,50 +3664,28 @@ void ride_ratings_calculate_wooden_roller_coaster(Ride* ride, RideRatingUpdateSt
 
     RatingTuple ratings;
     ride_ratings_set(&ratings, RIDE_RATING(3, 20), RIDE_RATING(2, 60), RIDE_RATING(2, 00));
-	std::cout<<"1 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_length(&ratings, ride, 6000, 873);
-	std::cout<<"2 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_synchronisation(&ratings, ride, RIDE_RATING(0, 40), RIDE_RATING(0, 05));
-	std::cout<<"3 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_train_length(&ratings, ride, 187245);
-	std::cout<<"4 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_max_speed(&ratings, ride, 44281, 88562, 35424);
-	std::cout<<"5 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_average_speed(&ratings, ride, 364088, 655360);
-	std::cout<<"6 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_duration(&ratings, ride, 150, 26214);
-	std::cout<<"7 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_gforces(&ratings, ride, 40960, 34555, 49648);
-	std::cout<<"8 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_turns(&ratings, ride, 26749, 43458, 45749);
-	std::cout<<"9 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_drops(&ratings, ride, 40777, 46811, 49152);
-	std::cout<<"10 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_sheltered_ratings(&ratings, ride, 16705, 30583, 35108);
-	std::cout<<"11 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_proximity(state, &ratings, 22367);
-	std::cout<<"12 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_scenery(&ratings, ride, 11155);
-	std::cout<<"13 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_highest_drop_height_penalty(&ratings, ride, 12, 2, 2, 2);
-	std::cout<<"14 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_max_speed_penalty(&ratings, ride, 0xA0000, 2, 2, 2);
-	std::cout<<"15 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_max_negative_g_penalty(&ratings, ride, FIXED_2DP(0, 10), 2, 2, 2);
-	std::cout<<"16 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_first_length_penalty(&ratings, ride, 0x1720000, 2, 2, 2);
-	std::cout<<"17 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_num_drops_penalty(&ratings, ride, 2, 2, 2, 2);
-	std::cout<<"18 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
 
     ride_ratings_apply_excessive_lateral_g_penalty(&ratings, ride, 40960, 34555, 49648);
-	std::cout<<"19 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_intensity_penalty(&ratings);
-	std::cout<<"20 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
     ride_ratings_apply_adjustments(ride, &ratings);
-	std::cout<<"21 "<<ratings.Excitement<<" "<<ratings.Intensity<<" "<<ratings.Nausea<<"---";
 
-	std::cout<<"Speeds: avg: "<< ride->average_speed << "---max: " << ride->max_speed <<"---invs: "<<ride->inversions<<"---fsl:"<<ride->GetStation().SegmentLength<<"\n";
     ride->ratings = ratings;
 
     ride->upkeep_cost = ride_compute_upkeep(state, ride);
@@ -13,6 +13,9 @@
 #include "../world/Location.hpp"
 #include "RideTypes.h"
 
+#include <array>
+#include <optional>
+
 using ride_rating = fixed16_2dp;
 using track_type_t = uint16_t;
 
@@ -39,6 +42,16 @@ enum
     RIDE_RATING_STATION_FLAG_NO_ENTRANCE = 1 << 0
 };
 
+enum
+{
+    RIDE_RATINGS_STATE_FIND_NEXT_RIDE,
+    RIDE_RATINGS_STATE_INITIALISE,
+    RIDE_RATINGS_STATE_2,
+    RIDE_RATINGS_STATE_CALCULATE,
+    RIDE_RATINGS_STATE_4,
+    RIDE_RATINGS_STATE_5
+};
+
 struct RideRatingUpdateState
 {
     CoordsXYZ Proximity;
@@ -54,8 +67,41 @@ struct RideRatingUpdateState
     uint16_t StationFlags;
 };
 
-extern RideRatingUpdateState gRideRatingUpdateState;
+// Outcome of rating a ride in one go, see RideRatings::ComputeNow.
+struct RideRatingResult
+{
+    RatingTuple Ratings;
+    uint16_t ProximityTotal;
+    uint16_t ProximityScores[26];
+    uint16_t AmountOfBrakes;
+    uint16_t AmountOfReversers;
+};
+
+// Number of rides that can have their ratings calculated at the same time.
+static constexpr size_t RideRatingMaxUpdateStates = 8;
+
+// Default number of rating steps per tick, a single step keeps the original behaviour of one ride at a time.
+static constexpr uint8_t RideRatingDefaultUpdateBudget = 1;
+
+using RideRatingUpdateStates = std::array<RideRatingUpdateState, RideRatingMaxUpdateStates>;
+
+extern RideRatingUpdateStates gRideRatingUpdateStates;
+
+// Number of rating steps performed per tick, spread across min(budget, RideRatingMaxUpdateStates) update states.
+extern uint8_t gRideRatingUpdateBudget;
+
+namespace RideRatings
+{
+    /**
+     * Walks the whole circuit of the given ride and calculates its ratings immediately rather than one track piece
+     * per tick. Uses its own update state so gRideRatingUpdateStates are left untouched. The ride's ratings and value
+     * are updated just as they would be by ride_ratings_update_all. Returns std::nullopt if the ride can not be rated,
+     * e.g. because it is closed or has no station.
+     */
+    std::optional<RideRatingResult> ComputeNow(Ride& ride);
+} // namespace RideRatings
 
+void ride_ratings_reset_update_states();
 void ride_ratings_update_ride(const Ride& ride);
 void ride_ratings_update_all();
 
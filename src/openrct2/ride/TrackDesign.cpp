@@ -30,6 +30,7 @@
 #include "../audio/audio.h"
 #include "../core/DataSerialiser.h"
 #include "../core/File.h"
+#include "../core/MemoryStream.h"
 #include "../core/Numerics.hpp"
 #include "../core/String.hpp"
 #include "../drawing/X8DrawingEngine.h"
@@ -613,6 +614,26 @@ std::unique_ptr<TrackDesign> TrackDesignImport(const utf8* path)
     return nullptr;
 }
 
+/**
+ * Imports a design that is already in memory, e.g. received over a socket. The data is read in place, the extension
+ * (".td4", ".td6" or ".td9") selects the format.
+ */
+std::unique_ptr<TrackDesign> TrackDesignImport(const void* data, size_t dataSize, const utf8* extension)
+{
+    try
+    {
+        auto ms = OpenRCT2::MemoryStream(const_cast<void*>(data), dataSize, OpenRCT2::MEMORY_ACCESS::READ);
+        auto trackImporter = TrackImporter::Create(extension);
+        trackImporter->LoadFromStream(&ms);
+        return trackImporter->Import();
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to load track design: %s", e.what());
+    }
+    return nullptr;
+}
+
 /**
  *
  *  rct2: 0x006ABDB0
@@ -1319,7 +1340,8 @@ static GameActions::Result TrackDesignPlaceAllScenery(
     return res;
 }
 
-static GameActions::Result TrackDesignPlaceMaze(TrackDesignState& tds, TrackDesign* td6, const CoordsXYZ& coords, Ride* ride)
+static GameActions::Result TrackDesignPlaceMaze(
+    TrackDesignState& tds, const TrackDesign* td6, const CoordsXYZ& coords, Ride* ride)
 {
     if (tds.PlaceOperation == PTD_OPERATION_DRAW_OUTLINES)
     {
@@ -1533,7 +1555,8 @@ static GameActions::Result TrackDesignPlaceMaze(TrackDesignState& tds, TrackDesi
     return res;
 }
 
-static GameActions::Result TrackDesignPlaceRide(TrackDesignState& tds, TrackDesign* td6, const CoordsXYZ& origin, Ride* ride)
+static GameActions::Result TrackDesignPlaceRide(
+    TrackDesignState& tds, const TrackDesign* td6, const CoordsXYZ& origin, Ride* ride)
 {
     tds.Origin = origin;
     if (tds.PlaceOperation == PTD_OPERATION_DRAW_OUTLINES)
@@ -1843,7 +1866,8 @@ static GameActions::Result TrackDesignPlaceRide(TrackDesignState& tds, TrackDesi
  *  rct2: 0x006D01B3
  */
 static GameActions::Result TrackDesignPlaceVirtual(
-    TrackDesignState& tds, TrackDesign* td6, uint8_t ptdOperation, bool placeScenery, Ride* ride, const CoordsXYZ& coords)
+    TrackDesignState& tds, const TrackDesign* td6, uint8_t ptdOperation, bool placeScenery, Ride* ride,
+    const CoordsXYZ& coords)
 {
     _trackDesignPlaceStateSceneryUnavailable = false;
     _trackDesignPlaceStateEntranceExitPlaced = false;
@@ -1929,7 +1953,7 @@ void TrackDesignPreviewDrawOutlines(TrackDesignState& tds, TrackDesign* td6, Rid
     TrackDesignPlaceVirtual(tds, td6, PTD_OPERATION_DRAW_OUTLINES, true, ride, coords);
 }
 
-static int32_t TrackDesignGetZPlacement(TrackDesignState& tds, TrackDesign* td6, Ride* ride, const CoordsXYZ& coords)
+static int32_t TrackDesignGetZPlacement(TrackDesignState& tds, const TrackDesign* td6, Ride* ride, const CoordsXYZ& coords)
 {
     TrackDesignPlaceVirtual(tds, td6, PTD_OPERATION_GET_PLACE_Z, true, ride, coords);
 
@@ -1938,7 +1962,7 @@ static int32_t TrackDesignGetZPlacement(TrackDesignState& tds, TrackDesign* td6,
     return tds.PlaceZ - tds.PlaceSceneryZ;
 }
 
-int32_t TrackDesignGetZPlacement(TrackDesign* td6, Ride* ride, const CoordsXYZ& coords)
+int32_t TrackDesignGetZPlacement(const TrackDesign* td6, Ride* ride, const CoordsXYZ& coords)
 {
     TrackDesignState tds{};
     return TrackDesignGetZPlacement(tds, td6, ride, coords);
@@ -219,13 +219,14 @@ extern bool gTrackDesignSaveMode;
 extern RideId gTrackDesignSaveRideIndex;
 
 [[nodiscard]] std::unique_ptr<TrackDesign> TrackDesignImport(const utf8* path);
+[[nodiscard]] std::unique_ptr<TrackDesign> TrackDesignImport(const void* data, size_t dataSize, const utf8* extension);
 
 void TrackDesignMirror(TrackDesign* td6);
 
 GameActions::Result TrackDesignPlace(TrackDesign* td6, uint32_t flags, bool placeScenery, Ride* ride, const CoordsXYZ& coords);
 void TrackDesignPreviewRemoveGhosts(TrackDesign* td6, Ride* ride, const CoordsXYZ& coords);
 void TrackDesignPreviewDrawOutlines(TrackDesignState& tds, TrackDesign* td6, Ride* ride, const CoordsXYZ& coords);
-int32_t TrackDesignGetZPlacement(TrackDesign* td6, Ride* ride, const CoordsXYZ& coords);
+int32_t TrackDesignGetZPlacement(const TrackDesign* td6, Ride* ride, const CoordsXYZ& coords);
 
 ///////////////////////////////////////////////////////////////////////////////
 // Track design preview
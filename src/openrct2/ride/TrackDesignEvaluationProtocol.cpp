@@ -0,0 +1,128 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TrackDesignEvaluationProtocol.h"
+
+#include "../GameState.h"
+#include "TrackDesign.h"
+#include "TrackDesignEvaluator.h"
+
+#include <chrono>
+#include <cstring>
+
+using namespace OpenRCT2;
+
+namespace TrackDesignEvaluationProtocol
+{
+    static const utf8* GetExtension(DesignFormat format)
+    {
+        switch (format)
+        {
+            case DesignFormat::TD4:
+                return ".td4";
+            case DesignFormat::TD6:
+                return ".td6";
+            case DesignFormat::TD9:
+                return ".td9";
+        }
+        return nullptr;
+    }
+
+    static uint32_t ToMicroseconds(std::chrono::duration<double> duration)
+    {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    }
+
+    static Result CreateResult(ResultCode code)
+    {
+        Result result{};
+        result.Magic = Magic;
+        result.Version = Version;
+        result.Code = code;
+        return result;
+    }
+
+    Result CreateResult(const TrackDesignEvaluation& evaluation)
+    {
+        auto code = ResultCode::Ok;
+        if (!evaluation.Placed)
+            code = ResultCode::PlacementFailed;
+        else if (!evaluation.Tested)
+            code = ResultCode::TestFailed;
+
+        auto result = CreateResult(code);
+        result.Direction = evaluation.Location.direction;
+        result.X = evaluation.Location.x;
+        result.Y = evaluation.Location.y;
+        result.Z = evaluation.Location.z;
+        result.TestTicks = evaluation.TestTicks;
+        result.Excitement = evaluation.Ratings.Excitement;
+        result.Intensity = evaluation.Ratings.Intensity;
+        result.Nausea = evaluation.Ratings.Nausea;
+        result.MaxPositiveVerticalG = evaluation.MaxPositiveVerticalG;
+        result.MaxNegativeVerticalG = evaluation.MaxNegativeVerticalG;
+        result.MaxLateralG = evaluation.MaxLateralG;
+        result.MaxSpeed = evaluation.MaxSpeed;
+        result.AverageSpeed = evaluation.AverageSpeed;
+        result.RideTime = evaluation.RideTime;
+        result.RideLength = evaluation.RideLength;
+        result.TotalAirTime = evaluation.TotalAirTime;
+        result.Drops = evaluation.Drops;
+        result.HighestDropHeight = evaluation.HighestDropHeight;
+        result.Inversions = evaluation.Inversions;
+        result.Holes = evaluation.Holes;
+        result.PlaceTime = ToMicroseconds(evaluation.PlaceTime);
+        result.TestTime = ToMicroseconds(evaluation.TestTime);
+        result.RateTime = ToMicroseconds(evaluation.RateTime);
+        result.RemoveTime = ToMicroseconds(evaluation.RemoveTime);
+        return result;
+    }
+
+    bool IsRequest(const void* data, size_t dataSize)
+    {
+        uint32_t magic;
+        if (dataSize < sizeof(RequestHeader))
+            return false;
+
+        std::memcpy(&magic, data, sizeof(magic));
+        return magic == Magic;
+    }
+
+    Result HandleRequest(GameState& gameState, const void* data, size_t dataSize)
+    {
+        if (!IsRequest(data, dataSize))
+            return CreateResult(ResultCode::InvalidRequest);
+
+        RequestHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.Version != Version)
+            return CreateResult(ResultCode::UnsupportedVersion);
+
+        auto extension = GetExtension(header.Format);
+        if (extension == nullptr || header.DesignSize > dataSize - sizeof(RequestHeader))
+            return CreateResult(ResultCode::InvalidRequest);
+
+        auto design = static_cast<const uint8_t*>(data) + sizeof(RequestHeader);
+        auto td = TrackDesignImport(design, header.DesignSize, extension);
+        if (td == nullptr)
+            return CreateResult(ResultCode::ImportFailed);
+
+        TrackDesignEvaluationOptions options;
+        options.TestStatus = (header.Flags & REQUEST_FLAG_OPEN_RIDE) ? RideStatus::Open : RideStatus::Testing;
+        options.ClearScenery = !(header.Flags & REQUEST_FLAG_KEEP_SCENERY);
+        options.FastTestRun = (header.Flags & REQUEST_FLAG_FAST_TEST_RUN) != 0;
+        if (header.MaxTestTicks != 0)
+        {
+            options.MaxTestTicks = header.MaxTestTicks;
+        }
+
+        auto evaluation = TrackDesignEvaluator::Evaluate(gameState, *td, options);
+        return CreateResult(evaluation);
+    }
+} // namespace TrackDesignEvaluationProtocol
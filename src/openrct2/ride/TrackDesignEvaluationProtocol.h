@@ -0,0 +1,117 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+struct TrackDesignEvaluation;
+
+namespace OpenRCT2
+{
+    class GameState;
+}
+
+/**
+ * Binary messages of the track design evaluation socket. A request is a RequestHeader directly followed by the raw bytes
+ * of the design file, the reply is a single Result. Like the park and track files, the structs are copied as they are,
+ * so the fields are in the byte order of the host. That is little endian on every platform OpenRCT2 supports.
+ */
+namespace TrackDesignEvaluationProtocol
+{
+    // "TDE1" when read as bytes
+    constexpr uint32_t Magic = 0x31454454;
+    constexpr uint16_t Version = 1;
+
+    enum class DesignFormat : uint8_t
+    {
+        TD4,
+        TD6,
+        TD9,
+    };
+
+    enum RequestFlags : uint8_t
+    {
+        REQUEST_FLAG_OPEN_RIDE = 1 << 0,
+        REQUEST_FLAG_KEEP_SCENERY = 1 << 1,
+        REQUEST_FLAG_FAST_TEST_RUN = 1 << 2,
+    };
+
+    enum class ResultCode : uint8_t
+    {
+        Ok,
+        InvalidRequest,
+        UnsupportedVersion,
+        ImportFailed,
+        PlacementFailed,
+        TestFailed,
+    };
+
+#pragma pack(push, 1)
+    struct RequestHeader
+    {
+        uint32_t Magic;
+        uint16_t Version;
+        DesignFormat Format;
+        uint8_t Flags;
+        // 0 uses the default limit
+        uint32_t MaxTestTicks;
+        uint32_t DesignSize;
+    };
+    assert_struct_size(RequestHeader, 16);
+
+    struct Result
+    {
+        uint32_t Magic;
+        uint16_t Version;
+        ResultCode Code;
+        uint8_t Direction;
+        int32_t X;
+        int32_t Y;
+        int32_t Z;
+        uint32_t TestTicks;
+        int16_t Excitement;
+        int16_t Intensity;
+        int16_t Nausea;
+        int16_t MaxPositiveVerticalG;
+        int16_t MaxNegativeVerticalG;
+        int16_t MaxLateralG;
+        int32_t MaxSpeed;
+        int32_t AverageSpeed;
+        int32_t RideTime;
+        int32_t RideLength;
+        uint16_t TotalAirTime;
+        uint8_t Drops;
+        uint8_t HighestDropHeight;
+        uint16_t Inversions;
+        uint16_t Holes;
+        // Durations of the evaluation phases in microseconds
+        uint32_t PlaceTime;
+        uint32_t TestTime;
+        uint32_t RateTime;
+        uint32_t RemoveTime;
+    };
+    assert_struct_size(Result, 76);
+#pragma pack(pop)
+
+    /**
+     * Returns whether the message starts with a request header, so it can be told apart from JSON commands.
+     */
+    bool IsRequest(const void* data, size_t dataSize);
+
+    /**
+     * Fills a result with the outcome, ratings, stats and phase timings of the evaluation.
+     */
+    Result CreateResult(const TrackDesignEvaluation& evaluation);
+
+    /**
+     * Imports the design straight from the request buffer and evaluates it with TrackDesignEvaluator::Evaluate.
+     */
+    Result HandleRequest(OpenRCT2::GameState& gameState, const void* data, size_t dataSize);
+} // namespace TrackDesignEvaluationProtocol
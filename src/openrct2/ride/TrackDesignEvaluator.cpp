@@ -0,0 +1,406 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TrackDesignEvaluator.h"
+
+#include "../GameState.h"
+#include "../GameStateCheckpoint.h"
+#include "../actions/ClearAction.h"
+#include "../actions/RideDemolishAction.h"
+#include "../actions/RideSetStatusAction.h"
+#include "../actions/TrackDesignAction.h"
+#include "../world/Map.h"
+#include "../world/Surface.h"
+#include "TrackDesign.h"
+#include "TrackDesignFootprint.h"
+#include "Vehicle.h"
+
+#include <algorithm>
+
+using namespace OpenRCT2;
+
+// Number of heights above the surface that are tried for each origin.
+static constexpr int32_t PlacementHeightAttempts = 7;
+
+// Number of tiles around a ride that are cleared of scenery when it is removed from its site.
+static constexpr int32_t SiteSceneryMargin = 2;
+
+// The ratings count the scenery up to this many tiles around the station and the proximity scores look at the
+// neighbouring tiles. Rides tested at the same time are kept further apart than this, so they rate as if tested alone.
+static constexpr int32_t RatingScanRadius = 5;
+
+using Clock = std::chrono::high_resolution_clock;
+
+const std::vector<CoordsXY>& TrackDesignEvaluator::GetDefaultOrigins()
+{
+    static const std::vector<CoordsXY> origins = {
+        { 6320, 6832 }, { 4220, 1350 }, { 0, 0 }, { 150, 150 }, { 200, 200 }, { 350, 350 },
+    };
+    return origins;
+}
+
+std::optional<CoordsXYZD> TrackDesignEvaluator::FindPlacement(const TrackDesign& td, const std::vector<CoordsXY>& origins)
+{
+    const auto direction = static_cast<Direction>(0);
+    const TrackDesignFootprint footprint(td);
+    for (const auto& origin : origins)
+    {
+        auto surfaceElement = map_get_surface_element_at(origin);
+        if (surfaceElement == nullptr)
+            continue;
+
+        auto baseZ = surfaceElement->GetBaseZ();
+        auto loc = CoordsXYZD{ origin, baseZ, direction };
+        loc.z += TrackDesignGetZPlacement(&td, GetOrAllocateRide(PreviewRideId), { origin, baseZ });
+        for (int32_t i = 0; i < PlacementHeightAttempts; i++, loc.z += COORDS_Z_STEP)
+        {
+            if (!footprint.IsClear(loc))
+                continue;
+
+            auto tdAction = TrackDesignAction(loc, td);
+            auto res = GameActions::Query(&tdAction);
+            if (res.Error == GameActions::Status::Ok)
+            {
+                return loc;
+            }
+
+            // Raising the track only makes it more expensive
+            if (res.Error == GameActions::Status::InsufficientFunds)
+                break;
+        }
+    }
+    return std::nullopt;
+}
+
+RideId TrackDesignEvaluator::Place(const TrackDesign& td, const CoordsXYZD& loc)
+{
+    auto tdAction = TrackDesignAction(loc, td);
+    auto res = GameActions::Execute(&tdAction);
+    if (res.Error != GameActions::Status::Ok)
+    {
+        return RideId::GetNull();
+    }
+    return res.GetData<RideId>();
+}
+
+void TrackDesignEvaluator::Remove(RideId rideId, bool clearScenery)
+{
+    auto ride = get_ride(rideId);
+    if (ride != nullptr)
+    {
+        auto closeAction = RideSetStatusAction(rideId, RideStatus::Closed);
+        GameActions::ExecuteNested(&closeAction);
+
+        ride_clear_for_construction(ride);
+
+        auto demolishAction = RideDemolishAction(rideId, RIDE_MODIFY_DEMOLISH);
+        demolishAction.SetFlags(GAME_COMMAND_FLAG_APPLY);
+        GameActions::ExecuteNested(&demolishAction);
+    }
+
+    if (clearScenery)
+    {
+        ClearableItems itemsToClear = CLEARABLE_ITEMS::SCENERY_SMALL | CLEARABLE_ITEMS::SCENERY_LARGE
+            | CLEARABLE_ITEMS::SCENERY_FOOTPATH;
+        auto mapSizeMaxXY = GetMapSizeMaxXY();
+        auto clearAction = ClearAction(MapRange(0, 0, mapSizeMaxXY.x, mapSizeMaxXY.y), itemsToClear);
+        GameActions::Execute(&clearAction);
+    }
+}
+
+void TrackDesignEvaluator::CollectStats(const Ride& ride, TrackDesignEvaluation& result)
+{
+    result.Ratings = ride.ratings;
+    result.MaxSpeed = ride.max_speed;
+    result.AverageSpeed = ride.average_speed;
+    result.RideTime = ride.GetTotalTime();
+    result.RideLength = ride.GetTotalLength() >> 16;
+    result.MaxPositiveVerticalG = ride.max_positive_vertical_g;
+    result.MaxNegativeVerticalG = ride.max_negative_vertical_g;
+    result.MaxLateralG = ride.max_lateral_g;
+    result.TotalAirTime = ride.total_air_time;
+    result.Drops = ride.drops & 0x3F;
+    result.HighestDropHeight = ride.highest_drop_height;
+    result.Inversions = ride.inversions;
+    result.Holes = ride.holes;
+}
+
+static bool StartTest(RideId rideId, const TrackDesignEvaluationOptions& options, TrackDesignEvaluation& result)
+{
+    auto statusAction = RideSetStatusAction(rideId, options.TestStatus);
+    auto statusRes = GameActions::Execute(&statusAction);
+    if (statusRes.Error != GameActions::Status::Ok)
+    {
+        result.Error = statusRes.GetErrorMessage();
+        return false;
+    }
+    return true;
+}
+
+static bool IsTestOver(RideId rideId, const TrackDesignEvaluation& result, const TrackDesignEvaluationOptions& options)
+{
+    // The ride may have been demolished by a plugin
+    auto ride = get_ride(rideId);
+    return ride == nullptr || (ride->lifecycle_flags & RIDE_LIFECYCLE_TESTED) || result.TestTicks >= options.MaxTestTicks;
+}
+
+static void FinishTest(RideId rideId, TrackDesignEvaluation& result)
+{
+    auto ride = get_ride(rideId);
+    if (ride == nullptr)
+    {
+        result.Error = "Ride was removed during its test run.";
+    }
+    else if (!(ride->lifecycle_flags & RIDE_LIFECYCLE_TESTED))
+    {
+        result.Error = "Test run did not complete in time.";
+    }
+    else
+    {
+        auto startTime = Clock::now();
+        RideRatings::ComputeNow(*ride);
+        result.RateTime = Clock::now() - startTime;
+
+        result.Tested = true;
+        TrackDesignEvaluator::CollectStats(*ride, result);
+    }
+}
+
+/**
+ * Returns the range of tiles covered by the track, entrances and scenery of the design when it is built at the given
+ * origin, facing direction 0 as FindPlacement builds it. Computed from the design alone, without scanning the map.
+ */
+static MapRange GetDesignBounds(const TrackDesign& td, const CoordsXY& origin)
+{
+    auto bounds = MapRange(origin.x, origin.y, origin.x, origin.y);
+    auto include = [&bounds, &origin](int32_t x, int32_t y) {
+        bounds = MapRange(
+            std::min(bounds.GetLeft(), origin.x + x), std::min(bounds.GetTop(), origin.y + y),
+            std::max(bounds.GetRight(), origin.x + x), std::max(bounds.GetBottom(), origin.y + y));
+    };
+
+    for (const auto& block : TrackDesignFootprint(td).GetBlocks())
+        include(block.Offset.x, block.Offset.y);
+    for (const auto& mazeElement : td.maze_elements)
+        include(mazeElement.x * COORDS_XY_STEP, mazeElement.y * COORDS_XY_STEP);
+    for (const auto& entranceElement : td.entrance_elements)
+        include(entranceElement.x, entranceElement.y);
+    for (const auto& sceneryElement : td.scenery_elements)
+        include(sceneryElement.loc.x, sceneryElement.loc.y);
+    return bounds;
+}
+
+static bool RangesOverlap(const MapRange& a, const MapRange& b, int32_t margin)
+{
+    return a.GetLeft() - margin <= b.GetRight() && b.GetLeft() <= a.GetRight() + margin
+        && a.GetTop() - margin <= b.GetBottom() && b.GetTop() <= a.GetBottom() + margin;
+}
+
+/**
+ * Removes the ride while other rides are still testing, so scenery is only cleared around the ride itself.
+ */
+static void RemoveFromSite(RideId rideId, const MapRange& bounds, bool clearScenery)
+{
+    TrackDesignEvaluator::Remove(rideId, false);
+
+    if (clearScenery)
+    {
+        ClearableItems itemsToClear = CLEARABLE_ITEMS::SCENERY_SMALL | CLEARABLE_ITEMS::SCENERY_LARGE
+            | CLEARABLE_ITEMS::SCENERY_FOOTPATH;
+        auto margin = SiteSceneryMargin * COORDS_XY_STEP;
+        auto range = MapRange(
+            bounds.GetLeft() - margin, bounds.GetTop() - margin, bounds.GetRight() + margin, bounds.GetBottom() + margin);
+        auto clearAction = ClearAction(range, itemsToClear);
+        GameActions::Execute(&clearAction);
+    }
+}
+
+TrackDesignEvaluation TrackDesignEvaluator::Evaluate(
+    GameState& gameState, const TrackDesign& td, const TrackDesignEvaluationOptions& options)
+{
+    TrackDesignEvaluation result;
+
+    auto startTime = Clock::now();
+    auto loc = FindPlacement(td, GetDefaultOrigins());
+    auto rideId = loc.has_value() ? Place(td, *loc) : RideId::GetNull();
+    auto ride = get_ride(rideId);
+    result.PlaceTime = Clock::now() - startTime;
+    if (ride == nullptr)
+    {
+        if (options.Baseline != nullptr)
+            gameState.Restore(*options.Baseline);
+
+        result.Error = "Unable to place track design.";
+        return result;
+    }
+    result.Placed = true;
+    result.Location = *loc;
+
+    startTime = Clock::now();
+    if (StartTest(rideId, options, result))
+    {
+        if (options.FastTestRun)
+        {
+            result.TestTicks = vehicle_update_test_run(*ride, options.MaxTestTicks);
+        }
+        else
+        {
+            while (!IsTestOver(rideId, result, options))
+            {
+                gameState.UpdateLogic();
+                result.TestTicks++;
+            }
+        }
+        result.TestTime = Clock::now() - startTime;
+        FinishTest(rideId, result);
+    }
+    else
+    {
+        result.TestTime = Clock::now() - startTime;
+    }
+
+    startTime = Clock::now();
+    if (options.Baseline != nullptr)
+    {
+        gameState.Restore(*options.Baseline);
+    }
+    else
+    {
+        Remove(rideId, options.ClearScenery);
+    }
+    result.RemoveTime = Clock::now() - startTime;
+
+    return result;
+}
+
+std::vector<CoordsXY> TrackDesignEvaluator::GetSiteOrigins(int32_t spacing)
+{
+    auto origins = GetDefaultOrigins();
+    auto mapSize = GetMapSizeMaxXY();
+    auto step = spacing * COORDS_XY_STEP;
+    for (int32_t y = step / 2; y < mapSize.y; y += step)
+    {
+        for (int32_t x = step / 2; x < mapSize.x; x += step)
+        {
+            origins.emplace_back(x, y);
+        }
+    }
+    return origins;
+}
+
+void TrackDesignEvaluator::EvaluateConcurrently(
+    GameState& gameState, size_t count, const DesignLoader& loadDesign, const TrackDesignEvaluationOptions& options,
+    const ResultCallback& onResult)
+{
+    struct Test
+    {
+        size_t Index;
+        RideId Ride;
+        MapRange Bounds;
+        TrackDesignEvaluation Result;
+        Clock::time_point StartTime;
+    };
+
+    const auto origins = GetSiteOrigins(options.SiteSpacing);
+    const auto maxTests = std::max<size_t>(1, options.ConcurrentTests);
+    const auto minDistance = (RatingScanRadius + 1) * COORDS_XY_STEP;
+
+    std::vector<Test> tests;
+    std::unique_ptr<TrackDesign> pendingDesign;
+    // Set when the pending design did not fit anywhere, only a finished test can make room for it
+    bool waitingForSite = false;
+    size_t nextIndex = 0;
+    while (nextIndex < count || !tests.empty())
+    {
+        // Place new designs on free sites while the other rides keep testing
+        while (tests.size() < maxTests && nextIndex < count && !waitingForSite)
+        {
+            TrackDesignEvaluation result;
+            if (pendingDesign == nullptr)
+            {
+                pendingDesign = loadDesign(nextIndex);
+                if (pendingDesign == nullptr)
+                {
+                    result.Error = "Unable to load track design.";
+                    onResult(nextIndex++, std::move(result));
+                    continue;
+                }
+            }
+
+            // Skip the sites too close to the rides that are testing
+            auto startTime = Clock::now();
+            std::vector<CoordsXY> freeOrigins;
+            for (const auto& origin : origins)
+            {
+                auto bounds = GetDesignBounds(*pendingDesign, origin);
+                auto isFree = std::none_of(tests.begin(), tests.end(), [&bounds, minDistance](const Test& test) {
+                    return RangesOverlap(bounds, test.Bounds, minDistance);
+                });
+                if (isFree)
+                    freeOrigins.push_back(origin);
+            }
+            auto loc = FindPlacement(*pendingDesign, freeOrigins);
+            auto rideId = loc.has_value() ? Place(*pendingDesign, *loc) : RideId::GetNull();
+            result.PlaceTime = Clock::now() - startTime;
+            if (get_ride(rideId) == nullptr)
+            {
+                // All sites may just be taken, try again once the next test has finished
+                if (!tests.empty())
+                {
+                    waitingForSite = true;
+                    break;
+                }
+
+                result.Error = "Unable to place track design.";
+                pendingDesign = nullptr;
+                onResult(nextIndex++, std::move(result));
+                continue;
+            }
+            result.Placed = true;
+            result.Location = *loc;
+            auto bounds = GetDesignBounds(*pendingDesign, *loc);
+            pendingDesign = nullptr;
+
+            startTime = Clock::now();
+            if (!StartTest(rideId, options, result))
+            {
+                RemoveFromSite(rideId, bounds, options.ClearScenery);
+                onResult(nextIndex++, std::move(result));
+                continue;
+            }
+            tests.push_back({ nextIndex++, rideId, bounds, std::move(result), startTime });
+        }
+
+        if (tests.empty())
+            continue;
+
+        gameState.UpdateLogic();
+
+        for (auto it = tests.begin(); it != tests.end();)
+        {
+            it->Result.TestTicks++;
+            if (!IsTestOver(it->Ride, it->Result, options))
+            {
+                it++;
+                continue;
+            }
+
+            it->Result.TestTime = Clock::now() - it->StartTime;
+            FinishTest(it->Ride, it->Result);
+
+            auto startTime = Clock::now();
+            RemoveFromSite(it->Ride, it->Bounds, options.ClearScenery);
+            it->Result.RemoveTime = Clock::now() - startTime;
+            waitingForSite = false;
+
+            onResult(it->Index, std::move(it->Result));
+            it = tests.erase(it);
+        }
+    }
+}
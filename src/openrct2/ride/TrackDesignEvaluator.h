@@ -0,0 +1,132 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+#include "Ride.h"
+#include "RideRatings.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct TrackDesign;
+
+namespace OpenRCT2
+{
+    class GameState;
+    struct GameStateCheckpoint;
+} // namespace OpenRCT2
+
+struct TrackDesignEvaluationOptions
+{
+    // Status the ride is set to for its test run.
+    RideStatus TestStatus = RideStatus::Testing;
+    // Give up on the test run after this many ticks.
+    uint32_t MaxTestTicks = 40 * 60 * 10;
+    // Also clear scenery from the whole map when the ride is removed again.
+    bool ClearScenery = true;
+    // Only update the tested ride and its trains during the test run, see vehicle_update_test_run.
+    bool FastTestRun = false;
+    // Number of rides tested at the same time by EvaluateConcurrently.
+    uint32_t ConcurrentTests = 1;
+    // Distance in tiles between the test sites used by EvaluateConcurrently.
+    int32_t SiteSpacing = 24;
+    // If set, Evaluate restores this checkpoint instead of demolishing the ride, so every design starts from the same
+    // park. ClearScenery is not used then.
+    const OpenRCT2::GameStateCheckpoint* Baseline = nullptr;
+};
+
+// Measured statistics and timings of a single evaluated track design.
+struct TrackDesignEvaluation
+{
+    bool Placed{};
+    bool Tested{};
+    std::string Error;
+    CoordsXYZD Location{};
+    uint32_t TestTicks{};
+    RatingTuple Ratings{ RIDE_RATING_UNDEFINED, RIDE_RATING_UNDEFINED, RIDE_RATING_UNDEFINED };
+    int32_t MaxSpeed{};
+    int32_t AverageSpeed{};
+    int32_t RideTime{};
+    int32_t RideLength{};
+    fixed16_2dp MaxPositiveVerticalG{};
+    fixed16_2dp MaxNegativeVerticalG{};
+    fixed16_2dp MaxLateralG{};
+    uint16_t TotalAirTime{};
+    uint8_t Drops{};
+    uint8_t HighestDropHeight{};
+    uint16_t Inversions{};
+    uint16_t Holes{};
+
+    std::chrono::duration<double> PlaceTime{};
+    std::chrono::duration<double> TestTime{};
+    std::chrono::duration<double> RateTime{};
+    std::chrono::duration<double> RemoveTime{};
+};
+
+namespace TrackDesignEvaluator
+{
+    /**
+     * Origins tried, in order, when looking for a place to build a design in the evaluation park.
+     */
+    const std::vector<CoordsXY>& GetDefaultOrigins();
+
+    /**
+     * Finds the first origin at which the design can be built, trying a few heights above the surface for each.
+     */
+    std::optional<CoordsXYZD> FindPlacement(const TrackDesign& td, const std::vector<CoordsXY>& origins);
+
+    /**
+     * Builds the design at the given location. Returns a null id if the placement failed.
+     */
+    RideId Place(const TrackDesign& td, const CoordsXYZD& loc);
+
+    /**
+     * Closes and demolishes the ride, optionally clearing all scenery from the map as well.
+     */
+    void Remove(RideId rideId, bool clearScenery);
+
+    /**
+     * Copies the test results of the ride into the evaluation.
+     */
+    void CollectStats(const Ride& ride, TrackDesignEvaluation& result);
+
+    /**
+     * Places the design, runs the game logic until the ride has completed its test run, rates the ride and removes
+     * it again, or restores options.Baseline. The game logic is advanced as fast as possible without any rendering.
+     */
+    TrackDesignEvaluation Evaluate(
+        OpenRCT2::GameState& gameState, const TrackDesign& td, const TrackDesignEvaluationOptions& options);
+
+    /**
+     * The default origins followed by a grid of origins across the whole map, spacing tiles apart.
+     */
+    std::vector<CoordsXY> GetSiteOrigins(int32_t spacing);
+
+    using DesignLoader = std::function<std::unique_ptr<TrackDesign>(size_t index)>;
+    using ResultCallback = std::function<void(size_t index, TrackDesignEvaluation&& result)>;
+
+    /**
+     * Evaluates count designs with up to options.ConcurrentTests rides testing at the same time on separate sites of the
+     * map. As soon as a ride has finished its test it is rated and removed, and the next design is placed on a free site
+     * while the other rides keep testing. Rides testing at the same time are kept further apart than the ratings look
+     * around a ride, so on a map without other scenery the ratings match those of Evaluate. Results are passed to
+     * onResult in the order the tests finish. Test ticks and times are shared between the rides testing at the same
+     * time, options.FastTestRun is ignored.
+     */
+    void EvaluateConcurrently(
+        OpenRCT2::GameState& gameState, size_t count, const DesignLoader& loadDesign,
+        const TrackDesignEvaluationOptions& options, const ResultCallback& onResult);
+} // namespace TrackDesignEvaluator
@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TrackDesignFootprint.h"
+
+#include "../world/ConstructionClearance.h"
+#include "../world/Map.h"
+#include "RideData.h"
+#include "Track.h"
+#include "TrackData.h"
+#include "TrackDesign.h"
+
+using namespace OpenRCT2::TrackMetaData;
+
+TrackDesignFootprint::TrackDesignFootprint(const TrackDesign& td)
+{
+    if (td.type == RIDE_TYPE_MAZE || td.track_elements.empty())
+    {
+        _isComplete = false;
+        return;
+    }
+
+    const auto& rtd = GetRideTypeDescriptor(td.type);
+    const bool supportsLevelCrossings = rtd.HasFlag(RIDE_TYPE_FLAG_SUPPORTS_LEVEL_CROSSINGS);
+
+    // Walks the track the same way TrackDesignPlaceRide does
+    auto coords = CoordsXYZ{ 0, 0, 0 };
+    uint8_t rotation = 0;
+    for (const auto& track : td.track_elements)
+    {
+        const auto& ted = GetTrackElementDescriptor(track.type);
+        int32_t pieceZ = coords.z - ted.Coordinates.z_begin;
+        for (const rct_preview_track* trackBlock = ted.Block; trackBlock->index != 0xFF; trackBlock++)
+        {
+            int32_t clearance = trackBlock->var_07;
+            if ((trackBlock->flags & RCT_PREVIEW_TRACK_FLAG_IS_VERTICAL) && rtd.Heights.ClearanceHeight > 24)
+            {
+                clearance += 24;
+            }
+            else
+            {
+                clearance += rtd.Heights.ClearanceHeight;
+            }
+
+            auto offset = CoordsXYZ{ CoordsXY{ coords } + CoordsXY{ trackBlock->x, trackBlock->y }.Rotate(rotation & 3),
+                                     pieceZ + trackBlock->z };
+            _blocks.push_back({ offset, floor2(clearance, COORDS_Z_STEP), trackBlock->var_08.Rotate(rotation & 3),
+                                supportsLevelCrossings && track.type == TrackElemType::Flat });
+        }
+
+        const auto& trackCoordinates = ted.Coordinates;
+        auto offsetAndRotatedTrack = CoordsXY{ coords }
+            + CoordsXY{ trackCoordinates.x, trackCoordinates.y }.Rotate(rotation);
+        coords = { offsetAndRotatedTrack, coords.z - trackCoordinates.z_begin + trackCoordinates.z_end };
+        rotation = (rotation + trackCoordinates.rotation_end - trackCoordinates.rotation_begin) & 3;
+        if (trackCoordinates.rotation_end & (1 << 2))
+        {
+            rotation |= (1 << 2);
+        }
+        else
+        {
+            coords += CoordsDirectionDelta[rotation];
+        }
+    }
+}
+
+bool TrackDesignFootprint::IsClear(const CoordsXYZD& origin) const
+{
+    if (!_isComplete)
+        return true;
+
+    const auto direction = origin.direction & 3;
+    for (const auto& block : _blocks)
+    {
+        auto mapLoc = CoordsXYZ{ CoordsXY{ origin } + CoordsXY{ block.Offset }.Rotate(direction),
+                                 origin.z + block.Offset.z };
+        if (mapLoc.z < 16 || !map_is_location_valid(mapLoc))
+            return false;
+
+        int32_t baseZ = floor2(mapLoc.z, COORDS_Z_STEP);
+        int32_t clearanceZ = baseZ + block.Clearance;
+        if (clearanceZ > MAX_TRACK_HEIGHT)
+            return false;
+
+        // Without GAME_COMMAND_FLAG_APPLY this only reads the map
+        auto crossingMode = block.CanCrossPaths ? CREATE_CROSSING_MODE_TRACK_OVER_PATH : CREATE_CROSSING_MODE_NONE;
+        auto canBuild = MapCanConstructWithClearAt(
+            { mapLoc, baseZ, clearanceZ }, &map_place_non_scenery_clear_func, block.Quarters.Rotate(direction), 0,
+            crossingMode);
+        if (canBuild.Error != GameActions::Status::Ok)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+#include "../world/TileElement.h"
+
+#include <vector>
+
+struct TrackDesign;
+
+/**
+ * The space taken up by the track pieces of a design, relative to its origin. Computed once per design, it is used to
+ * quickly rule out locations where something is in the way without going through TrackDesignAction. It only reads the
+ * map, and only ever rejects locations that TrackDesignAction would reject as well; a location it accepts still has to
+ * be confirmed with a real query, which also checks costs, supports, ownership and scenery.
+ */
+class TrackDesignFootprint
+{
+public:
+    struct Block
+    {
+        // Relative to the origin of the design when built facing direction 0
+        CoordsXYZ Offset;
+        // Height of the space the block needs above its base
+        int32_t Clearance;
+        QuarterTile Quarters;
+        // Flat track of ride types that support level crossings may be built over footpaths
+        bool CanCrossPaths;
+    };
+
+private:
+    std::vector<Block> _blocks;
+    bool _isComplete = true;
+
+public:
+    explicit TrackDesignFootprint(const TrackDesign& td);
+
+    const std::vector<Block>& GetBlocks() const
+    {
+        return _blocks;
+    }
+
+    /**
+     * Returns whether the map has room for the track of the design at the given origin. Designs that can not be
+     * described by a footprint, such as mazes, are always reported as clear.
+     */
+    bool IsClear(const CoordsXYZD& origin) const;
+};
@@ -0,0 +1,198 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TrackDesignResultSink.h"
+
+#include "../core/File.h"
+#include "../core/MemoryStream.h"
+#include "../management/Finance.h"
+#include "../rct2/T6Exporter.h"
+#include "../rct2/T9Exporter.h"
+#include "TrackDesign.h"
+#include "TrackDesignEvaluationProtocol.h"
+#include "TrackDesignEvaluator.h"
+
+#define ZMQ_BUILD_DRAFT_API
+#include <zmq.hpp>
+
+using namespace OpenRCT2;
+
+namespace TrackDesignResultSink
+{
+    // Written next to the TD6 file by the file sink, the client deletes it once it has read the result
+    static constexpr const char* PendingResultPath = "exportX.td9";
+
+    // Cash the park is given back after each published design, so the next one starts from the same amount
+    static constexpr money64 StartingCash = 350000.00_GBP;
+
+    /**
+     * Owns the sink and the context its sockets are created from. The sockets must be closed before the context is,
+     * or destroying the context blocks, so the sink is always destroyed first.
+     */
+    struct SinkState
+    {
+        std::unique_ptr<zmq::context_t> Context;
+        std::unique_ptr<ITrackDesignResultSink> Sink;
+
+        ~SinkState()
+        {
+            Shutdown();
+        }
+    };
+
+    static SinkState _state;
+
+    static zmq::context_t& GetSocketContext()
+    {
+        if (_state.Context == nullptr)
+        {
+            _state.Context = std::make_unique<zmq::context_t>(1);
+        }
+        return *_state.Context;
+    }
+
+    static zmq::socket_t CreateSocket(const std::string& endpoint)
+    {
+        zmq::socket_t socket(GetSocketContext(), zmq::socket_type::client);
+        // Results nobody has received yet are dropped on shutdown instead of holding it up
+        socket.set(zmq::sockopt::linger, 0);
+        socket.connect(endpoint);
+        return socket;
+    }
+
+    static bool ExportTrack(const TrackDesign& td, IStream* stream)
+    {
+        // T6Exporter only reads the design
+        RCT2::T6Exporter exporter{ const_cast<TrackDesign*>(&td) };
+        return exporter.SaveTrack(stream);
+    }
+
+    class CallbackSink final : public ITrackDesignResultSink
+    {
+    private:
+        Callback _callback;
+
+    public:
+        explicit CallbackSink(Callback callback)
+            : _callback(std::move(callback))
+        {
+        }
+
+        bool Publish(const Ride& ride, const TrackDesign& td) override
+        {
+            return _callback(ride, td);
+        }
+    };
+
+    class SocketSink final : public ITrackDesignResultSink
+    {
+    private:
+        zmq::socket_t _socket;
+
+    public:
+        explicit SocketSink(const std::string& endpoint)
+            : _socket(CreateSocket(endpoint))
+        {
+        }
+
+        bool Publish(const Ride& ride, const TrackDesign& td) override
+        {
+            TrackDesignEvaluation evaluation;
+            evaluation.Placed = true;
+            evaluation.Tested = true;
+            TrackDesignEvaluator::CollectStats(ride, evaluation);
+            auto result = TrackDesignEvaluationProtocol::CreateResult(evaluation);
+
+            MemoryStream stream;
+            stream.Write(&result, sizeof(result));
+            if (!ExportTrack(td, &stream))
+                return false;
+
+            auto sent = _socket.send(
+                zmq::buffer(stream.GetData(), static_cast<size_t>(stream.GetLength())), zmq::send_flags::none);
+            return sent.has_value();
+        }
+    };
+
+    class FileSink final : public ITrackDesignResultSink
+    {
+    private:
+        std::string _path;
+        zmq::socket_t _socket;
+        bool _notify = false;
+
+    public:
+        FileSink(const std::string& path, const std::string& notifyEndpoint)
+            : _path(path)
+        {
+            if (!notifyEndpoint.empty())
+            {
+                _socket = CreateSocket(notifyEndpoint);
+                _notify = true;
+            }
+        }
+
+        bool IsReady() const override
+        {
+            return !File::Exists(PendingResultPath);
+        }
+
+        bool Publish(const Ride& ride, const TrackDesign& td) override
+        {
+            RCT2::T6Exporter exporter{ const_cast<TrackDesign*>(&td) };
+            if (!exporter.SaveTrack(_path.c_str()))
+                return false;
+
+            // The stats go into the TD9 file, with the cash left after building the ride as its cost
+            TrackDesign td9 = td;
+            td9.cost = static_cast<money32>(gCash);
+            gCash = StartingCash;
+            if (!RCT2::T9Exporter(&td9).SaveTrack(PendingResultPath))
+                return false;
+
+            if (_notify)
+            {
+                const std::string data{ "Done" };
+                return _socket.send(zmq::buffer(data), zmq::send_flags::none).has_value();
+            }
+            return true;
+        }
+    };
+
+    std::unique_ptr<ITrackDesignResultSink> CreateCallbackSink(Callback callback)
+    {
+        return std::make_unique<CallbackSink>(std::move(callback));
+    }
+
+    std::unique_ptr<ITrackDesignResultSink> CreateSocketSink(const std::string& endpoint)
+    {
+        return std::make_unique<SocketSink>(endpoint);
+    }
+
+    std::unique_ptr<ITrackDesignResultSink> CreateFileSink(const std::string& path, const std::string& notifyEndpoint)
+    {
+        return std::make_unique<FileSink>(path, notifyEndpoint);
+    }
+
+    ITrackDesignResultSink* Get()
+    {
+        return _state.Sink.get();
+    }
+
+    void Set(std::unique_ptr<ITrackDesignResultSink> sink)
+    {
+        _state.Sink = std::move(sink);
+    }
+
+    void Shutdown()
+    {
+        _state.Sink = nullptr;
+        _state.Context = nullptr;
+    }
+} // namespace TrackDesignResultSink
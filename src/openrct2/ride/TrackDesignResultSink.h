@@ -0,0 +1,77 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+struct Ride;
+struct TrackDesign;
+
+/**
+ * Receives the designs of rides that have finished their test run. The design carries the measured stats and ratings
+ * of the ride, so a sink has everything it needs without reading the ride back from a file.
+ */
+struct ITrackDesignResultSink
+{
+    virtual ~ITrackDesignResultSink() = default;
+
+    /**
+     * Returns false while the sink can not take another result yet, the ride is then published on a later departure.
+     */
+    virtual bool IsReady() const
+    {
+        return true;
+    }
+
+    /**
+     * Returns false if the result could not be delivered.
+     */
+    virtual bool Publish(const Ride& ride, const TrackDesign& td) = 0;
+};
+
+namespace TrackDesignResultSink
+{
+    using Callback = std::function<bool(const Ride& ride, const TrackDesign& td)>;
+
+    /**
+     * Hands the result to a function in the same process.
+     */
+    std::unique_ptr<ITrackDesignResultSink> CreateCallbackSink(Callback callback);
+
+    /**
+     * Sends a TrackDesignEvaluationProtocol::Result with the ratings and stats of the ride, directly followed by the
+     * design in TD6 format, over a ZeroMQ client socket. The socket connects once, when the sink is created, and stays
+     * connected for all results.
+     */
+    std::unique_ptr<ITrackDesignResultSink> CreateSocketSink(const std::string& endpoint);
+
+    /**
+     * Saves the design as a TD6 file and its stats to exportX.td9 and, if an endpoint is given, then sends "Done" to it
+     * to say the files are ready. Like the socket sink, it only connects once. The sink is not ready until the client
+     * has deleted exportX.td9 to say it has read the previous result. The cost in exportX.td9 is the cash the park has
+     * left, which is reset for the next design.
+     */
+    std::unique_ptr<ITrackDesignResultSink> CreateFileSink(const std::string& path, const std::string& notifyEndpoint);
+
+    /**
+     * Returns the sink tested rides are published to, or nullptr if results are not published.
+     */
+    ITrackDesignResultSink* Get();
+    void Set(std::unique_ptr<ITrackDesignResultSink> sink);
+
+    /**
+     * Destroys the sink and then the ZeroMQ context its sockets were created from. Called when the context shuts down.
+     */
+    void Shutdown();
+} // namespace TrackDesignResultSink
@@ -1,11 +1,6 @@
 #include <string>
 #include <fstream>
 
-inline bool exists_test0 (const std::string& name) {
-    std::ifstream f(name.c_str());
-    return f.good();
-}
-
 /*****************************************************************************
  * Copyright (c) 2014-2020 OpenRCT2 developers
  *
@@ -35,7 +30,6 @@ inline bool exists_test0 (const std::string& name) {
 #include "../platform/Platform.h"
 #include "../profiling/Profiling.h"
 #include "../rct12/RCT12.h"
-#include "../rct2/T6Exporter.h"
 #include "../scenario/Scenario.h"
 #include "../scripting/HookEngine.h"
 #include "../scripting/ScriptEngine.h"
@@ -54,14 +48,14 @@ inline bool exists_test0 (const std::string& name) {
 #include "Station.h"
 #include "Track.h"
 #include "TrackData.h"
+#include "TrackDesign.h"
+#include "TrackDesignResultSink.h"
 #include "TrainManager.h"
 #include "VehicleData.h"
 #include "VehicleSubpositionData.h"
 
 #include <algorithm>
 #include <iterator>
-#define ZMQ_BUILD_DRAFT_API
-#include <zmq.hpp>
 
 
 using namespace OpenRCT2::TrackMetaData;
@@ -69,14 +63,6 @@ static bool vehicle_boat_is_location_accessible(const CoordsXYZ& location);
 
 using namespace std::chrono_literals;
 
-// initialize the zmq context with a single IO thread
-zmq::context_t context{1};
-
-// construct a REP (reply) socket and bind to interface
-zmq::socket_t socket{context, zmq::socket_type::client};
-
-
-
 constexpr int16_t VEHICLE_MAX_SPIN_SPEED = 1536;
 constexpr int16_t VEHICLE_MIN_SPIN_SPEED = -VEHICLE_MAX_SPIN_SPEED;
 constexpr int16_t VEHICLE_MAX_SPIN_SPEED_FOR_STOPPING = 700;
@@ -87,6 +73,7 @@ constexpr int16_t VEHICLE_STOPPING_SPIN_SPEED = 600;
 Vehicle* gCurrentVehicle;
 
 static uint8_t _vehicleBreakdown;
+static bool _vehicleTestRunOnly = false;
 StationIndex _vehicleStationIndex;
 uint32_t _vehicleMotionTrackFlags;
 int32_t _vehicleVelocityF64E08;
@@ -1263,6 +1250,38 @@ void vehicle_update_all()
     }
 }
 
+uint32_t vehicle_update_test_run(Ride& ride, uint32_t maxTicks)
+{
+    PROFILED_FUNCTION();
+
+    _vehicleTestRunOnly = true;
+
+    uint32_t ticks = 0;
+    while (ticks < maxTicks && !(ride.lifecycle_flags & RIDE_LIFECYCLE_TESTED))
+    {
+        date_update();
+
+        // Trains are updated in the same order as in vehicle_update_all, which matters for block sections
+        for (auto vehicle : TrainManager::View())
+        {
+            if (vehicle->ride == ride.id)
+            {
+                vehicle->Update();
+            }
+        }
+        ride.Update();
+
+        gCurrentTicks++;
+        ticks++;
+
+        if (ride.status == RideStatus::Closed)
+            break;
+    }
+
+    _vehicleTestRunOnly = false;
+    return ticks;
+}
+
 /**
  *
  *  rct2: 0x006D6956
@@ -1975,7 +1994,8 @@ void Vehicle::Update()
             break;
     }
 
-    UpdateSound();
+    if (!_vehicleTestRunOnly)
+        UpdateSound();
 }
 
 /**
@@ -3116,81 +3136,34 @@ void Vehicle::UpdateDeparting()
     auto rideEntry = GetRideEntry();
     if (rideEntry == nullptr)
         return;
-	
-	
-	//std::cout <<"update departing\n";
-
-	if (!(curRide->lifecycle_flags & RIDE_LIFECYCLE_TESTED) || !ride_has_ratings(curRide) || exists_test0("exportX.td9"))
-	{
-		//std::cout<<"untested\n";
-		//continue;
-	}
-	else
-	{
-		// save track design *** WORK ***
-		//std::cout<<"3131\n";
-	    TrackDesignState tds{};
-
-	    //Ride* ride = get_ride(w->rideId);
-	    auto _trackDesign = curRide->SaveToTrackDesign(tds);
-	    if (!_trackDesign)
-	    {
-			//std::cout<<"cant get design\n";
-	        //return;
-	    }
-		else if (curRide->custom_name != "Test")
-		{
-			//std::cout<<"bad name:"<<curRide->custom_name<<"\n";
-		}
-		else
-		{
-			//std::cout<<"3146\n";
-		    //if (gTrackDesignSaveMode)
-		    //{
-	        auto errMessage = _trackDesign->CreateTrackDesignScenery(tds);
-	        if (errMessage != STR_NONE)
-	        {
-	            context_show_error(STR_CANT_SAVE_TRACK_DESIGN, errMessage, {});
-				std::cout<<"cant save1\n";
-	            return;
-	        }
-			//}
-			else
-			{
-			    char pathBuffer[100];
-			    std::string withExtension = "export.td6"; // Path::WithExtension(, "td6");
-			    String::Set(pathBuffer, sizeof(pathBuffer), withExtension.c_str());
-
-			    RCT2::T6Exporter t6Export{ _trackDesign.get() };
-
-			    auto success = t6Export.SaveTrack(pathBuffer);
-
-			    if (!success)
-			    {
-					std::cout<<"err saving\n";
-			    }
-				else
-				{
-					//std::cout<<"success\n";
-					socket.connect("tcp://localhost:5556");
-					const std::string data{"Done"};
-					socket.send(zmq::buffer(data), zmq::send_flags::none);
-					std::cout<<"Sent; excitement:"<< curRide->ratings.Excitement<<", cash:"<<gCash<<"\n";
-					socket.disconnect("tcp://localhost:5556");
-					curRide->lifecycle_flags &= RIDE_LIFECYCLE_TESTED;
-					curRide->custom_name = "Test done";
-					// delete ride
-				    //RideSetStatusAction gameAction = RideSetStatusAction(curRide->id, RideStatus::Closed);
-				    //GameActions::ExecuteNested(&gameAction);				
-					//return;
-					//map_remove_all_rides();
-				
-				}
-			}
-		}
-	}
 
+    auto resultSink = TrackDesignResultSink::Get();
+    if (resultSink != nullptr && resultSink->IsReady() && (curRide->lifecycle_flags & RIDE_LIFECYCLE_TESTED)
+        && ride_has_ratings(curRide) && curRide->custom_name == "Test")
+    {
+        TrackDesignState tds{};
+        auto trackDesign = curRide->SaveToTrackDesign(tds);
+        if (trackDesign != nullptr)
+        {
+            auto errMessage = trackDesign->CreateTrackDesignScenery(tds);
+            if (errMessage != STR_NONE)
+            {
+                context_show_error(STR_CANT_SAVE_TRACK_DESIGN, errMessage, {});
+                log_error("Unable to save the design of the tested ride.");
+                return;
+            }
 
+            if (!resultSink->Publish(*curRide, *trackDesign))
+            {
+                log_error("Unable to publish the design of the tested ride.");
+            }
+            else
+            {
+                log_verbose("Published tested ride, excitement: %d", curRide->ratings.Excitement);
+                curRide->custom_name = "Test done";
+            }
+        }
+    }
 
     if (sub_state == 0)
     {
@@ -523,6 +523,13 @@ Vehicle* try_get_vehicle(EntityId spriteIndex);
 void vehicle_update_all();
 void vehicle_sounds_update();
 
+/**
+ * Runs the test of the given ride in a tight loop until it has finished or maxTicks have passed. Each iteration runs
+ * the same vehicle physics and measurements as a game tick, but only the ride and its own trains are updated and no
+ * vehicle sounds are produced. Returns the number of ticks simulated.
+ */
+uint32_t vehicle_update_test_run(Ride& ride, uint32_t maxTicks);
+
 extern Vehicle* gCurrentVehicle;
 extern StationIndex _vehicleStationIndex;
 extern uint32_t _vehicleMotionTrackFlags;
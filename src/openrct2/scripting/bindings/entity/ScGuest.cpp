@@ -12,6 +12,7 @@
 #    include "ScGuest.hpp"
 
 #    include "../../../entity/Guest.h"
+#    include "../../../entity/GuestNeeds.h"
 
 namespace OpenRCT2::Scripting
 {
@@ -142,6 +143,7 @@ namespace OpenRCT2::Scripting
         if (peep != nullptr)
         {
             peep->Happiness = value;
+            GuestNeeds::Get().Update(*peep);
         }
     }
 
@@ -172,6 +174,7 @@ namespace OpenRCT2::Scripting
         if (peep != nullptr)
         {
             peep->Nausea = value;
+            GuestNeeds::Get().Update(*peep);
         }
     }
 
@@ -202,6 +205,7 @@ namespace OpenRCT2::Scripting
         if (peep != nullptr)
         {
             peep->Hunger = value;
+            GuestNeeds::Get().Update(*peep);
         }
     }
 
@@ -217,6 +221,7 @@ namespace OpenRCT2::Scripting
         if (peep != nullptr)
         {
             peep->Thirst = value;
+            GuestNeeds::Get().Update(*peep);
         }
     }
 
@@ -232,6 +237,7 @@ namespace OpenRCT2::Scripting
         if (peep != nullptr)
         {
             peep->Toilet = value;
+            GuestNeeds::Get().Update(*peep);
         }
     }
 
@@ -307,6 +313,7 @@ namespace OpenRCT2::Scripting
         if (peep != nullptr)
         {
             peep->CashInPocket = std::max(0, value);
+            GuestNeeds::Get().Update(*peep);
         }
     }
 
@@ -334,6 +341,7 @@ namespace OpenRCT2::Scripting
         if (peep != nullptr)
         {
             peep->GuestIsLostCountdown = value;
+            GuestNeeds::Get().Update(*peep);
         }
     }
 
@@ -11,6 +11,8 @@
 
 #ifdef ENABLE_SCRIPTING
 
+#    include "../../../entity/Guest.h"
+#    include "../../../entity/GuestNeeds.h"
 #    include "ScEntity.hpp"
 
 namespace OpenRCT2::Scripting
@@ -112,6 +114,7 @@ namespace OpenRCT2::Scripting
                 else
                     peep->PeepFlags &= ~mask;
                 peep->Invalidate();
+                UpdateGuestNeeds(*peep);
             }
         }
 
@@ -150,6 +153,7 @@ namespace OpenRCT2::Scripting
             if (peep != nullptr)
             {
                 peep->Energy = value;
+                UpdateGuestNeeds(*peep);
             }
         }
 
@@ -173,6 +177,15 @@ namespace OpenRCT2::Scripting
         {
             return ::GetEntity<Peep>(_id);
         }
+
+        static void UpdateGuestNeeds(const Peep& peep)
+        {
+            auto guest = peep.As<Guest>();
+            if (guest != nullptr)
+            {
+                GuestNeeds::Get().Update(*guest);
+            }
+        }
     };
 
 } // namespace OpenRCT2::Scripting
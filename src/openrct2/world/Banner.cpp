@@ -467,6 +467,16 @@ size_t GetNumBanners()
     return count;
 }
 
+std::vector<Banner> CreateBannersCheckpoint()
+{
+    return _banners;
+}
+
+void RestoreBannersCheckpoint(const std::vector<Banner>& checkpoint)
+{
+    _banners = checkpoint;
+}
+
 bool HasReachedBannerLimit()
 {
     auto numBanners = GetNumBanners();
@@ -15,6 +15,7 @@
 #include "Location.hpp"
 
 #include <string>
+#include <vector>
 
 class Formatter;
 struct TileElement;
@@ -68,4 +69,10 @@ Banner* CreateBanner();
 void DeleteBanner(BannerIndex id);
 void TrimBanners();
 size_t GetNumBanners();
+
+/**
+ * Copies all banners so they can be put back with RestoreBannersCheckpoint.
+ */
+std::vector<Banner> CreateBannersCheckpoint();
+void RestoreBannersCheckpoint(const std::vector<Banner>& checkpoint);
 bool HasReachedBannerLimit();
@@ -27,6 +27,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../paint/VirtualFloor.h"
+#include "../peep/FootpathGraph.h"
 #include "../ride/RideData.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -1026,6 +1027,7 @@ void footpath_connect_edges(const CoordsXY& footpathPos, TileElement* tileElemen
     rct_neighbour_list neighbourList;
     rct_neighbour neighbour;
 
+    FootpathGraph::Get().InvalidateTile(footpathPos);
     footpath_update_queue_chains();
 
     neighbour_list_init(&neighbourList);
@@ -1165,7 +1167,12 @@ void footpath_chain_ride_queue(
             }
 
             tileElement->AsPath()->SetHasQueueBanner(false);
-            tileElement->AsPath()->SetEdges(tileElement->AsPath()->GetEdges() | (1 << direction_reverse(direction)));
+            tileElement->AsPath()->SetEdges(edges | (1 << direction_reverse(direction)));
+            if (tileElement->AsPath()->GetEdges() != edges)
+            {
+                // The new edge joins corridors that were walked without it
+                FootpathGraph::Get().InvalidateTile(targetQueuePos);
+            }
             tileElement->AsPath()->SetRideIndex(rideIndex);
             tileElement->AsPath()->SetStationIndex(entranceIndex);
 
@@ -2304,6 +2311,7 @@ void footpath_remove_edges_at(const CoordsXY& footpathPos, TileElement* tileElem
             return;
     }
 
+    FootpathGraph::Get().InvalidateTile(footpathPos);
     footpath_update_queue_entrance_banner(footpathPos, tileElement);
 
     bool fixCorners = false;
@@ -2390,6 +2398,11 @@ RideId PathElement::GetRideIndex() const
 
 void PathElement::SetRideIndex(RideId newRideIndex)
 {
+    if (rideIndex != newRideIndex)
+    {
+        // Searches skip queues of other rides, so routes found with the old owner may no longer be allowed
+        FootpathGraph::Get().ClearSearchCaches();
+    }
     rideIndex = newRideIndex;
 }
 
@@ -29,6 +29,8 @@
 #include "../network/network.h"
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
+#include "../paint/PaintCache.h"
+#include "../peep/FootpathGraph.h"
 #include "../profiling/Profiling.h"
 #include "../ride/RideConstruction.h"
 #include "../ride/RideData.h"
@@ -54,6 +56,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <memory>
 
 using namespace OpenRCT2;
@@ -116,6 +119,139 @@ static size_t _tileElementsInUseStash;
 static TileCoordsXY _mapSizeStash;
 static int32_t _currentRotationStash;
 
+// Dirty tile journal
+static bool _journalActive;
+static bool _journalAllDirty;
+static uint32_t _journalGeneration;
+static std::vector<bool> _journalDirtyFlags;
+static std::vector<TileCoordsXY> _journalDirtyTiles;
+// The tile each element of _tileElements belongs to, only kept up to date while the journal is active. Removing an
+// element only has the element to go by.
+static std::vector<uint32_t> _tileElementOwners;
+static constexpr uint32_t TILE_ELEMENT_OWNER_NONE = std::numeric_limits<uint32_t>::max();
+
+static size_t CountElementsOnTile(const CoordsXY& loc);
+static TileElement* AllocateTileElements(size_t numElementsOnTile, size_t numNewElements);
+
+static constexpr uint32_t GetTileOwnerIndex(const TileCoordsXY& tilePos)
+{
+    return tilePos.x + (tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL);
+}
+
+static bool IsInTileElements(const TileElement* tileElement)
+{
+    return !_tileElements.empty() && tileElement >= _tileElements.data()
+        && tileElement < _tileElements.data() + _tileElements.size();
+}
+
+static void JournalSetOwner(const TileElement* firstElement, size_t count, const TileCoordsXY& tilePos)
+{
+    if (!IsInTileElements(firstElement))
+        return;
+
+    auto first = static_cast<size_t>(firstElement - _tileElements.data());
+    if (_tileElementOwners.size() < _tileElements.size())
+    {
+        _tileElementOwners.resize(_tileElements.size(), TILE_ELEMENT_OWNER_NONE);
+    }
+    std::fill_n(_tileElementOwners.begin() + first, count, GetTileOwnerIndex(tilePos));
+}
+
+static void JournalRebuildOwners()
+{
+    _tileElementOwners.assign(_tileElements.size(), TILE_ELEMENT_OWNER_NONE);
+    for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+    {
+        for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+        {
+            const auto tilePos = TileCoordsXY{ x, y };
+            const auto* element = _tileIndex.GetFirstElementAt(tilePos);
+            if (element == nullptr)
+                continue;
+
+            size_t count = 1;
+            while (!element[count - 1].IsLastForTile())
+            {
+                count++;
+            }
+            JournalSetOwner(element, count, tilePos);
+        }
+    }
+}
+
+static void JournalMarkAllDirty()
+{
+    if (!_journalActive)
+        return;
+
+    _journalAllDirty = true;
+    JournalRebuildOwners();
+}
+
+static void JournalReset()
+{
+    for (const auto& tilePos : _journalDirtyTiles)
+    {
+        _journalDirtyFlags[GetTileOwnerIndex(tilePos)] = false;
+    }
+    _journalDirtyTiles.clear();
+    _journalAllDirty = false;
+}
+
+void MapStartDirtyTileJournal()
+{
+    _journalActive = true;
+    _journalDirtyFlags.assign(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL, false);
+    _journalDirtyTiles.clear();
+    _journalAllDirty = false;
+    _journalGeneration++;
+    JournalRebuildOwners();
+}
+
+void MapStopDirtyTileJournal()
+{
+    _journalActive = false;
+    _journalGeneration++;
+    _journalDirtyFlags = {};
+    _journalDirtyTiles = {};
+    _tileElementOwners = {};
+}
+
+bool MapIsDirtyTileJournalActive()
+{
+    return _journalActive;
+}
+
+void MapMarkTileDirty(const TileCoordsXY& tilePos)
+{
+    if (!_journalActive || tilePos.x < 0 || tilePos.y < 0 || tilePos.x >= MAXIMUM_MAP_SIZE_TECHNICAL
+        || tilePos.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+        return;
+
+    auto index = GetTileOwnerIndex(tilePos);
+    if (!_journalDirtyFlags[index])
+    {
+        _journalDirtyFlags[index] = true;
+        _journalDirtyTiles.push_back(tilePos);
+    }
+}
+
+bool MapAreAllTilesDirty()
+{
+    return _journalAllDirty;
+}
+
+const std::vector<TileCoordsXY>& MapGetDirtyTiles()
+{
+    return _journalDirtyTiles;
+}
+
+void MapClearDirtyTiles()
+{
+    JournalReset();
+    _journalGeneration++;
+}
+
 void StashMap()
 {
     _tileIndexStash = std::move(_tileIndex);
@@ -123,6 +259,9 @@ void StashMap()
     _mapSizeStash = gMapSize;
     _currentRotationStash = gCurrentRotation;
     _tileElementsInUseStash = _tileElementsInUse;
+    JournalMarkAllDirty();
+    FootpathGraph::Get().Invalidate();
+    PaintCache::Get().Invalidate();
 }
 
 void UnstashMap()
@@ -132,6 +271,110 @@ void UnstashMap()
     gMapSize = _mapSizeStash;
     gCurrentRotation = _currentRotationStash;
     _tileElementsInUse = _tileElementsInUseStash;
+    JournalMarkAllDirty();
+    FootpathGraph::Get().Invalidate();
+    PaintCache::Get().Invalidate();
+}
+
+MapCheckpoint CreateMapCheckpoint()
+{
+    MapCheckpoint checkpoint;
+    checkpoint.Elements = _tileElements;
+    checkpoint.Index = _tileIndex;
+    checkpoint.Base = _tileElements.data();
+    checkpoint.ElementsInUse = _tileElementsInUse;
+    checkpoint.MapSize = gMapSize;
+    if (_journalActive)
+    {
+        MapClearDirtyTiles();
+        checkpoint.JournalGeneration = _journalGeneration;
+    }
+    return checkpoint;
+}
+
+/**
+ * Replaces the elements of a tile with its elements in the checkpoint, moving the tile to the end of the elements if it
+ * has fewer elements than the checkpoint.
+ */
+static bool RestoreTileFromCheckpoint(const MapCheckpoint& checkpoint, const TileCoordsXY& tilePos)
+{
+    const auto* checkpointElement = checkpoint.Index.GetFirstElementAt(tilePos);
+    if (checkpointElement < checkpoint.Base || checkpointElement >= checkpoint.Base + checkpoint.Elements.size())
+        return false;
+
+    const auto* source = checkpoint.Elements.data() + (checkpointElement - checkpoint.Base);
+    size_t sourceCount = 1;
+    while (!source[sourceCount - 1].IsLastForTile())
+    {
+        sourceCount++;
+    }
+
+    auto* target = _tileIndex.GetFirstElementAt(tilePos);
+    if (!IsInTileElements(target))
+        return false;
+
+    auto freeElement = [](TileElement& element) { element.base_height = MAX_ELEMENT_HEIGHT; };
+    auto targetCount = CountElementsOnTile(tilePos.ToCoordsXY());
+    if (sourceCount > targetCount)
+    {
+        auto* newElements = AllocateTileElements(targetCount, sourceCount - targetCount);
+        if (newElements == nullptr)
+            return false;
+
+        // Allocating can reorganise the elements
+        target = _tileIndex.GetFirstElementAt(tilePos);
+        std::for_each_n(target, targetCount, freeElement);
+        target = newElements;
+        _tileIndex.SetTile(tilePos, target);
+        JournalSetOwner(target, sourceCount, tilePos);
+    }
+    else if (sourceCount < targetCount)
+    {
+        std::for_each(target + sourceCount, target + targetCount, freeElement);
+        _tileElementsInUse -= targetCount - sourceCount;
+    }
+    std::copy_n(source, sourceCount, target);
+    FootpathGraph::Get().InvalidateTile(tilePos.ToCoordsXY());
+    PaintCache::Get().InvalidateTile(tilePos.ToCoordsXY());
+    return true;
+}
+
+void RestoreMapCheckpoint(const MapCheckpoint& checkpoint)
+{
+    if (_journalActive && !_journalAllDirty && checkpoint.JournalGeneration == _journalGeneration
+        && checkpoint.MapSize == gMapSize)
+    {
+        // Copy the dirty tiles first, restoring one tile can reorganise the elements
+        auto dirtyTiles = _journalDirtyTiles;
+        auto restored = std::all_of(dirtyTiles.begin(), dirtyTiles.end(), [&checkpoint](const TileCoordsXY& tilePos) {
+            return RestoreTileFromCheckpoint(checkpoint, tilePos);
+        });
+        if (restored)
+        {
+            // The map is back to the checkpoint, so it stays valid for the next restore
+            JournalReset();
+            return;
+        }
+    }
+
+    // Keeps the current allocation unless it is too small, in which case the index is rebased below
+    _tileElements.assign(checkpoint.Elements.begin(), checkpoint.Elements.end());
+    _tileIndex = checkpoint.Index;
+    _tileIndex.Rebase(checkpoint.Base, _tileElements.data());
+    _tileElementsInUse = checkpoint.ElementsInUse;
+    gMapSize = checkpoint.MapSize;
+    FootpathGraph::Get().Invalidate();
+    PaintCache::Get().Invalidate();
+    if (_journalActive)
+    {
+        JournalRebuildOwners();
+        JournalReset();
+        if (checkpoint.JournalGeneration != _journalGeneration)
+        {
+            // Only tell other consumers that everything has changed if this was not the checkpoint's own journal
+            _journalAllDirty = true;
+        }
+    }
 }
 
 const std::vector<TileElement>& GetTileElements()
@@ -139,11 +382,23 @@ const std::vector<TileElement>& GetTileElements()
     return _tileElements;
 }
 
-void SetTileElements(std::vector<TileElement>&& tileElements)
+static void ReplaceTileElements(std::vector<TileElement>&& tileElements)
 {
     _tileElements = std::move(tileElements);
     _tileIndex = TilePointerIndex<TileElement>(MAXIMUM_MAP_SIZE_TECHNICAL, _tileElements.data(), _tileElements.size());
     _tileElementsInUse = _tileElements.size();
+    if (_journalActive)
+    {
+        JournalRebuildOwners();
+    }
+}
+
+void SetTileElements(std::vector<TileElement>&& tileElements)
+{
+    ReplaceTileElements(std::move(tileElements));
+    JournalMarkAllDirty();
+    FootpathGraph::Get().Invalidate();
+    PaintCache::Get().Invalidate();
 }
 
 static TileElement GetDefaultSurfaceElement()
@@ -226,7 +481,8 @@ static void ReorganiseTileElements(size_t capacity)
         }
     }
 
-    SetTileElements(std::move(newElements));
+    // The elements are only moved, no tile changes
+    ReplaceTileElements(std::move(newElements));
 }
 
 void ReorganiseTileElements()
@@ -267,8 +523,6 @@ static bool map_check_free_elements_and_reorganise(size_t numElementsOnTile, siz
     return true;
 }
 
-static size_t CountElementsOnTile(const CoordsXY& loc);
-
 bool MapCheckCapacityAndReorganise(const CoordsXY& loc, size_t numElements)
 {
     auto numElementsOnTile = CountElementsOnTile(loc);
@@ -379,6 +633,14 @@ void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements)
         return;
     }
     _tileIndex.SetTile(tilePos, elements);
+    if (_journalActive)
+    {
+        MapMarkTileDirty(tilePos);
+        if (elements != nullptr)
+        {
+            JournalSetOwner(elements, CountElementsOnTile(tilePos.ToCoordsXY()), tilePos);
+        }
+    }
 }
 
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords)
@@ -722,6 +984,25 @@ bool map_coord_is_connected(const TileCoordsXYZ& loc, uint8_t faceDirection)
     return false;
 }
 
+/**
+ * Returns one bit for each path element on the tile that is wide, so the journal can tell whether updating the wide
+ * flags changed the tile.
+ */
+static uint64_t GetPathWideFlags(const CoordsXY& loc)
+{
+    uint64_t wideFlags = 0;
+    size_t index = 0;
+    for (auto* pathElement : TileElementsView<PathElement>(loc))
+    {
+        if (pathElement->IsWide())
+        {
+            wideFlags |= 1ULL << (index % 64);
+        }
+        index++;
+    }
+    return wideFlags;
+}
+
 /**
  *
  *  rct2: 0x006A876D
@@ -742,7 +1023,20 @@ void map_update_path_wide_flags()
     auto y = gWidePathTileLoopPosition.y;
     for (int32_t i = 0; i < 128; i++)
     {
-        footpath_update_path_wide_flags({ x, y });
+        // The wide flags are changed in place without invalidating the tile
+        if (_journalActive)
+        {
+            auto wideFlags = GetPathWideFlags({ x, y });
+            footpath_update_path_wide_flags({ x, y });
+            if (GetPathWideFlags({ x, y }) != wideFlags)
+            {
+                MapMarkTileDirty(TileCoordsXY(CoordsXY{ x, y }));
+            }
+        }
+        else
+        {
+            footpath_update_path_wide_flags({ x, y });
+        }
 
         // Next x, y tile
         x += COORDS_XY_STEP;
@@ -1084,6 +1378,16 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  */
 void tile_element_remove(TileElement* tileElement)
 {
+    if (_journalActive && IsInTileElements(tileElement))
+    {
+        auto owner = _tileElementOwners[tileElement - _tileElements.data()];
+        if (owner != TILE_ELEMENT_OWNER_NONE)
+        {
+            MapMarkTileDirty({ static_cast<int32_t>(owner % MAXIMUM_MAP_SIZE_TECHNICAL),
+                               static_cast<int32_t>(owner / MAXIMUM_MAP_SIZE_TECHNICAL) });
+        }
+    }
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -1194,6 +1498,8 @@ void map_invalidate_selection_rect()
     if (!(gMapSelectFlags & MAP_SELECT_FLAG_ENABLE))
         return;
 
+    PaintCache::Get().InvalidateRange(gMapSelectPositionA, gMapSelectPositionB);
+
     x0 = gMapSelectPositionA.x + 16;
     y0 = gMapSelectPositionA.y + 16;
     x1 = gMapSelectPositionB.x + 16;
@@ -1250,6 +1556,11 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
 
     // Set tile index pointer to point to new element block
     _tileIndex.SetTile(tileLoc, newTileElement);
+    if (_journalActive)
+    {
+        MapMarkTileDirty(tileLoc);
+        JournalSetOwner(newTileElement, numElementsOnTileOld + 1, tileLoc);
+    }
 
     bool isLastForTile = false;
     if (originalTileElement == nullptr)
@@ -1848,6 +2159,11 @@ ScreenCoordsXY translate_3d_to_2d_with_z(int32_t rotation, const CoordsXYZ& pos)
 
 static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int32_t z1, ZoomLevel maxZoom)
 {
+    if (_journalActive)
+        MapMarkTileDirty(TileCoordsXY(CoordsXY{ x, y }));
+
+    PaintCache::Get().InvalidateTile({ x, y });
+
     if (gOpenRCT2Headless)
         return;
 
@@ -1910,6 +2226,8 @@ void map_invalidate_region(const CoordsXY& mins, const CoordsXY& maxs)
 {
     int32_t x0, y0, x1, y1, left, right, top, bottom;
 
+    PaintCache::Get().InvalidateRange(mins, maxs);
+
     x0 = mins.x + 16;
     y0 = mins.y + 16;
 
@@ -12,6 +12,7 @@
 #include "../common.h"
 #include "Location.hpp"
 #include "TileElement.h"
+#include "TilePointerIndex.hpp"
 
 #include <initializer_list>
 #include <vector>
@@ -150,6 +151,43 @@ const std::vector<TileElement>& GetTileElements();
 void SetTileElements(std::vector<TileElement>&& tileElements);
 void StashMap();
 void UnstashMap();
+
+/**
+ * A copy of the tile elements and the index into them, see CreateMapCheckpoint.
+ */
+struct MapCheckpoint
+{
+    std::vector<TileElement> Elements;
+    TilePointerIndex<TileElement> Index;
+    // Where the elements were when the index was copied
+    const TileElement* Base{};
+    size_t ElementsInUse{};
+    TileCoordsXY MapSize;
+    // Journal generation the checkpoint was created in, 0 if the dirty tile journal was not active
+    uint32_t JournalGeneration{};
+};
+
+/**
+ * Copies the tile elements so they can be put back with RestoreMapCheckpoint. Unlike StashMap, the current map stays
+ * in place. If the dirty tile journal is active, it is cleared and the restore only rewrites the tiles that have been
+ * marked dirty since.
+ */
+MapCheckpoint CreateMapCheckpoint();
+void RestoreMapCheckpoint(const MapCheckpoint& checkpoint);
+
+/**
+ * The dirty tile journal records which tiles have changed while it is active. Inserting and removing elements,
+ * pointing a tile to other elements and invalidating a tile for redrawing all mark the tile as dirty. Elements that
+ * are changed in place without invalidating their tile must be marked with MapMarkTileDirty. Moving elements around
+ * when they are reorganised does not change any tile, loading a new map marks all tiles as dirty.
+ */
+void MapStartDirtyTileJournal();
+void MapStopDirtyTileJournal();
+bool MapIsDirtyTileJournalActive();
+void MapMarkTileDirty(const TileCoordsXY& tilePos);
+bool MapAreAllTilesDirty();
+const std::vector<TileCoordsXY>& MapGetDirtyTiles();
+void MapClearDirtyTiles();
 std::vector<TileElement> GetReorganisedTileElementsWithoutGhosts();
 
 void map_init(const TileCoordsXY& size);
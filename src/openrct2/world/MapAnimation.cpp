@@ -605,6 +605,11 @@ const std::vector<MapAnimation>& GetMapAnimations()
     return _mapAnimations;
 }
 
+void RestoreMapAnimationsCheckpoint(const std::vector<MapAnimation>& checkpoint)
+{
+    _mapAnimations = checkpoint;
+}
+
 static void ClearMapAnimations()
 {
     _mapAnimations.clear();
@@ -42,4 +42,8 @@ enum
 void map_animation_create(int32_t type, const CoordsXYZ& loc);
 void map_animation_invalidate_all();
 const std::vector<MapAnimation>& GetMapAnimations();
+/**
+ * Replaces the map animations with a copy taken from GetMapAnimations.
+ */
+void RestoreMapAnimationsCheckpoint(const std::vector<MapAnimation>& checkpoint);
 void AutoCreateMapAnimations();
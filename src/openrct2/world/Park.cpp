@@ -17,8 +17,10 @@
 #include "../OpenRCT2.h"
 #include "../actions/ParkSetParameterAction.h"
 #include "../config/Config.h"
+#include "../core/Guard.hpp"
 #include "../core/Memory.hpp"
 #include "../core/String.hpp"
+#include "../entity/GuestNeeds.h"
 #include "../entity/Litter.h"
 #include "../entity/Peep.h"
 #include "../entity/Staff.h"
@@ -367,6 +369,47 @@ int32_t Park::CalculateParkSize() const
     return tiles;
 }
 
+#ifdef DEBUG
+/**
+ * Recounts the guests the slow way to catch the running counts drifting from the guests they were taken from.
+ */
+static void CheckGuestCounts(uint32_t happyGuestCount, uint32_t lostGuestCount)
+{
+    uint32_t expectedHappyGuestCount = 0;
+    uint32_t expectedLostGuestCount = 0;
+    for (auto peep : EntityList<Guest>())
+    {
+        if (!peep->OutsideOfPark)
+        {
+            if (peep->Happiness > GuestNeeds::HappyThreshold)
+            {
+                expectedHappyGuestCount++;
+            }
+            if ((peep->PeepFlags & PEEP_FLAGS_LEAVING_PARK)
+                && (peep->GuestIsLostCountdown < GuestNeeds::LostCountdownThreshold))
+            {
+                expectedLostGuestCount++;
+            }
+        }
+    }
+    Guard::Assert(
+        happyGuestCount == expectedHappyGuestCount, "Happy guest count is %u, expected %u", happyGuestCount,
+        expectedHappyGuestCount);
+    Guard::Assert(
+        lostGuestCount == expectedLostGuestCount, "Lost guest count is %u, expected %u", lostGuestCount,
+        expectedLostGuestCount);
+}
+
+static void CheckLitterCount(uint32_t oldLitterCount)
+{
+    const auto litterList = EntityList<Litter>();
+    const auto expectedLitterCount = static_cast<uint32_t>(std::count_if(
+        litterList.begin(), litterList.end(), [](auto* litter) { return litter->GetAge() >= Litter::OldAge; }));
+    Guard::Assert(
+        oldLitterCount == expectedLitterCount, "Old litter count is %u, expected %u", oldLitterCount, expectedLitterCount);
+}
+#endif
+
 int32_t Park::CalculateParkRating() const
 {
     if (_forcedParkRating >= 0)
@@ -386,22 +429,13 @@ int32_t Park::CalculateParkRating() const
         result -= 150 - (std::min<int16_t>(2000, gNumGuestsInPark) / 13);
 
         // Find the number of happy peeps and the number of peeps who can't find the park exit
-        uint32_t happyGuestCount = 0;
-        uint32_t lostGuestCount = 0;
-        for (auto peep : EntityList<Guest>())
-        {
-            if (!peep->OutsideOfPark)
-            {
-                if (peep->Happiness > 128)
-                {
-                    happyGuestCount++;
-                }
-                if ((peep->PeepFlags & PEEP_FLAGS_LEAVING_PARK) && (peep->GuestIsLostCountdown < 90))
-                {
-                    lostGuestCount++;
-                }
-            }
-        }
+        auto& guestNeeds = GuestNeeds::Get();
+        guestNeeds.Validate();
+        uint32_t happyGuestCount = guestNeeds.GetHappyGuestCount();
+        uint32_t lostGuestCount = guestNeeds.GetLostGuestCount();
+#ifdef DEBUG
+        CheckGuestCounts(happyGuestCount, lostGuestCount);
+#endif
 
         // Peep happiness -500 to +0
         result -= 500;
@@ -471,9 +505,10 @@ int32_t Park::CalculateParkRating() const
     // Litter
     {
         // Counts the amount of litter whose age is min. 7680 ticks (5~ min) old.
-        const auto litterList = EntityList<Litter>();
-        const auto litterCount = std::count_if(
-            litterList.begin(), litterList.end(), [](auto* litter) { return litter->GetAge() >= 7680; });
+        const auto litterCount = Litter::CountOld();
+#ifdef DEBUG
+        CheckLitterCount(litterCount);
+#endif
 
         result -= 600 - (4 * (150 - std::min<int32_t>(150, litterCount)));
     }
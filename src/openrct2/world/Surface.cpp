@@ -90,6 +90,11 @@ void SurfaceElement::SetGrassLengthAndInvalidate(uint8_t length, const CoordsXY&
     uint8_t oldLength = GrassLength & 0x7;
     uint8_t newLength = length & 0x7;
 
+    // Changes that do not show are not invalidated below, but the journal still has to know about them
+    if (GrassLength != length)
+    {
+        MapMarkTileDirty(TileCoordsXY(coords));
+    }
     GrassLength = length;
 
     if (newLength == oldLength)
@@ -145,6 +150,7 @@ void SurfaceElement::UpdateGrassLength(const CoordsXY& coords)
         if (tileElementAbove->IsLastForTile())
         {
             // Grow grass
+            MapMarkTileDirty(TileCoordsXY(coords));
 
             // Check interim grass lengths
             uint8_t lengthNibble = (GetGrassLength() & 0xF0) >> 4;
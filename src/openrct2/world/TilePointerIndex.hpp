@@ -48,8 +48,28 @@ public:
         return TilePointers[coords.x + (coords.y * MapSize)];
     }
 
+    const T* GetFirstElementAt(TileCoordsXY coords) const
+    {
+        return TilePointers[coords.x + (coords.y * MapSize)];
+    }
+
     void SetTile(TileCoordsXY coords, T* tileElement)
     {
         TilePointers[coords.x + (coords.y * MapSize)] = tileElement;
     }
+
+    /**
+     * Moves all pointers from the elements at oldBase to the same elements at newBase, for when the elements have
+     * been copied somewhere else.
+     */
+    void Rebase(const T* oldBase, T* newBase)
+    {
+        if (oldBase == newBase)
+            return;
+
+        for (auto& tilePointer : TilePointers)
+        {
+            tilePointer = newBase + (tilePointer - oldBase);
+        }
+    }
 };
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "BigMapTestBase.h"
+
+#include "TestData.h"
+
+#include <algorithm>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/GameStateSnapshots.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/core/DataSerialiser.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/entity/EntityTweener.h>
+#include <openrct2/object/ObjectManager.h>
+#include <openrct2/platform/Platform.h>
+#include <openrct2/scenario/Scenario.h>
+#include <openrct2/world/MapAnimation.h>
+#include <openrct2/world/Scenery.h>
+#include <string>
+
+using namespace OpenRCT2;
+
+void BigMapTestBase::SetUp()
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    Platform::CoreInit();
+
+    _context = CreateContext();
+    ASSERT_NE(_context, nullptr);
+    ASSERT_TRUE(_context->Initialise());
+
+    std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+    auto importer = ParkImporter::CreateS6(_context->GetObjectRepository());
+    auto loadResult = importer->Load(testParkPath.c_str());
+    _context->GetObjectManager().LoadObjects(loadResult.RequiredObjects);
+    importer->Import();
+
+    ResetEntitySpatialIndices();
+    reset_all_sprite_quadrant_placements();
+    scenery_set_default_placement_configuration();
+    load_palette();
+    EntityTweener::Get().Reset();
+    AutoCreateMapAnimations();
+    fix_invalid_vehicle_sprite_sizes();
+
+    gGameSpeed = 1;
+}
+
+void BigMapTestBase::TearDown()
+{
+    _context = nullptr;
+}
+
+void BigMapTestBase::AdvanceGameTicks(uint32_t ticks)
+{
+    auto* gameState = _context->GetGameState();
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        gameState->UpdateLogic();
+    }
+}
+
+void BigMapTestBase::RecordGameStateSnapshot()
+{
+    auto* snapshots = _context->GetGameStateSnapshots();
+
+    auto& snapshot = snapshots->CreateSnapshot();
+    snapshots->Capture(snapshot);
+    snapshots->LinkSnapshot(snapshot, gCurrentTicks, scenario_rand_state().s0);
+    DataSerialiser snapShotDs(true, _snapshotStream);
+    snapshots->SerialiseSnapshot(snapshot, snapShotDs);
+}
+
+void BigMapTestBase::CompareSnapshots()
+{
+    _snapshotStream.SetPosition(0);
+    DataSerialiser ds(false, _snapshotStream);
+    auto* snapshots = _context->GetGameStateSnapshots();
+
+    GameStateSnapshot_t& firstSnapshot = snapshots->CreateSnapshot();
+    snapshots->SerialiseSnapshot(firstSnapshot, ds);
+
+    GameStateSnapshot_t& secondSnapshot = snapshots->CreateSnapshot();
+    snapshots->SerialiseSnapshot(secondSnapshot, ds);
+
+    try
+    {
+        GameStateCompareData_t cmpData = snapshots->Compare(firstSnapshot, secondSnapshot);
+
+        // Find out if there are any differences between the two states
+        auto res = std::find_if(
+            cmpData.spriteChanges.begin(), cmpData.spriteChanges.end(),
+            [](const GameStateSpriteChange_t& diff) { return diff.changeType != GameStateSpriteChange_t::EQUAL; });
+
+        if (res != cmpData.spriteChanges.end())
+        {
+            log_warning("Snapshot data differences. %s", snapshots->GetCompareDataText(cmpData).c_str());
+            FAIL();
+        }
+    }
+    catch (const std::runtime_error& err)
+    {
+        log_warning("Snapshot data failed to be read. Snapshot not compared. %s", err.what());
+        FAIL();
+    }
+}
@@ -0,0 +1,37 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/core/MemoryStream.h>
+
+/**
+ * Fixture for tests that run the simulation on BigMapTest.sv6, which is loaded into a new context before each test.
+ */
+class BigMapTestBase : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    void AdvanceGameTicks(uint32_t ticks);
+
+    // Serialises a snapshot of the game state, CompareSnapshots compares the first two recorded
+    void RecordGameStateSnapshot();
+    void CompareSnapshots();
+
+    std::unique_ptr<OpenRCT2::IContext> _context;
+
+private:
+    OpenRCT2::MemoryStream _snapshotStream;
+};
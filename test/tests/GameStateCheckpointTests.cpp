@@ -0,0 +1,91 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "BigMapTestBase.h"
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/GameStateCheckpoint.h>
+#include <openrct2/management/NewsItem.h>
+#include <openrct2/scenario/Scenario.h>
+#include <openrct2/world/Climate.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/MapAnimation.h>
+#include <openrct2/world/Scenery.h>
+
+using namespace OpenRCT2;
+
+class GameStateCheckpointTests : public BigMapTestBase
+{
+};
+
+TEST_F(GameStateCheckpointTests, RestoreAfterAdvancingTicks)
+{
+    AdvanceGameTicks(100);
+    RecordGameStateSnapshot();
+
+    auto* gameState = _context->GetGameState();
+    auto ticks = gCurrentTicks;
+    auto tileElements = GetTileElements();
+    auto checkpoint = gameState->Checkpoint();
+
+    AdvanceGameTicks(1000);
+    gameState->Restore(*checkpoint);
+
+    ASSERT_EQ(gCurrentTicks, ticks);
+    const auto& restoredTileElements = GetTileElements();
+    ASSERT_EQ(restoredTileElements.size(), tileElements.size());
+    ASSERT_EQ(std::memcmp(restoredTileElements.data(), tileElements.data(), tileElements.size() * sizeof(TileElement)), 0);
+
+    RecordGameStateSnapshot();
+    CompareSnapshots();
+}
+
+TEST_F(GameStateCheckpointTests, RunAfterRestoreMatchesFirstRun)
+{
+    AdvanceGameTicks(100);
+
+    auto* gameState = _context->GetGameState();
+    auto checkpoint = gameState->Checkpoint();
+
+    AdvanceGameTicks(1000);
+    RecordGameStateSnapshot();
+    auto randState = scenario_rand_state();
+    auto climate = gClimateCurrent;
+    auto climateUpdateTimer = gClimateUpdateTimer;
+    auto grassPosition = gGrassSceneryTileLoopPosition;
+    auto widePathPosition = gWidePathTileLoopPosition;
+    auto numAnimations = GetMapAnimations().size();
+    const auto& recentNews = gNewsItems.GetRecent();
+    auto numNewsItems = std::distance(recentNews.begin(), recentNews.end());
+    auto tileElements = GetTileElements();
+
+    // Replaying the same ticks from the checkpoint must end in the same state
+    gameState->Restore(*checkpoint);
+    AdvanceGameTicks(1000);
+    RecordGameStateSnapshot();
+
+    ASSERT_EQ(scenario_rand_state().s0, randState.s0);
+    ASSERT_EQ(scenario_rand_state().s1, randState.s1);
+    ASSERT_EQ(gClimateCurrent.Weather, climate.Weather);
+    ASSERT_EQ(gClimateCurrent.Temperature, climate.Temperature);
+    ASSERT_EQ(gClimateUpdateTimer, climateUpdateTimer);
+    ASSERT_EQ(gGrassSceneryTileLoopPosition, grassPosition);
+    ASSERT_EQ(gWidePathTileLoopPosition, widePathPosition);
+    ASSERT_EQ(GetMapAnimations().size(), numAnimations);
+    ASSERT_EQ(std::distance(recentNews.begin(), recentNews.end()), numNewsItems);
+    const auto& replayedTileElements = GetTileElements();
+    ASSERT_EQ(replayedTileElements.size(), tileElements.size());
+    ASSERT_EQ(std::memcmp(replayedTileElements.data(), tileElements.data(), tileElements.size() * sizeof(TileElement)), 0);
+
+    CompareSnapshots();
+}
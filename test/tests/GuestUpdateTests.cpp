@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "BigMapTestBase.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/GameState.h>
+#include <openrct2/GameStateCheckpoint.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/entity/EntityList.h>
+#include <openrct2/entity/Guest.h>
+#include <openrct2/entity/GuestNeeds.h>
+#include <openrct2/scenario/Scenario.h>
+#include <utility>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class GuestUpdateTests : public BigMapTestBase
+{
+protected:
+    // Has every guest that can pick a ride do so, recording the ride they head for and where the RNG ends up
+    static std::vector<std::pair<RideId, uint32_t>> PickRidesForAllGuests()
+    {
+        std::vector<std::pair<RideId, uint32_t>> picks;
+        for (auto guest : EntityList<Guest>())
+        {
+            if (!guest->CanPickRideToGoOn())
+                continue;
+
+            guest->PickRideToGoOn();
+            picks.emplace_back(guest->GuestHeadingToRideId, scenario_rand());
+        }
+        return picks;
+    }
+};
+
+TEST_F(GuestUpdateTests, MultithreadingMatchesSerial)
+{
+    auto* gameState = _context->GetGameState();
+    auto checkpoint = gameState->Checkpoint();
+    auto multithreading = gConfigGeneral.multithreading;
+
+    gConfigGeneral.multithreading = false;
+    AdvanceGameTicks(1000);
+    RecordGameStateSnapshot();
+
+    gameState->Restore(*checkpoint);
+    gConfigGeneral.multithreading = true;
+    AdvanceGameTicks(1000);
+    RecordGameStateSnapshot();
+
+    gConfigGeneral.multithreading = multithreading;
+
+    CompareSnapshots();
+}
+
+TEST_F(GuestUpdateTests, RideFiltersMatchCheckingEveryRide)
+{
+    AdvanceGameTicks(1000);
+
+    auto* gameState = _context->GetGameState();
+    auto checkpoint = gameState->Checkpoint();
+
+    auto picks = PickRidesForAllGuests();
+    ASSERT_FALSE(picks.empty());
+
+    gameState->Restore(*checkpoint);
+    guest_prepare_ride_filters();
+    auto filteredPicks = PickRidesForAllGuests();
+    guest_discard_ride_filters();
+
+    ASSERT_EQ(filteredPicks, picks);
+}
+
+TEST_F(GuestUpdateTests, NeedsMatchGuestsAfterAdvancingTicks)
+{
+    AdvanceGameTicks(1000);
+
+    uint32_t guestCount = 0;
+    uint32_t happyGuestCount = 0;
+    uint32_t lostGuestCount = 0;
+    auto& guestNeeds = GuestNeeds::Get();
+    guestNeeds.Validate();
+    for (auto guest : EntityList<Guest>())
+    {
+        const auto needs = guestNeeds.GetRow(*guest);
+        ASSERT_EQ(needs.Happiness, guest->Happiness);
+        ASSERT_EQ(needs.Energy, guest->Energy);
+        ASSERT_EQ(needs.Hunger, guest->Hunger);
+        ASSERT_EQ(needs.Thirst, guest->Thirst);
+        ASSERT_EQ(needs.Toilet, guest->Toilet);
+        ASSERT_EQ(needs.Nausea, guest->Nausea);
+        ASSERT_EQ(needs.CashInPocket, guest->CashInPocket);
+
+        guestCount++;
+        if (guest->OutsideOfPark)
+            continue;
+
+        if (guest->Happiness > 128)
+            happyGuestCount++;
+        if ((guest->PeepFlags & PEEP_FLAGS_LEAVING_PARK) && guest->GuestIsLostCountdown < 90)
+            lostGuestCount++;
+    }
+
+    ASSERT_EQ(guestNeeds.GetCount(), guestCount);
+    ASSERT_EQ(guestNeeds.GetHappyGuestCount(), happyGuestCount);
+    ASSERT_EQ(guestNeeds.GetLostGuestCount(), lostGuestCount);
+}
@@ -11,7 +11,9 @@
 
 #include <gtest/gtest.h>
 #include <openrct2/core/Path.hpp>
+#include <openrct2/core/Imaging.h>
 #include <openrct2/drawing/ImageImporter.h>
+#include <sstream>
 #include <string_view>
 
 using namespace OpenRCT2::Drawing;
@@ -56,3 +58,35 @@ TEST_F(ImageImporterTests, Import_Logo)
     auto hash = GetHash(result.Buffer.data(), result.Buffer.size());
     ASSERT_EQ(0xCEF27C7D, hash);
 }
+
+TEST_F(ImageImporterTests, PngWriter_WritesRowsInBlocks)
+{
+    constexpr uint32_t width = 7;
+    constexpr uint32_t height = 5;
+    constexpr uint32_t stride = 9;
+    std::vector<uint8_t> pixels(stride * height);
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        pixels[i] = static_cast<uint8_t>(i * 37);
+    }
+
+    GamePalette palette{};
+    std::ostringstream ostream(std::ios::binary);
+    Imaging::PngWriter writer(ostream, width, height, 8, &palette);
+    writer.WriteRows(pixels.data(), 2, stride);
+    writer.WriteRows(pixels.data() + stride * 2, 3, stride);
+    ASSERT_THROW(writer.WriteRows(pixels.data(), 1, stride), std::invalid_argument);
+    writer.Finish();
+
+    const auto data = ostream.str();
+    auto image = Imaging::ReadFromBuffer(std::vector<uint8_t>(data.begin(), data.end()), IMAGE_FORMAT::PNG);
+    ASSERT_EQ(width, image.Width);
+    ASSERT_EQ(height, image.Height);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            ASSERT_EQ(pixels[y * stride + x], image.Pixels[y * image.Stride + x]);
+        }
+    }
+}
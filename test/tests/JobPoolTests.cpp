@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <openrct2/core/JobPool.h>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+class JobPoolTest : public testing::TestWithParam<size_t>
+{
+};
+
+TEST_P(JobPoolTest, ParallelForVisitsEveryIndexOnce)
+{
+    JobPool jobPool(GetParam());
+    for (size_t chunkSize : { 0, 1, 7, 5000 })
+    {
+        std::vector<std::atomic<int32_t>> visits(3001);
+        jobPool.ParallelFor(visits.size(), [&visits](size_t i) { visits[i]++; }, chunkSize);
+        for (size_t i = 0; i < visits.size(); i++)
+        {
+            ASSERT_EQ(visits[i], 1) << "index " << i << " with chunk size " << chunkSize;
+        }
+    }
+}
+
+TEST_P(JobPoolTest, JoinWaitsForMoreTasksThanTheQueueHolds)
+{
+    JobPool jobPool(GetParam());
+    std::atomic<int32_t> count{};
+    for (int32_t i = 0; i < 5000; i++)
+    {
+        jobPool.AddTask([&count]() { count++; });
+    }
+    jobPool.Join();
+    ASSERT_EQ(count, 5000);
+    ASSERT_EQ(jobPool.CountPending(), 0u);
+}
+
+TEST_P(JobPoolTest, TaskGroupsCanBeNested)
+{
+    JobPool jobPool(GetParam());
+    std::atomic<int32_t> count{};
+    JobPool::TaskGroup group;
+    for (int32_t i = 0; i < 20; i++)
+    {
+        // Too large to be stored inline
+        std::string name(100, 'a' + i);
+        std::array<char, 64> padding{};
+        jobPool.AddTask(group, [&jobPool, &count, name, padding]() {
+            jobPool.ParallelFor(name.size() + padding.size(), [&count](size_t) { count++; });
+        });
+    }
+    jobPool.Wait(group);
+    ASSERT_TRUE(group.IsDone());
+    ASSERT_EQ(count, 20 * 164);
+}
+
+INSTANTIATE_TEST_CASE_P(WorkerThreads, JobPoolTest, testing::Values(0, 1, 4));
+
+#ifndef _WIN32
+TEST(JobPoolForkTest, ForkedChildGetsWorkingSharedPool)
+{
+    std::atomic<int32_t> count{};
+    JobPool::Get().ParallelFor(100, [&count](size_t) { count++; });
+    ASSERT_EQ(count, 100);
+    // Lets the worker threads of the shared pool go to sleep before forking
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0)
+    {
+        // Killed by the alarm if the pool hangs
+        alarm(10);
+        std::atomic<int32_t> childCount{};
+        std::mutex threadsMutex;
+        std::set<std::thread::id> threads;
+        JobPool::Get().ParallelFor(
+            200,
+            [&](size_t) {
+                childCount++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                std::lock_guard<std::mutex> lock(threadsMutex);
+                threads.insert(std::this_thread::get_id());
+            },
+            1);
+        // The worker threads of the parent do not exist here, tasks only run on more threads with a pool of its own
+        const bool usedWorkers = JobPool::Get().GetThreadCount() == 1 || threads.size() > 1;
+        _exit(childCount == 200 && usedWorkers ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+#endif
@@ -0,0 +1,56 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "BigMapTestBase.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/entity/EntityList.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/entity/Litter.h>
+#include <openrct2/world/Map.h>
+
+using namespace OpenRCT2;
+
+class LitterTests : public BigMapTestBase
+{
+};
+
+TEST_F(LitterTests, OldLitterCountMatchesAges)
+{
+    for (int32_t i = 0; i < 10; i++)
+    {
+        AdvanceGameTicks(1000);
+
+        uint32_t oldLitterCount = 0;
+        for (auto litter : EntityList<Litter>())
+        {
+            if (litter->GetAge() >= Litter::OldAge)
+                oldLitterCount++;
+        }
+        ASSERT_EQ(Litter::CountOld(), oldLitterCount);
+    }
+}
+
+TEST_F(LitterTests, BlockIndexMatchesLitterList)
+{
+    for (int32_t i = 0; i < 10; i++)
+    {
+        AdvanceGameTicks(1000);
+
+        const auto centre = CoordsXY{ MAXIMUM_MAP_SIZE_BIG / 2, MAXIMUM_MAP_SIZE_BIG / 2 };
+        ASSERT_EQ(GetLitterInRange(centre, MAXIMUM_MAP_SIZE_BIG).size(), GetEntityListCount(EntityType::Litter));
+
+        for (auto litter : EntityList<Litter>())
+        {
+            auto nearby = GetLitterInRange({ litter->x, litter->y }, 0);
+            ASSERT_NE(std::find(nearby.begin(), nearby.end(), litter->sprite_index), nearby.end());
+        }
+    }
+}
@@ -0,0 +1,498 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/Intro.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/drawing/NewDrawing.h>
+#include <openrct2/interface/Viewport.h>
+#include <openrct2/paint/Paint.h>
+#include <openrct2/world/Map.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace OpenRCT2;
+
+/**
+ * PaintSessionArrange as it was before it skipped blocks of paint structs that can not be moved. The order it
+ * produces is the outcome of its sequence of visits and moves, so the current implementation has to match it exactly.
+ */
+namespace ReferenceArrange
+{
+    namespace PaintSortFlags
+    {
+        static constexpr uint8_t None = 0;
+        static constexpr uint8_t PendingVisit = (1U << 0);
+        static constexpr uint8_t Neighbour = (1U << 1);
+        static constexpr uint8_t OutsideQuadrant = (1U << 7);
+    } // namespace PaintSortFlags
+
+    template<uint8_t>
+    static bool CheckBoundingBox(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+    {
+        return false;
+    }
+
+    template<> bool CheckBoundingBox<0>(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+    {
+        if (initialBBox.z_end >= currentBBox.z && initialBBox.y_end >= currentBBox.y && initialBBox.x_end >= currentBBox.x
+            && !(initialBBox.z < currentBBox.z_end && initialBBox.y < currentBBox.y_end
+                 && initialBBox.x < currentBBox.x_end))
+        {
+            return true;
+        }
+        return false;
+    }
+
+    template<> bool CheckBoundingBox<1>(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+    {
+        if (initialBBox.z_end >= currentBBox.z && initialBBox.y_end >= currentBBox.y && initialBBox.x_end < currentBBox.x
+            && !(initialBBox.z < currentBBox.z_end && initialBBox.y < currentBBox.y_end
+                 && initialBBox.x >= currentBBox.x_end))
+        {
+            return true;
+        }
+        return false;
+    }
+
+    template<> bool CheckBoundingBox<2>(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+    {
+        if (initialBBox.z_end >= currentBBox.z && initialBBox.y_end < currentBBox.y && initialBBox.x_end < currentBBox.x
+            && !(initialBBox.z < currentBBox.z_end && initialBBox.y >= currentBBox.y_end
+                 && initialBBox.x >= currentBBox.x_end))
+        {
+            return true;
+        }
+        return false;
+    }
+
+    template<> bool CheckBoundingBox<3>(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+    {
+        if (initialBBox.z_end >= currentBBox.z && initialBBox.y_end < currentBBox.y && initialBBox.x_end >= currentBBox.x
+            && !(initialBBox.z < currentBBox.z_end && initialBBox.y >= currentBBox.y_end
+                 && initialBBox.x < currentBBox.x_end))
+        {
+            return true;
+        }
+        return false;
+    }
+
+    template<uint8_t TRotation>
+    static paint_struct* ArrangeStructsHelperRotation(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
+    {
+        paint_struct* ps;
+        paint_struct* ps_temp;
+        do
+        {
+            ps = ps_next;
+            ps_next = ps_next->next_quadrant_ps;
+            if (ps_next == nullptr)
+                return ps;
+        } while (quadrantIndex > ps_next->quadrant_index);
+
+        paint_struct* psQuadrantEntry = ps;
+
+        ps_temp = ps;
+        do
+        {
+            ps = ps->next_quadrant_ps;
+            if (ps == nullptr)
+                break;
+
+            if (ps->quadrant_index > quadrantIndex + 1)
+            {
+                ps->SortFlags = PaintSortFlags::OutsideQuadrant;
+            }
+            else if (ps->quadrant_index == quadrantIndex + 1)
+            {
+                ps->SortFlags = PaintSortFlags::Neighbour | PaintSortFlags::PendingVisit;
+            }
+            else if (ps->quadrant_index == quadrantIndex)
+            {
+                ps->SortFlags = flag | PaintSortFlags::PendingVisit;
+            }
+        } while (ps->quadrant_index <= quadrantIndex + 1);
+        ps = ps_temp;
+
+        while (true)
+        {
+            while (true)
+            {
+                ps_next = ps->next_quadrant_ps;
+                if (ps_next == nullptr)
+                    return psQuadrantEntry;
+                if (ps_next->SortFlags & PaintSortFlags::OutsideQuadrant)
+                    return psQuadrantEntry;
+                if (ps_next->SortFlags & PaintSortFlags::PendingVisit)
+                    break;
+                ps = ps_next;
+            }
+
+            ps_next->SortFlags &= ~PaintSortFlags::PendingVisit;
+            ps_temp = ps;
+
+            const paint_struct_bound_box& initialBBox = ps_next->bounds;
+            while (true)
+            {
+                ps = ps_next;
+                ps_next = ps_next->next_quadrant_ps;
+                if (ps_next == nullptr)
+                    break;
+                if (ps_next->SortFlags & PaintSortFlags::OutsideQuadrant)
+                    break;
+                if (!(ps_next->SortFlags & PaintSortFlags::Neighbour))
+                    continue;
+
+                if (CheckBoundingBox<TRotation>(initialBBox, ps_next->bounds))
+                {
+                    ps->next_quadrant_ps = ps_next->next_quadrant_ps;
+                    paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
+                    ps_temp->next_quadrant_ps = ps_next;
+                    ps_next->next_quadrant_ps = ps_temp2;
+                    ps_next = ps;
+                }
+            }
+
+            ps = ps_temp;
+        }
+    }
+
+    template<uint8_t TRotation> static void Arrange(PaintSessionCore& session)
+    {
+        paint_struct* psHead = &session.PaintHead;
+        paint_struct* ps = psHead;
+        ps->next_quadrant_ps = nullptr;
+
+        uint32_t quadrantIndex = session.QuadrantBackIndex;
+        if (quadrantIndex == UINT32_MAX)
+            return;
+
+        do
+        {
+            paint_struct* ps_next = session.Quadrants[quadrantIndex];
+            if (ps_next != nullptr)
+            {
+                ps->next_quadrant_ps = ps_next;
+                do
+                {
+                    ps = ps_next;
+                    ps_next = ps_next->next_quadrant_ps;
+                } while (ps_next != nullptr);
+            }
+        } while (++quadrantIndex <= session.QuadrantFrontIndex);
+
+        paint_struct* ps_cache = ArrangeStructsHelperRotation<TRotation>(
+            psHead, session.QuadrantBackIndex & 0xFFFF, PaintSortFlags::Neighbour);
+
+        quadrantIndex = session.QuadrantBackIndex;
+        while (++quadrantIndex < session.QuadrantFrontIndex)
+        {
+            ps_cache = ArrangeStructsHelperRotation<TRotation>(ps_cache, quadrantIndex & 0xFFFF, PaintSortFlags::None);
+        }
+    }
+
+    static void Arrange(PaintSessionCore& session)
+    {
+        switch (session.CurrentRotation)
+        {
+            case 0:
+                return Arrange<0>(session);
+            case 1:
+                return Arrange<1>(session);
+            case 2:
+                return Arrange<2>(session);
+            case 3:
+                return Arrange<3>(session);
+        }
+    }
+} // namespace ReferenceArrange
+
+class PaintArrangeTests : public testing::Test
+{
+protected:
+    static constexpr uint8_t NumRotations = 4;
+
+    static void SetUpTestCase()
+    {
+        gOpenRCT2Headless = true;
+        _context = CreateContext();
+        ASSERT_TRUE(_context->Initialise());
+        drawing_engine_init();
+        ASSERT_TRUE(_context->LoadParkFromFile(TestData::GetParkPath("bpb.sv6")));
+
+        gIntroState = IntroState::None;
+        gScreenFlags = SCREEN_FLAGS_PLAYING;
+        for (uint8_t rotation = 0; rotation < NumRotations; rotation++)
+        {
+            _sessions[rotation] = RecordSessions(rotation);
+        }
+        gCurrentRotation = 0;
+        drawing_engine_dispose();
+    }
+
+    static void TearDownTestCase()
+    {
+        for (auto& sessions : _sessions)
+        {
+            sessions.clear();
+        }
+        _context.reset();
+    }
+
+    /**
+     * Records the paint sessions of a view of the whole map, the same way benchspritesort does. The sessions are
+     * recorded before they are arranged.
+     */
+    static std::vector<RecordedPaintSession> RecordSessions(uint8_t rotation)
+    {
+        const int32_t width = gMapSize.x * COORDS_XY_STEP * 2 + 8;
+        const int32_t height = gMapSize.y * COORDS_XY_STEP + 128;
+
+        rct_viewport viewport{};
+        viewport.width = width;
+        viewport.height = height;
+        viewport.view_width = width;
+        viewport.view_height = height;
+        viewport.zoom = ZoomLevel{ 0 };
+
+        auto centre = TileCoordsXY(gMapSize.x / 2, gMapSize.y / 2).ToCoordsXY().ToTileCentre();
+        auto screenPos = translate_3d_to_2d_with_z(rotation, CoordsXYZ(centre, tile_element_height(centre)));
+        viewport.viewPos = { screenPos.x - (width / 2), screenPos.y - (height / 2) };
+
+        gCurrentRotation = rotation;
+        // Ensure sprites appear regardless of rotation
+        reset_all_sprite_quadrant_placements();
+
+        std::vector<uint8_t> bits(static_cast<size_t>(width) * height);
+        rct_drawpixelinfo dpi{};
+        dpi.width = width;
+        dpi.height = height;
+        dpi.bits = bits.data();
+
+        std::vector<RecordedPaintSession> sessions;
+        viewport_render(&dpi, &viewport, { { 0, 0 }, { width, height } }, &sessions);
+        return sessions;
+    }
+
+    /**
+     * Turns the offsets of a recorded session back into pointers to its own entries.
+     */
+    static void FixupPointers(RecordedPaintSession& recorded)
+    {
+        auto toPointer = [&recorded](paint_struct* offset) -> paint_struct* {
+            if (offset == reinterpret_cast<paint_struct*>(-1))
+                return nullptr;
+            return recorded.Entries[reinterpret_cast<size_t>(offset) / sizeof(paint_entry)].GetBasic();
+        };
+        for (auto& entry : recorded.Entries)
+        {
+            entry.GetBasic()->next_quadrant_ps = toPointer(entry.GetBasic()->next_quadrant_ps);
+        }
+        for (auto& quadrant : recorded.Session.Quadrants)
+        {
+            quadrant = toPointer(quadrant);
+        }
+    }
+
+    struct ArrangedNode
+    {
+        size_t Index;
+        uint8_t SortFlags;
+
+        bool operator==(const ArrangedNode& other) const
+        {
+            return Index == other.Index && SortFlags == other.SortFlags;
+        }
+    };
+
+    /**
+     * The entries of an arranged session in draw order.
+     */
+    static std::vector<ArrangedNode> GetDrawOrder(RecordedPaintSession& recorded)
+    {
+        std::vector<ArrangedNode> order;
+        for (auto* ps = recorded.Session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+        {
+            const auto index = static_cast<size_t>(reinterpret_cast<paint_entry*>(ps) - recorded.Entries.data());
+            order.push_back({ index, ps->SortFlags });
+        }
+        return order;
+    }
+
+    static std::shared_ptr<IContext> _context;
+    static std::array<std::vector<RecordedPaintSession>, NumRotations> _sessions;
+};
+
+std::shared_ptr<IContext> PaintArrangeTests::_context;
+std::array<std::vector<RecordedPaintSession>, PaintArrangeTests::NumRotations> PaintArrangeTests::_sessions;
+
+TEST_F(PaintArrangeTests, MatchesReferenceOnRecordedSessions)
+{
+    for (uint8_t rotation = 0; rotation < NumRotations; rotation++)
+    {
+        const auto& sessions = _sessions[rotation];
+        ASSERT_FALSE(sessions.empty());
+
+        size_t numEntries = 0;
+        for (size_t i = 0; i < sessions.size(); i++)
+        {
+            // Both copies are fixed up separately, the lists point into their own entries
+            auto expected = sessions[i];
+            auto actual = sessions[i];
+            FixupPointers(expected);
+            FixupPointers(actual);
+            ASSERT_EQ(expected.Session.CurrentRotation, rotation);
+
+            ReferenceArrange::Arrange(expected.Session);
+            PaintSessionArrange(actual.Session);
+
+            const auto expectedOrder = GetDrawOrder(expected);
+            EXPECT_EQ(expectedOrder, GetDrawOrder(actual)) << "rotation " << int32_t{ rotation } << ", column " << i;
+            numEntries += expectedOrder.size();
+        }
+
+        // Otherwise the sessions were not painted at all and the comparison tells nothing
+        EXPECT_GT(numEntries, sessions.size());
+    }
+}
+
+/**
+ * Bounding boxes of a column of a dense scene: two diagonals of tiles, each with a surface and a path, and either a
+ * crowd of guests or a station with a loaded train and a queue next to it. Listed in the order the tiles are painted.
+ */
+static std::vector<paint_struct> GenerateDenseColumn(std::mt19937& rng, bool station)
+{
+    std::vector<paint_struct> structs;
+    auto add = [&structs](int32_t x, int32_t y, int32_t z, int32_t sizeX, int32_t sizeY, int32_t sizeZ) {
+        paint_struct ps{};
+        ps.bounds = { x, y, z, x + sizeX, y + sizeY, z + sizeZ };
+        structs.push_back(ps);
+    };
+
+    std::uniform_int_distribution<int32_t> guestCount(station ? 4 : 10, station ? 16 : 40);
+    std::uniform_int_distribution<int32_t> offset(2, 29);
+    for (int32_t tile = 0; tile < 64; tile++)
+    {
+        for (int32_t lane = 0; lane < 2; lane++)
+        {
+            const int32_t x = (tile + lane) * COORDS_XY_STEP;
+            const int32_t y = tile * COORDS_XY_STEP;
+            const int32_t z = 112;
+            add(x, y, z, 32, 32, -1);
+            add(x, y, z + 2, 32, 32, 0);
+            if (station && lane == 0)
+            {
+                add(x, y, z, 32, 32, 1);
+                add(x, y + 2, z + 6, 32, 2, 30);
+                add(x, y, z + 40, 32, 32, 3);
+                for (int32_t car = 0; car < 2; car++)
+                {
+                    for (int32_t layer = 0; layer < 3; layer++)
+                    {
+                        add(x + car * 16, y + 8, z + 6 + layer, 14, 16, 12);
+                    }
+                }
+                continue;
+            }
+
+            const auto numGuests = guestCount(rng);
+            for (int32_t guest = 0; guest < numGuests; guest++)
+            {
+                add(x + offset(rng), y + offset(rng), z + 2, 1, 1, 11);
+            }
+        }
+    }
+    return structs;
+}
+
+/**
+ * Prepends the paint structs to their quadrant lists the same way PaintSessionAddPSToQuadrant does.
+ */
+static void AddToQuadrants(PaintSessionCore& session, std::vector<paint_struct>& structs, uint8_t rotation)
+{
+    session.CurrentRotation = rotation;
+    session.QuadrantBackIndex = UINT32_MAX;
+    session.QuadrantFrontIndex = 0;
+    for (auto& ps : structs)
+    {
+        const auto x = ps.bounds.x;
+        const auto y = ps.bounds.y;
+        int32_t positionHash = 0;
+        switch (rotation)
+        {
+            case 0:
+                positionHash = x + y;
+                break;
+            case 1:
+                positionHash = (y - x) + MaxPaintQuadrants * COORDS_XY_STEP / 2;
+                break;
+            case 2:
+                positionHash = -(y + x) + MaxPaintQuadrants * COORDS_XY_STEP;
+                break;
+            case 3:
+                positionHash = (x - y) + MaxPaintQuadrants * COORDS_XY_STEP / 2;
+                break;
+        }
+        const uint32_t quadrantIndex = std::clamp(positionHash / COORDS_XY_STEP, 0, MaxPaintQuadrants - 1);
+
+        ps.quadrant_index = quadrantIndex;
+        ps.next_quadrant_ps = session.Quadrants[quadrantIndex];
+        session.Quadrants[quadrantIndex] = &ps;
+        session.QuadrantBackIndex = std::min(session.QuadrantBackIndex, quadrantIndex);
+        session.QuadrantFrontIndex = std::max(session.QuadrantFrontIndex, quadrantIndex);
+    }
+}
+
+static std::vector<std::pair<size_t, uint8_t>> GetDrawOrder(PaintSessionCore& session, std::vector<paint_struct>& structs)
+{
+    std::vector<std::pair<size_t, uint8_t>> order;
+    for (auto* ps = session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        order.emplace_back(static_cast<size_t>(ps - structs.data()), ps->SortFlags);
+    }
+    return order;
+}
+
+// Unlike the recorded sessions, these do not need a park, so the comparison also runs without the game data
+TEST(PaintArrangeGeneratedTests, MatchesReferenceOnDenseColumns)
+{
+    std::mt19937 rng(0x5EED);
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        for (int32_t i = 0; i < 8; i++)
+        {
+            const auto structs = GenerateDenseColumn(rng, i % 2 != 0);
+            auto expected = structs;
+            auto actual = structs;
+            auto expectedSession = std::make_unique<PaintSessionCore>();
+            auto actualSession = std::make_unique<PaintSessionCore>();
+            AddToQuadrants(*expectedSession, expected, rotation);
+            AddToQuadrants(*actualSession, actual, rotation);
+
+            ReferenceArrange::Arrange(*expectedSession);
+            PaintSessionArrange(*actualSession);
+
+            const auto expectedOrder = GetDrawOrder(*expectedSession, expected);
+            ASSERT_EQ(expectedOrder.size(), structs.size());
+            EXPECT_EQ(expectedOrder, GetDrawOrder(*actualSession, actual))
+                << "rotation " << int32_t{ rotation } << ", column " << i;
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
+
+class RLEDrawingTest : public testing::Test
+{
+protected:
+    static constexpr int32_t NumRuns = 20000;
+    // Longest run an RLE sprite can hold
+    static constexpr int32_t MaxRunLength = 127;
+
+    std::mt19937 _random{ 0x5eed };
+
+    /**
+     * Random pixels, about one in five of them 0.
+     */
+    std::vector<uint8_t> GetPixels(size_t count, uint8_t maxValue)
+    {
+        std::uniform_int_distribution<int32_t> pixel(1, maxValue);
+        std::uniform_int_distribution<int32_t> chance(0, 4);
+        std::vector<uint8_t> pixels(count);
+        for (auto& value : pixels)
+        {
+            value = chance(_random) == 0 ? 0 : static_cast<uint8_t>(pixel(_random));
+        }
+        return pixels;
+    }
+
+    int32_t GetRunLength()
+    {
+        return std::uniform_int_distribution<int32_t>(1, MaxRunLength)(_random);
+    }
+};
+
+TEST_F(RLEDrawingTest, RemapAVX2MatchesScalar)
+{
+    // Nothing to compare against on this machine
+    if (!avx2_available())
+        return;
+
+    for (int32_t run = 0; run < NumRuns; run++)
+    {
+        const auto count = GetRunLength();
+        const auto paletteMap = GetPixels(256, 255);
+        const auto src = GetPixels(count, 255);
+        const auto dst = GetPixels(count, 255);
+        // Every other run remaps the destination pixels instead of the source pixels
+        const bool remapDst = (run % 2) != 0;
+
+        auto expected = dst;
+        auto actual = dst;
+        rle_remap_scalar(src.data(), remapDst ? expected.data() : src.data(), expected.data(), paletteMap.data(), count);
+        rle_remap_avx2(src.data(), remapDst ? actual.data() : src.data(), actual.data(), paletteMap.data(), count);
+        ASSERT_EQ(expected, actual) << "run " << run << " of " << count << " pixels";
+    }
+}
+
+TEST_F(RLEDrawingTest, BlendAVX2MatchesScalar)
+{
+    // Nothing to compare against on this machine
+    if (!avx2_available())
+        return;
+
+    for (int32_t run = 0; run < NumRuns; run++)
+    {
+        const auto count = GetRunLength();
+        const auto numMaps = std::uniform_int_distribution<int32_t>(1, 32)(_random);
+        const auto blendMaps = GetPixels(numMaps * 256, 255);
+        // Includes source pixels without a blend map
+        const auto src = GetPixels(count, static_cast<uint8_t>(numMaps + 8));
+        const auto dst = GetPixels(count, 255);
+
+        auto expected = dst;
+        auto actual = dst;
+        rle_blend_scalar(src.data(), expected.data(), blendMaps.data(), numMaps, count);
+        rle_blend_avx2(src.data(), actual.data(), blendMaps.data(), numMaps, count);
+        ASSERT_EQ(expected, actual) << "run " << run << " of " << count << " pixels with " << numMaps << " maps";
+    }
+}
+
+TEST_F(RLEDrawingTest, BlendScalarMatchesPaletteMap)
+{
+    for (int32_t run = 0; run < NumRuns; run++)
+    {
+        const auto count = GetRunLength();
+        const auto numMaps = std::uniform_int_distribution<int32_t>(1, 32)(_random);
+        auto blendMaps = GetPixels(numMaps * 256, 255);
+        // Source pixels without a blend map are not part of the PaletteMap::Blend contract
+        const auto src = GetPixels(count, static_cast<uint8_t>(numMaps));
+        const auto dst = GetPixels(count, 255);
+
+        const PaletteMap paletteMap(blendMaps.data(), static_cast<uint16_t>(numMaps), 256);
+        auto expected = dst;
+        for (int32_t i = 0; i < count; i++)
+        {
+            BlitPixel<BLEND_TRANSPARENT | BLEND_SRC | BLEND_DST>(&src[i], &expected[i], paletteMap);
+        }
+        auto actual = dst;
+        rle_blend_scalar(src.data(), actual.data(), paletteMap.GetBlendTable(), paletteMap.GetNumMaps(), count);
+        ASSERT_EQ(expected, actual) << "run " << run << " of " << count << " pixels with " << numMaps << " maps";
+    }
+}
@@ -12,6 +12,7 @@
 #include <gtest/gtest.h>
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
+#include <openrct2/GameState.h>
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/audio/AudioContext.h>
 #include <openrct2/core/File.h>
@@ -19,12 +20,15 @@
 #include <openrct2/core/String.hpp>
 #include <openrct2/platform/Platform.h>
 #include <openrct2/ride/Ride.h>
+#include <openrct2/actions/RideSetStatusAction.h>
 #include <openrct2/ride/RideData.h>
+#include <openrct2/ride/Vehicle.h>
 #include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 
-class RideRatings : public testing::Test
+class RideRatingsTests : public testing::Test
 {
 protected:
     void CalculateRatingsForAllRides()
@@ -35,6 +39,14 @@ protected:
         }
     }
 
+    void ComputeRatingsForAllRides()
+    {
+        for (auto& ride : GetRideManager())
+        {
+            RideRatings::ComputeNow(ride);
+        }
+    }
+
     void DumpRatings()
     {
         for (const auto& ride : GetRideManager())
@@ -44,6 +56,40 @@ protected:
         }
     }
 
+    std::vector<RideId> GetRollerCoasters(size_t maxCount)
+    {
+        std::vector<RideId> result;
+        for (const auto& ride : GetRideManager())
+        {
+            if (result.size() < maxCount && ride.GetRideTypeDescriptor().Category == RIDE_CATEGORY_ROLLERCOASTER)
+            {
+                result.push_back(ride.id);
+            }
+        }
+        return result;
+    }
+
+    void StartTestRun(Ride& ride)
+    {
+        // Closing an already closed ride removes its trains, so each test starts from the station
+        auto closeAction = RideSetStatusAction(ride.id, RideStatus::Closed);
+        GameActions::ExecuteNested(&closeAction);
+        GameActions::ExecuteNested(&closeAction);
+        ride.lifecycle_flags &= ~RIDE_LIFECYCLE_TESTED;
+
+        auto testAction = RideSetStatusAction(ride.id, RideStatus::Testing);
+        GameActions::ExecuteNested(&testAction);
+    }
+
+    std::string FormatTestResults(const Ride& ride)
+    {
+        return String::StdFormat(
+            "%s: speed (%d, %d) g (%d, %d, %d) air %d drops %d/%d inversions %d length %d time %d",
+            ride.GetRideTypeDescriptor().EnumName, ride.max_speed, ride.average_speed, ride.max_positive_vertical_g,
+            ride.max_negative_vertical_g, ride.max_lateral_g, ride.total_air_time, ride.drops, ride.highest_drop_height,
+            ride.inversions, ride.GetTotalLength(), ride.GetTotalTime());
+    }
+
     std::string FormatRatings(const Ride& ride)
     {
         RatingTuple ratings = ride.ratings;
@@ -54,7 +100,7 @@ protected:
     }
 };
 
-TEST_F(RideRatings, all)
+TEST_F(RideRatingsTests, all)
 {
     std::string path = TestData::GetParkPath("bpb.sv6");
 
@@ -88,3 +134,126 @@ TEST_F(RideRatings, all)
         expI++;
     }
 }
+
+TEST_F(RideRatingsTests, compute_now)
+{
+    std::string path = TestData::GetParkPath("bpb.sv6");
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    Platform::CoreInit();
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    load_from_sv6(path.c_str());
+
+    ASSERT_EQ(ride_get_count(), 134);
+
+    auto statesBefore = gRideRatingUpdateStates;
+    ComputeRatingsForAllRides();
+
+    // The global update states must not be advanced by synchronous rating
+    for (size_t i = 0; i < RideRatingMaxUpdateStates; i++)
+    {
+        ASSERT_EQ(statesBefore[i].CurrentRide, gRideRatingUpdateStates[i].CurrentRide);
+        ASSERT_EQ(statesBefore[i].State, gRideRatingUpdateStates[i].State);
+    }
+
+    // Ratings must match those of the tick based state machine
+    auto expectedDataPath = Path::Combine(TestData::GetBasePath(), u8"ratings", u8"bpb.sv6.txt");
+    auto expectedRatings = File::ReadAllLines(expectedDataPath);
+
+    int expI = 0;
+    for (const auto& ride : GetRideManager())
+    {
+        auto actual = FormatRatings(ride);
+        auto expected = expectedRatings[expI];
+        ASSERT_STREQ(actual.c_str(), expected.c_str());
+
+        expI++;
+    }
+}
+
+TEST_F(RideRatingsTests, lowered_update_budget)
+{
+    static constexpr uint8_t Budget = 4;
+    static constexpr uint32_t MaxSteps = 1000000;
+    std::string path = TestData::GetParkPath("bpb.sv6");
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    Platform::CoreInit();
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    load_from_sv6(path.c_str());
+    ride_ratings_reset_update_states();
+    gRideRatingUpdateBudget = Budget;
+
+    // Step until the last update state is part way through rating a ride
+    auto& lastState = gRideRatingUpdateStates[Budget - 1];
+    for (uint32_t i = 0; i < MaxSteps && lastState.State != RIDE_RATINGS_STATE_2; i++)
+    {
+        ride_ratings_update_all();
+    }
+    ASSERT_EQ(lastState.State, RIDE_RATINGS_STATE_2);
+    auto ride = get_ride(lastState.CurrentRide);
+    ASSERT_NE(ride, nullptr);
+    ride->ratings.Excitement = RIDE_RATING_UNDEFINED;
+
+    // The remaining update state must still rate the ride that was dropped
+    gRideRatingUpdateBudget = 1;
+    for (uint32_t i = 0; i < MaxSteps && ride->ratings.Excitement == RIDE_RATING_UNDEFINED; i++)
+    {
+        ride_ratings_update_all();
+    }
+    ASSERT_NE(ride->ratings.Excitement, RIDE_RATING_UNDEFINED);
+    ASSERT_EQ(lastState.State, RIDE_RATINGS_STATE_FIND_NEXT_RIDE);
+}
+
+TEST_F(RideRatingsTests, fast_test_run)
+{
+    static constexpr uint32_t MaxTestTicks = 40 * 60 * 10;
+    std::string path = TestData::GetParkPath("bpb.sv6");
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    Platform::CoreInit();
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    // Test the rides with full game ticks first
+    load_from_sv6(path.c_str());
+    auto rideIds = GetRollerCoasters(3);
+    ASSERT_FALSE(rideIds.empty());
+
+    std::vector<std::string> expectedResults;
+    for (auto rideId : rideIds)
+    {
+        auto ride = get_ride(rideId);
+        StartTestRun(*ride);
+        for (uint32_t i = 0; i < MaxTestTicks && !(ride->lifecycle_flags & RIDE_LIFECYCLE_TESTED); i++)
+        {
+            context->GetGameState()->UpdateLogic();
+        }
+        ASSERT_TRUE(ride->lifecycle_flags & RIDE_LIFECYCLE_TESTED);
+        expectedResults.push_back(FormatTestResults(*ride));
+    }
+
+    // The same rides tested in isolation must give the same results
+    load_from_sv6(path.c_str());
+    for (size_t i = 0; i < rideIds.size(); i++)
+    {
+        auto ride = get_ride(rideIds[i]);
+        StartTestRun(*ride);
+        vehicle_update_test_run(*ride, MaxTestTicks);
+        ASSERT_TRUE(ride->lifecycle_flags & RIDE_LIFECYCLE_TESTED);
+        ASSERT_STREQ(FormatTestResults(*ride).c_str(), expectedResults[i].c_str());
+    }
+}
@@ -0,0 +1,147 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/Intro.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/core/Imaging.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/drawing/X8DrawingEngine.h>
+#include <openrct2/interface/Screenshot.h>
+#include <openrct2/interface/Viewport.h>
+#include <openrct2/world/Map.h>
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+using namespace OpenRCT2;
+using namespace OpenRCT2::Drawing;
+
+class ScreenshotTests : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        gOpenRCT2Headless = true;
+        _context = CreateContext();
+        ASSERT_TRUE(_context->Initialise());
+        ASSERT_TRUE(_context->LoadParkFromFile(TestData::GetParkPath("small_park_with_ferris_wheel.sv6")));
+
+        gIntroState = IntroState::None;
+        gScreenFlags = SCREEN_FLAGS_PLAYING;
+        gCurrentRotation = 0;
+    }
+
+    static void TearDownTestCase()
+    {
+        _context.reset();
+    }
+
+    /**
+     * A view of the middle of the map, with a height that is not a multiple of the strip heights used below.
+     */
+    static rct_viewport CreateViewport()
+    {
+        rct_viewport viewport{};
+        viewport.width = 320;
+        viewport.height = 200;
+        viewport.view_width = viewport.width;
+        viewport.view_height = viewport.height;
+        viewport.zoom = ZoomLevel{ 0 };
+
+        auto centre = TileCoordsXY(gMapSize.x / 2, gMapSize.y / 2).ToCoordsXY().ToTileCentre();
+        auto screenPos = translate_3d_to_2d_with_z(gCurrentRotation, CoordsXYZ(centre, tile_element_height(centre)));
+        viewport.viewPos = { screenPos.x - (viewport.width / 2), screenPos.y - (viewport.height / 2) };
+        return viewport;
+    }
+
+    /**
+     * Renders the viewport into a single drawpixelinfo and writes it with WriteDpiToFile, through screenshot_dump_png.
+     */
+    static Image RenderWhole(const rct_viewport& viewport)
+    {
+        std::vector<uint8_t> bits(static_cast<size_t>(viewport.width) * viewport.height, PALETTE_INDEX_0);
+        X8DrawingEngine drawingEngine(_context->GetUiContext());
+        rct_drawpixelinfo dpi{};
+        dpi.bits = bits.data();
+        dpi.width = viewport.width;
+        dpi.height = viewport.height;
+        dpi.DrawingEngine = &drawingEngine;
+
+        reset_all_sprite_quadrant_placements();
+        viewport_render(&dpi, &viewport, { { 0, 0 }, { dpi.width, dpi.height } });
+
+        const auto path = screenshot_dump_png(&dpi);
+        EXPECT_FALSE(path.empty());
+        auto image = Imaging::ReadFromFile(path, IMAGE_FORMAT::PNG);
+        std::remove(path.c_str());
+        return image;
+    }
+
+    static Image RenderStrips(const rct_viewport& viewport, int32_t stripHeight)
+    {
+        std::stringstream stream;
+        RenderViewportToPng(viewport, stream, gPalette, stripHeight);
+        const auto data = stream.str();
+        return Imaging::ReadFromBuffer(std::vector<uint8_t>(data.begin(), data.end()), IMAGE_FORMAT::PNG);
+    }
+
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> ScreenshotTests::_context;
+
+TEST_F(ScreenshotTests, StripsMatchSingleImage)
+{
+    const auto viewport = CreateViewport();
+    const auto expected = RenderWhole(viewport);
+    ASSERT_EQ(expected.Width, static_cast<uint32_t>(viewport.width));
+    ASSERT_EQ(expected.Height, static_cast<uint32_t>(viewport.height));
+
+    // A single strip, strips that divide the height and strips with a shorter last one
+    for (int32_t stripHeight : { 200, 40, 64, 96 })
+    {
+        const auto actual = RenderStrips(viewport, stripHeight);
+        ASSERT_EQ(actual.Width, expected.Width);
+        ASSERT_EQ(actual.Height, expected.Height);
+        EXPECT_EQ(actual.Pixels, expected.Pixels) << "strip height " << stripHeight;
+    }
+}
+
+TEST_F(ScreenshotTests, WriteErrorIsRethrown)
+{
+    // Rejects everything written to it, the same as a full disk
+    class FailingBuffer : public std::streambuf
+    {
+    protected:
+        std::streamsize xsputn(const char*, std::streamsize) override
+        {
+            return 0;
+        }
+        int_type overflow(int_type) override
+        {
+            return traits_type::eof();
+        }
+    };
+
+    const auto viewport = CreateViewport();
+    const auto forceMultithreading = gViewportForceMultithreading;
+    FailingBuffer buffer;
+    std::ostream stream(&buffer);
+    EXPECT_THROW(RenderViewportToPng(viewport, stream, gPalette, 64), std::runtime_error);
+    EXPECT_EQ(gViewportForceMultithreading, forceMultithreading);
+}
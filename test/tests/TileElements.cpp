@@ -12,10 +12,14 @@
 #include <gtest/gtest.h>
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
+#include <openrct2/GameState.h>
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ParkImporter.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
+#include <openrct2/world/Surface.h>
+
+#include <cstring>
 
 using namespace OpenRCT2;
 
@@ -171,3 +175,124 @@ TEST_F(TileElementWantsFootpathConnection, MapEdge)
     // The tile in the -X direction is a normal tile and should not be marked as an edge
     EXPECT_FALSE(edges & (1 << 2));
 }
+
+class DirtyTileJournal : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        std::string parkPath = TestData::GetParkPath("tile-element-tests.sv6");
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+        SUCCEED();
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+    void TearDown() override
+    {
+        MapStopDirtyTileJournal();
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> DirtyTileJournal::_context;
+
+TEST_F(DirtyTileJournal, InsertAndRemoveMarkTile)
+{
+    MapStartDirtyTileJournal();
+    EXPECT_TRUE(MapGetDirtyTiles().empty());
+
+    const auto tilePos = TileCoordsXY{ 10, 10 };
+    auto* element = tile_element_insert(TileCoordsXYZ{ tilePos, 40 }.ToCoordsXYZ(), 0b1111, TileElementType::SmallScenery);
+    ASSERT_NE(element, nullptr);
+    ASSERT_EQ(MapGetDirtyTiles().size(), 1u);
+    EXPECT_EQ(MapGetDirtyTiles()[0], tilePos);
+
+    MapClearDirtyTiles();
+    EXPECT_TRUE(MapGetDirtyTiles().empty());
+
+    // Only the element is known when removing
+    tile_element_remove(element);
+    ASSERT_EQ(MapGetDirtyTiles().size(), 1u);
+    EXPECT_EQ(MapGetDirtyTiles()[0], tilePos);
+
+    // Reorganising moves elements around but does not change any tile
+    MapClearDirtyTiles();
+    ReorganiseTileElements();
+    EXPECT_TRUE(MapGetDirtyTiles().empty());
+    EXPECT_FALSE(MapAreAllTilesDirty());
+}
+
+TEST_F(DirtyTileJournal, RestoreCheckpointRewritesDirtyTiles)
+{
+    MapStartDirtyTileJournal();
+    const auto before = GetReorganisedTileElementsWithoutGhosts();
+    const auto checkpoint = CreateMapCheckpoint();
+
+    for (int32_t i = 0; i < 3; i++)
+    {
+        ASSERT_NE(tile_element_insert({ 12 * 32, 10 * 32, 40 + i * 16 }, 0b1111, TileElementType::SmallScenery), nullptr);
+    }
+    ASSERT_NE(tile_element_insert({ 13 * 32, 10 * 32, 40 }, 0b1111, TileElementType::SmallScenery), nullptr);
+    EXPECT_EQ(MapGetDirtyTiles().size(), 2u);
+
+    RestoreMapCheckpoint(checkpoint);
+    EXPECT_TRUE(MapGetDirtyTiles().empty());
+
+    const auto after = GetReorganisedTileElementsWithoutGhosts();
+    ASSERT_EQ(after.size(), before.size());
+    EXPECT_EQ(std::memcmp(after.data(), before.data(), before.size() * sizeof(TileElement)), 0);
+
+    // The checkpoint can be restored again after more changes
+    ASSERT_NE(tile_element_insert({ 12 * 32, 10 * 32, 40 }, 0b1111, TileElementType::SmallScenery), nullptr);
+    RestoreMapCheckpoint(checkpoint);
+    const auto again = GetReorganisedTileElementsWithoutGhosts();
+    ASSERT_EQ(again.size(), before.size());
+    EXPECT_EQ(std::memcmp(again.data(), before.data(), before.size() * sizeof(TileElement)), 0);
+}
+
+TEST_F(DirtyTileJournal, HiddenGrassChangeMarksTile)
+{
+    const auto tilePos = TileCoordsXY{ 10, 10 };
+    auto* surfaceElement = map_get_surface_element_at(tilePos.ToCoordsXY());
+    ASSERT_NE(surfaceElement, nullptr);
+    surfaceElement->SetGrassLength(GRASS_LENGTH_CLUMPS_0);
+
+    // Both lengths look the same, so the tile is not invalidated
+    MapStartDirtyTileJournal();
+    surfaceElement->SetGrassLengthAndInvalidate(GRASS_LENGTH_CLUMPS_1, tilePos.ToCoordsXY());
+    ASSERT_EQ(MapGetDirtyTiles().size(), 1u);
+    EXPECT_EQ(MapGetDirtyTiles()[0], tilePos);
+}
+
+TEST_F(DirtyTileJournal, RestoreCheckpointAfterAdvancingTicks)
+{
+    MapStartDirtyTileJournal();
+    const auto before = GetReorganisedTileElementsWithoutGhosts();
+    const auto checkpoint = CreateMapCheckpoint();
+
+    // Grass grows and path wide flags are updated in place while the game runs
+    auto* gameState = GetContext()->GetGameState();
+    for (int32_t i = 0; i < 2000; i++)
+    {
+        gameState->UpdateLogic();
+    }
+
+    RestoreMapCheckpoint(checkpoint);
+    const auto after = GetReorganisedTileElementsWithoutGhosts();
+    ASSERT_EQ(after.size(), before.size());
+    EXPECT_EQ(std::memcmp(after.data(), before.data(), before.size() * sizeof(TileElement)), 0);
+}
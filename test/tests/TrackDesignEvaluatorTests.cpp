@@ -0,0 +1,588 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Cheats.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/actions/RideSetStatusAction.h>
+#include <openrct2/actions/TrackDesignAction.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/localisation/Date.h>
+#include <openrct2/management/Finance.h>
+#include <openrct2/platform/Platform.h>
+#include <openrct2/rct2/T6Exporter.h>
+#include <openrct2/rct2/T9Exporter.h>
+#include <openrct2/ride/Ride.h>
+#include <openrct2/ride/RideData.h>
+#include <openrct2/ride/TrackDesign.h>
+#include <openrct2/ride/TrackDesignEvaluationProtocol.h>
+#include <openrct2/ride/TrackDesignEvaluator.h>
+#include <openrct2/ride/TrackDesignFootprint.h>
+#include <openrct2/ride/TrainManager.h>
+#include <openrct2/ride/Vehicle.h>
+#include <openrct2/scenario/Scenario.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Park.h>
+#include <openrct2/world/Surface.h>
+#include <optional>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class TrackDesignEvaluatorTests : public testing::Test
+{
+protected:
+    static constexpr size_t MaxDesigns = 3;
+
+    std::unique_ptr<IContext> _context;
+    std::vector<std::unique_ptr<TrackDesign>> _designs;
+
+    void SetUp() override
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        gOpenRCT2ControlSocket = false;
+
+        Platform::CoreInit();
+        _context = CreateContext();
+        ASSERT_TRUE(_context->Initialise());
+
+        // The designs are taken from the roller coasters of the park, its objects stay loaded for them
+        load_from_sv6(TestData::GetParkPath("bpb.sv6").c_str());
+        for (const auto& ride : GetRideManager())
+        {
+            if (_designs.size() >= MaxDesigns)
+                break;
+            if (ride.GetRideTypeDescriptor().Category != RIDE_CATEGORY_ROLLERCOASTER)
+                continue;
+
+            TrackDesignState tds{};
+            auto td = std::make_unique<TrackDesign>();
+            if (td->CreateTrackDesign(tds, ride) == STR_NONE)
+            {
+                _designs.push_back(std::move(td));
+            }
+        }
+        ASSERT_EQ(_designs.size(), MaxDesigns);
+
+        // Evaluate them on an empty flat map, so nothing but the design itself affects the results
+        ResetMap();
+        gCheatsSandboxMode = true;
+        gParkFlags |= PARK_FLAGS_NO_MONEY;
+    }
+
+    static void ResetMap()
+    {
+        ResetAllEntities();
+        ride_init_all();
+        map_init({ 256, 256 });
+    }
+
+    GameState& GetGameState()
+    {
+        return *_context->GetGameState();
+    }
+
+    static size_t CountTrackElements()
+    {
+        size_t count = 0;
+        tile_element_iterator it;
+        tile_element_iterator_begin(&it);
+        do
+        {
+            if (it.element->GetType() == TileElementType::Track)
+                count++;
+        } while (tile_element_iterator_next(&it));
+        return count;
+    }
+
+    struct TestRunSample
+    {
+        random_engine_t::state_type RandomStateBefore{};
+        random_engine_t::state_type RandomStateAfter{};
+        TrackDesignEvaluation Stats;
+        std::vector<CoordsXYZ> VehicleLocations;
+        std::vector<int32_t> VehicleVelocities;
+    };
+
+    /**
+     * Builds the design on an empty map with the same date, random seed and tick count every time, and runs the given
+     * number of ticks of its test run in the given simulation mode.
+     */
+    TestRunSample RunTestRun(const TrackDesign& td, SimulationMode mode, uint32_t ticks)
+    {
+        ResetMap();
+        date_reset();
+        gCurrentTicks = 0;
+        scenario_rand_seed(0x1234567F, 0x7654321F);
+
+        auto& gameState = GetGameState();
+        gameState.SetSimulationMode(mode);
+
+        TestRunSample sample;
+        auto loc = TrackDesignEvaluator::FindPlacement(td, TrackDesignEvaluator::GetDefaultOrigins());
+        EXPECT_TRUE(loc.has_value());
+        if (loc.has_value())
+        {
+            auto rideId = TrackDesignEvaluator::Place(td, *loc);
+            auto statusAction = RideSetStatusAction(rideId, RideStatus::Testing);
+            EXPECT_EQ(GameActions::Execute(&statusAction).Error, GameActions::Status::Ok);
+
+            sample.RandomStateBefore = scenario_rand_state();
+            for (uint32_t i = 0; i < ticks; i++)
+            {
+                gameState.UpdateLogic();
+            }
+            sample.RandomStateAfter = scenario_rand_state();
+
+            auto ride = get_ride(rideId);
+            EXPECT_NE(ride, nullptr);
+            if (ride != nullptr)
+            {
+                TrackDesignEvaluator::CollectStats(*ride, sample.Stats);
+            }
+            for (auto vehicle : TrainManager::View())
+            {
+                for (auto car = vehicle; car != nullptr; car = GetEntity<Vehicle>(car->next_vehicle_on_train))
+                {
+                    sample.VehicleLocations.push_back(car->GetLocation());
+                    sample.VehicleVelocities.push_back(car->velocity);
+                }
+            }
+        }
+
+        gameState.SetSimulationMode(SimulationMode::Normal);
+        return sample;
+    }
+
+    /**
+     * Exports the design to TD6 and wraps it in an evaluation request.
+     */
+    static std::vector<uint8_t> CreateRequest(TrackDesign& td)
+    {
+        OpenRCT2::MemoryStream ms;
+        RCT2::T6Exporter exporter(&td);
+        EXPECT_TRUE(exporter.SaveTrack(&ms));
+
+        TrackDesignEvaluationProtocol::RequestHeader header{};
+        header.Magic = TrackDesignEvaluationProtocol::Magic;
+        header.Version = TrackDesignEvaluationProtocol::Version;
+        header.Format = TrackDesignEvaluationProtocol::DesignFormat::TD6;
+        header.DesignSize = static_cast<uint32_t>(ms.GetLength());
+
+        std::vector<uint8_t> request(sizeof(header) + ms.GetLength());
+        std::memcpy(request.data(), &header, sizeof(header));
+        std::memcpy(request.data() + sizeof(header), ms.GetData(), ms.GetLength());
+        return request;
+    }
+
+    static void ExpectSameResults(const TrackDesignEvaluation& expected, const TrackDesignEvaluation& actual)
+    {
+        ASSERT_EQ(expected.Tested, actual.Tested);
+        EXPECT_EQ(expected.Ratings.Excitement, actual.Ratings.Excitement);
+        EXPECT_EQ(expected.Ratings.Intensity, actual.Ratings.Intensity);
+        EXPECT_EQ(expected.Ratings.Nausea, actual.Ratings.Nausea);
+        EXPECT_EQ(expected.MaxSpeed, actual.MaxSpeed);
+        EXPECT_EQ(expected.AverageSpeed, actual.AverageSpeed);
+        EXPECT_EQ(expected.RideTime, actual.RideTime);
+        EXPECT_EQ(expected.RideLength, actual.RideLength);
+        EXPECT_EQ(expected.MaxPositiveVerticalG, actual.MaxPositiveVerticalG);
+        EXPECT_EQ(expected.MaxNegativeVerticalG, actual.MaxNegativeVerticalG);
+        EXPECT_EQ(expected.MaxLateralG, actual.MaxLateralG);
+        EXPECT_EQ(expected.Drops, actual.Drops);
+        EXPECT_EQ(expected.Inversions, actual.Inversions);
+    }
+};
+
+TEST_F(TrackDesignEvaluatorTests, Evaluate_TestsAndRemovesDesign)
+{
+    TrackDesignEvaluationOptions options;
+    for (const auto& td : _designs)
+    {
+        auto result = TrackDesignEvaluator::Evaluate(GetGameState(), *td, options);
+        ASSERT_TRUE(result.Placed) << result.Error;
+        ASSERT_TRUE(result.Tested) << result.Error;
+        EXPECT_NE(result.Ratings.Excitement, RIDE_RATING_UNDEFINED);
+        EXPECT_GT(result.TestTicks, 0u);
+        EXPECT_GT(result.RideLength, 0);
+
+        // Nothing of the ride is left for the next design
+        EXPECT_EQ(ride_get_count(), 0);
+        EXPECT_EQ(CountTrackElements(), 0u);
+    }
+}
+
+TEST_F(TrackDesignEvaluatorTests, Evaluate_IsRepeatable)
+{
+    TrackDesignEvaluationOptions options;
+    auto first = TrackDesignEvaluator::Evaluate(GetGameState(), *_designs[0], options);
+    auto second = TrackDesignEvaluator::Evaluate(GetGameState(), *_designs[0], options);
+    ASSERT_TRUE(first.Tested) << first.Error;
+    ExpectSameResults(first, second);
+    EXPECT_EQ(first.Location, second.Location);
+}
+
+TEST_F(TrackDesignEvaluatorTests, TestRunOnly_MatchesFullSimulation)
+{
+    // A ride only gets the same results in both modes if it does not break down in the full simulation, where it
+    // depends on what else drew random numbers. Test run only mode never rolls for breakdowns.
+    gCheatsDisableAllBreakdowns = true;
+
+    constexpr uint32_t Ticks = 4000;
+    for (const auto& td : _designs)
+    {
+        auto full = RunTestRun(*td, SimulationMode::Normal, Ticks);
+        auto testRunOnly = RunTestRun(*td, SimulationMode::TestRunOnly, Ticks);
+
+        ExpectSameResults(full.Stats, testRunOnly.Stats);
+        EXPECT_EQ(full.VehicleLocations, testRunOnly.VehicleLocations);
+        EXPECT_EQ(full.VehicleVelocities, testRunOnly.VehicleVelocities);
+        EXPECT_FALSE(full.VehicleLocations.empty());
+
+        // Nothing on the test run only path draws random numbers, so its results can not depend on them
+        EXPECT_EQ(testRunOnly.RandomStateBefore.s0, testRunOnly.RandomStateAfter.s0);
+        EXPECT_EQ(testRunOnly.RandomStateBefore.s1, testRunOnly.RandomStateAfter.s1);
+    }
+    gCheatsDisableAllBreakdowns = false;
+}
+
+TEST_F(TrackDesignEvaluatorTests, Protocol_RoundTripMatchesEvaluate)
+{
+    using namespace TrackDesignEvaluationProtocol;
+
+    TrackDesignEvaluationOptions options;
+    for (const auto& td : _designs)
+    {
+        auto request = CreateRequest(*td);
+        ASSERT_TRUE(IsRequest(request.data(), request.size()));
+
+        // The design is evaluated as it arrives, after going through the TD6 format
+        auto design = request.data() + sizeof(RequestHeader);
+        auto imported = TrackDesignImport(design, request.size() - sizeof(RequestHeader), ".td6");
+        ASSERT_NE(imported, nullptr);
+        auto expected = TrackDesignEvaluator::Evaluate(GetGameState(), *imported, options);
+        ASSERT_TRUE(expected.Tested) << expected.Error;
+
+        auto result = HandleRequest(GetGameState(), request.data(), request.size());
+        EXPECT_EQ(result.Magic, Magic);
+        EXPECT_EQ(result.Version, Version);
+        ASSERT_EQ(result.Code, ResultCode::Ok);
+        EXPECT_EQ(result.X, expected.Location.x);
+        EXPECT_EQ(result.Y, expected.Location.y);
+        EXPECT_EQ(result.Z, expected.Location.z);
+        EXPECT_EQ(result.Direction, expected.Location.direction);
+        EXPECT_EQ(result.TestTicks, expected.TestTicks);
+        EXPECT_EQ(result.Excitement, expected.Ratings.Excitement);
+        EXPECT_EQ(result.Intensity, expected.Ratings.Intensity);
+        EXPECT_EQ(result.Nausea, expected.Ratings.Nausea);
+        EXPECT_EQ(result.MaxPositiveVerticalG, expected.MaxPositiveVerticalG);
+        EXPECT_EQ(result.MaxNegativeVerticalG, expected.MaxNegativeVerticalG);
+        EXPECT_EQ(result.MaxLateralG, expected.MaxLateralG);
+        EXPECT_EQ(result.MaxSpeed, expected.MaxSpeed);
+        EXPECT_EQ(result.AverageSpeed, expected.AverageSpeed);
+        EXPECT_EQ(result.RideTime, expected.RideTime);
+        EXPECT_EQ(result.RideLength, expected.RideLength);
+        EXPECT_EQ(result.TotalAirTime, expected.TotalAirTime);
+        EXPECT_EQ(result.Drops, expected.Drops);
+        EXPECT_EQ(result.HighestDropHeight, expected.HighestDropHeight);
+        EXPECT_EQ(result.Inversions, expected.Inversions);
+    }
+}
+
+TEST_F(TrackDesignEvaluatorTests, Protocol_RejectsInvalidRequests)
+{
+    using namespace TrackDesignEvaluationProtocol;
+
+    auto request = CreateRequest(*_designs[0]);
+    auto handle = [this](const std::vector<uint8_t>& data) {
+        return HandleRequest(GetGameState(), data.data(), data.size()).Code;
+    };
+    auto withHeader = [&request](auto&& modify) {
+        auto modified = request;
+        RequestHeader header;
+        std::memcpy(&header, modified.data(), sizeof(header));
+        modify(header);
+        std::memcpy(modified.data(), &header, sizeof(header));
+        return modified;
+    };
+
+    // JSON commands are not binary requests
+    std::string json = R"({"action": "evaluate", "path": "design.td6"})";
+    EXPECT_FALSE(IsRequest(json.data(), json.size()));
+    EXPECT_EQ(handle({ request.begin(), request.begin() + sizeof(RequestHeader) - 1 }), ResultCode::InvalidRequest);
+
+    EXPECT_EQ(handle(withHeader([](RequestHeader& h) { h.Version = Version + 1; })), ResultCode::UnsupportedVersion);
+    EXPECT_EQ(
+        handle(withHeader([](RequestHeader& h) { h.Format = static_cast<DesignFormat>(0xFF); })),
+        ResultCode::InvalidRequest);
+    EXPECT_EQ(handle(withHeader([](RequestHeader& h) { h.DesignSize++; })), ResultCode::InvalidRequest);
+
+    auto garbage = withHeader([](RequestHeader& h) { h.DesignSize = 16; });
+    garbage.resize(sizeof(RequestHeader) + 16);
+    std::fill(garbage.begin() + sizeof(RequestHeader), garbage.end(), 0xAB);
+    EXPECT_EQ(handle(garbage), ResultCode::ImportFailed);
+
+    // Nothing was built for any of them
+    EXPECT_EQ(ride_get_count(), 0);
+    EXPECT_EQ(CountTrackElements(), 0u);
+}
+
+TEST_F(TrackDesignEvaluatorTests, ImportTD9_ReadsDesignFromMemoryOnly)
+{
+    std::vector<int32_t> headerValues(34, 0);
+    headerValues[0] = RIDE_TYPE_WOODEN_ROLLER_COASTER;
+    headerValues[4] = static_cast<int32_t>(RideMode::ContinuousCircuit);
+    headerValues[10] = 2;
+    headerValues[11] = 5;
+    headerValues[32] = 5;
+    headerValues[33] = 1;
+
+    std::string text;
+    for (auto value : headerValues)
+    {
+        text += std::to_string(value) + "\r\n";
+    }
+    text += "2,0\n0,0\n0,4\n1,0\n";
+    text += "ENT\n0,1,-64,32\n0,3,0x40,-32\n";
+    text += "SCEN\n1,-2,3,0,2,TWIST1  \n";
+
+    auto td = TrackDesignImport(text.data(), text.size(), ".td9");
+    ASSERT_NE(td, nullptr);
+    EXPECT_EQ(td->type, RIDE_TYPE_WOODEN_ROLLER_COASTER);
+    EXPECT_EQ(td->ride_mode, RideMode::ContinuousCircuit);
+    EXPECT_EQ(td->number_of_trains, 2);
+    EXPECT_EQ(td->number_of_cars_per_train, 5);
+    EXPECT_EQ(td->lift_hill_speed, 5);
+    EXPECT_EQ(td->num_circuits, 1);
+
+    ASSERT_EQ(td->track_elements.size(), 4u);
+    EXPECT_EQ(td->track_elements[0].type, TrackElemType::BeginStation);
+    EXPECT_EQ(td->track_elements[2].type, TrackElemType::Flat);
+    EXPECT_EQ(td->track_elements[2].flags, 4);
+    EXPECT_EQ(td->track_elements[3].type, TrackElemType::EndStation);
+
+    ASSERT_EQ(td->entrance_elements.size(), 2u);
+    EXPECT_FALSE(td->entrance_elements[0].isExit);
+    EXPECT_EQ(td->entrance_elements[0].x, -64);
+    EXPECT_EQ(td->entrance_elements[0].y, 32);
+    EXPECT_TRUE(td->entrance_elements[1].isExit);
+    EXPECT_EQ(td->entrance_elements[1].x, 64);
+    EXPECT_EQ(td->entrance_elements[1].direction, 3);
+
+    ASSERT_EQ(td->scenery_elements.size(), 1u);
+    EXPECT_EQ(td->scenery_elements[0].loc, CoordsXYZ(1 * COORDS_XY_STEP, -2 * COORDS_XY_STEP, 3 * COORDS_Z_STEP));
+    EXPECT_EQ(td->scenery_elements[0].scenery_object.Entry.GetName(), "TWIST1  ");
+
+    // An incomplete header is rejected rather than filled in from elsewhere
+    std::string truncated = "52\n0\n";
+    EXPECT_EQ(TrackDesignImport(truncated.data(), truncated.size(), ".td9"), nullptr);
+}
+
+TEST_F(TrackDesignEvaluatorTests, ExportTD9_RoundTripsThroughImport)
+{
+    for (const auto& design : _designs)
+    {
+        MemoryStream stream;
+        ASSERT_TRUE(RCT2::T9Exporter(design.get()).SaveTrack(&stream));
+        auto td = TrackDesignImport(stream.GetData(), static_cast<size_t>(stream.GetLength()), ".td9");
+        ASSERT_NE(td, nullptr);
+
+        EXPECT_EQ(td->type, design->type);
+        EXPECT_EQ(td->vehicle_type, design->vehicle_type);
+        EXPECT_EQ(td->flags, design->flags);
+        EXPECT_EQ(td->ride_mode, design->ride_mode);
+        EXPECT_EQ(td->colour_scheme, design->colour_scheme & 0x3);
+        EXPECT_EQ(td->entrance_style, design->entrance_style);
+        EXPECT_EQ(td->depart_flags, design->depart_flags);
+        EXPECT_EQ(td->number_of_trains, design->number_of_trains);
+        EXPECT_EQ(td->number_of_cars_per_train, design->number_of_cars_per_train);
+        EXPECT_EQ(td->min_waiting_time, design->min_waiting_time);
+        EXPECT_EQ(td->max_waiting_time, design->max_waiting_time);
+        EXPECT_EQ(td->operation_setting, design->operation_setting);
+        EXPECT_EQ(td->max_speed, design->max_speed);
+        EXPECT_EQ(td->average_speed, design->average_speed);
+        EXPECT_EQ(td->ride_length, design->ride_length);
+        EXPECT_EQ(td->max_positive_vertical_g, design->max_positive_vertical_g);
+        EXPECT_EQ(td->max_negative_vertical_g, design->max_negative_vertical_g);
+        EXPECT_EQ(td->max_lateral_g, design->max_lateral_g);
+        EXPECT_EQ(td->inversions, design->inversions);
+        EXPECT_EQ(td->drops, design->drops);
+        EXPECT_EQ(td->highest_drop_height, design->highest_drop_height);
+        EXPECT_EQ(td->excitement, design->excitement);
+        EXPECT_EQ(td->intensity, design->intensity);
+        EXPECT_EQ(td->nausea, design->nausea);
+        EXPECT_EQ(td->upkeep_cost, design->upkeep_cost);
+        EXPECT_EQ(td->lift_hill_speed, design->lift_hill_speed);
+        EXPECT_EQ(td->num_circuits, design->num_circuits);
+
+        ASSERT_EQ(td->track_elements.size(), design->track_elements.size());
+        for (size_t i = 0; i < td->track_elements.size(); i++)
+        {
+            EXPECT_EQ(td->track_elements[i].type, design->track_elements[i].type);
+            EXPECT_EQ(td->track_elements[i].flags, design->track_elements[i].flags);
+        }
+
+        ASSERT_EQ(td->entrance_elements.size(), design->entrance_elements.size());
+        for (size_t i = 0; i < td->entrance_elements.size(); i++)
+        {
+            EXPECT_EQ(td->entrance_elements[i].x, design->entrance_elements[i].x);
+            EXPECT_EQ(td->entrance_elements[i].y, design->entrance_elements[i].y);
+            EXPECT_EQ(td->entrance_elements[i].z, design->entrance_elements[i].z);
+            EXPECT_EQ(td->entrance_elements[i].direction, design->entrance_elements[i].direction);
+            EXPECT_EQ(td->entrance_elements[i].isExit, design->entrance_elements[i].isExit);
+        }
+
+        // The imported design builds the same ride
+        auto loc = TrackDesignEvaluator::FindPlacement(*design, TrackDesignEvaluator::GetDefaultOrigins());
+        ASSERT_TRUE(loc.has_value());
+        EXPECT_EQ(TrackDesignEvaluator::FindPlacement(*td, TrackDesignEvaluator::GetDefaultOrigins()), loc);
+    }
+}
+
+TEST_F(TrackDesignEvaluatorTests, ExportTD6_OnlyWritesToStream)
+{
+    // Only the file sink writes exportX.td9 and resets the cash
+    std::remove("exportX.td9");
+    const auto cash = gCash;
+    for (const auto& design : _designs)
+    {
+        MemoryStream stream;
+        ASSERT_TRUE(RCT2::T6Exporter(design.get()).SaveTrack(&stream));
+        EXPECT_GT(stream.GetLength(), 0u);
+    }
+    EXPECT_EQ(gCash, cash);
+    EXPECT_FALSE(File::Exists("exportX.td9"));
+}
+
+TEST_F(TrackDesignEvaluatorTests, EvaluateConcurrently_MatchesSerial)
+{
+    // Breakdowns depend on the random numbers, which the rides testing at the same time draw in a different order
+    gCheatsDisableAllBreakdowns = true;
+
+    // Every design twice, so rides of the same design test next to each other
+    constexpr size_t NumEvaluations = MaxDesigns * 2;
+    TrackDesignEvaluationOptions options;
+    std::vector<TrackDesignEvaluation> serial;
+    for (size_t i = 0; i < NumEvaluations; i++)
+    {
+        serial.push_back(TrackDesignEvaluator::Evaluate(GetGameState(), *_designs[i % MaxDesigns], options));
+        ASSERT_TRUE(serial.back().Tested) << serial.back().Error;
+    }
+
+    options.ConcurrentTests = 3;
+    std::vector<std::optional<TrackDesignEvaluation>> concurrent(NumEvaluations);
+    TrackDesignEvaluator::EvaluateConcurrently(
+        GetGameState(), NumEvaluations,
+        [this](size_t index) { return std::make_unique<TrackDesign>(*_designs[index % MaxDesigns]); }, options,
+        [&concurrent](size_t index, TrackDesignEvaluation&& result) {
+            ASSERT_LT(index, concurrent.size());
+            EXPECT_FALSE(concurrent[index].has_value());
+            concurrent[index] = std::move(result);
+        });
+
+    for (size_t i = 0; i < NumEvaluations; i++)
+    {
+        ASSERT_TRUE(concurrent[i].has_value());
+        ASSERT_TRUE(concurrent[i]->Tested) << concurrent[i]->Error;
+        ExpectSameResults(serial[i], *concurrent[i]);
+    }
+
+    // Nothing of the rides is left behind
+    EXPECT_EQ(ride_get_count(), 0);
+    EXPECT_EQ(CountTrackElements(), 0u);
+    gCheatsDisableAllBreakdowns = false;
+}
+
+TEST_F(TrackDesignEvaluatorTests, EvaluateConcurrently_ReportsEveryDesign)
+{
+    TrackDesignEvaluationOptions options;
+    options.ConcurrentTests = 2;
+
+    // A design that can not be loaded is reported without holding up the others
+    std::vector<size_t> reported;
+    TrackDesignEvaluator::EvaluateConcurrently(
+        GetGameState(), MaxDesigns + 1,
+        [this](size_t index) -> std::unique_ptr<TrackDesign> {
+            if (index == 1)
+                return nullptr;
+            return std::make_unique<TrackDesign>(*_designs[index % MaxDesigns]);
+        },
+        options,
+        [&reported](size_t index, TrackDesignEvaluation&& result) {
+            EXPECT_EQ(result.Tested, index != 1) << result.Error;
+            reported.push_back(index);
+        });
+
+    std::sort(reported.begin(), reported.end());
+    EXPECT_EQ(reported, std::vector<size_t>({ 0, 1, 2, 3 }));
+}
+
+TEST_F(TrackDesignEvaluatorTests, Footprint_NeverRejectsValidLocation)
+{
+    // A busy park, on the empty map of the other tests every location is clear
+    load_from_sv6(TestData::GetParkPath("bpb.sv6").c_str());
+    gCheatsSandboxMode = true;
+    gParkFlags |= PARK_FLAGS_NO_MONEY;
+
+    constexpr int32_t Step = 8 * COORDS_XY_STEP;
+    const auto mapSize = GetMapSizeMaxXY();
+    size_t numValid = 0;
+    size_t numRejected = 0;
+    for (const auto& td : _designs)
+    {
+        const TrackDesignFootprint footprint(*td);
+        for (int32_t y = Step; y < mapSize.y; y += Step)
+        {
+            for (int32_t x = Step; x < mapSize.x; x += Step)
+            {
+                auto surfaceElement = map_get_surface_element_at(CoordsXY{ x, y });
+                if (surfaceElement == nullptr)
+                    continue;
+
+                auto baseZ = surfaceElement->GetBaseZ();
+                baseZ += TrackDesignGetZPlacement(td.get(), GetOrAllocateRide(PreviewRideId), { x, y, baseZ });
+                for (Direction direction = 0; direction < NumOrthogonalDirections; direction++)
+                {
+                    for (int32_t z = baseZ; z < baseZ + 3 * LAND_HEIGHT_STEP; z += LAND_HEIGHT_STEP)
+                    {
+                        const CoordsXYZD loc{ x, y, z, direction };
+                        const bool isClear = footprint.IsClear(loc);
+
+                        auto tdAction = TrackDesignAction(loc, *td);
+                        if (GameActions::Query(&tdAction).Error == GameActions::Status::Ok)
+                        {
+                            numValid++;
+                            EXPECT_TRUE(isClear) << "Rejected valid location " << x << ", " << y << ", " << z
+                                                 << " facing " << static_cast<int32_t>(direction);
+                        }
+                        else if (!isClear)
+                        {
+                            numRejected++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Neither check may pass or fail everything for the test to mean anything
+    EXPECT_GT(numValid, 0u);
+    EXPECT_GT(numRejected, 0u);
+}
@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <openrct2/cmdline/WorkerFarm.h>
+
+#ifdef OPENRCT2_WORKER_FARM
+
+#    include <cstdio>
+#    include <gtest/gtest.h>
+#    include <map>
+#    include <string>
+#    include <unistd.h>
+#    include <vector>
+
+class WorkerFarmTests : public testing::Test
+{
+protected:
+    std::map<size_t, std::string> _results;
+    std::map<size_t, std::string> _failures;
+
+    bool Run(const std::vector<std::string>& items, int32_t numWorkers, const WorkerFarm::WorkFunc& work)
+    {
+        return WorkerFarm::Run(
+            items, numWorkers, work,
+            [this](size_t index, const std::string& result) { EXPECT_TRUE(_results.emplace(index, result).second); },
+            [this](size_t index, const std::string& reason) { EXPECT_TRUE(_failures.emplace(index, reason).second); });
+    }
+
+    static std::vector<std::string> GetItems(size_t count)
+    {
+        std::vector<std::string> items;
+        for (size_t i = 0; i < count; i++)
+        {
+            items.push_back("item" + std::to_string(i));
+        }
+        return items;
+    }
+
+    static std::string Work(const std::string& item)
+    {
+        return "done " + item;
+    }
+};
+
+TEST_F(WorkerFarmTests, Run_CompletesEveryItem)
+{
+    auto items = GetItems(50);
+    ASSERT_TRUE(Run(items, 4, Work));
+
+    EXPECT_TRUE(_failures.empty());
+    ASSERT_EQ(_results.size(), items.size());
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        EXPECT_EQ(_results[i], Work(items[i]));
+    }
+}
+
+TEST_F(WorkerFarmTests, Run_RequeuesItemOfDeadWorker)
+{
+    // The first worker to get the item dies, the marker makes the second one survive it
+    auto marker = "/tmp/openrct2-worker-farm-test-" + std::to_string(getpid());
+    std::remove(marker.c_str());
+
+    auto items = GetItems(20);
+    items[3] = "crash once";
+    ASSERT_TRUE(Run(items, 3, [&marker](const std::string& item) {
+        if (item == "crash once")
+        {
+            auto file = fopen(marker.c_str(), "wx");
+            if (file != nullptr)
+            {
+                fclose(file);
+                _exit(1);
+            }
+        }
+        return Work(item);
+    }));
+    std::remove(marker.c_str());
+
+    EXPECT_TRUE(_failures.empty());
+    ASSERT_EQ(_results.size(), items.size());
+    EXPECT_EQ(_results[3], Work(items[3]));
+}
+
+TEST_F(WorkerFarmTests, Run_GivesUpOnItemThatKillsEveryWorker)
+{
+    auto items = GetItems(20);
+    items[5] = "crash";
+    ASSERT_TRUE(Run(items, WorkerFarm::MaxAttempts + 1, [](const std::string& item) {
+        if (item == "crash")
+        {
+            _exit(1);
+        }
+        return Work(item);
+    }));
+
+    // The surviving worker completes everything else
+    ASSERT_EQ(_failures.size(), 1u);
+    EXPECT_EQ(_failures.count(5), 1u);
+    EXPECT_EQ(_results.size(), items.size() - 1);
+    EXPECT_EQ(_results.count(5), 0u);
+}
+
+TEST_F(WorkerFarmTests, Run_FailsRemainingItemsWhenAllWorkersDie)
+{
+    auto items = GetItems(10);
+    ASSERT_TRUE(Run(items, 2, [](const std::string& item) -> std::string { _exit(1); }));
+
+    EXPECT_TRUE(_results.empty());
+    EXPECT_EQ(_failures.size(), items.size());
+}
+
+#endif